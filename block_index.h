@@ -0,0 +1,80 @@
+#ifndef BLOCK_INDEX_H
+#define BLOCK_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include "chunk.h"
+
+// 分段方块类型索引
+//
+// 每个分段记录出现过哪些方块类型（每种类型一位），以及所有矿物方块在分段内的位置和类型。
+// X-ray模式只需要按矿物列表绘制，不用遍历分段里的每个方块；没有矿物的分段整段跳过。
+// /locate按区块列由近到远搜索，类型位没有置位的分段不用打开。
+// 索引和网格一样按分段修订号惰性重建：方块被修改后修订号改变，下次查询时重新扫描这个分段。
+
+enum {
+    BLOCK_INDEX_WORDS = (BLOCK_COUNT + 63) / 64,
+    LOCATE_DEFAULT_RADIUS_CHUNKS = 16, // /locate默认搜索的区块圈数
+    LOCATE_MAX_RADIUS_CHUNKS = 64
+};
+
+// 建索引的矿物（与X-ray模式高亮的类型一致）
+inline bool isIndexedOre(BlockType type) {
+    switch (type) {
+        case BLOCK_COAL_ORE:
+        case BLOCK_IRON_ORE:
+        case BLOCK_GOLD_ORE:
+        case BLOCK_DIAMOND_ORE:
+        case BLOCK_REDSTONE_ORE:
+        case BLOCK_EMERALD_ORE:
+        case BLOCK_LAVA:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 分段内的一个矿物方块
+struct OreCell {
+    uint16_t cell;  // 分段内下标（ChunkSection::localIndex）
+    uint8_t type;   // 方块类型
+};
+
+struct SectionBlockIndex {
+    uint64_t revision = 0;                    // 建索引时分段的修订号
+    uint64_t presence[BLOCK_INDEX_WORDS] = {}; // 分段内出现过的方块类型
+    std::vector<OreCell> ores;                 // 矿物方块（按分段内下标升序）
+
+    bool contains(BlockType type) const {
+        return (presence[type >> 6] >> (type & 63)) & 1;
+    }
+
+    bool hasOres() const {
+        return !ores.empty();
+    }
+};
+
+// 分段内下标转回局部坐标
+inline void sectionCellCoords(int cell, int& lx, int& ly, int& lz) {
+    lx = cell & CHUNK_MASK;
+    ly = (cell >> CHUNK_SHIFT) & CHUNK_MASK;
+    lz = cell >> (CHUNK_SHIFT * 2);
+}
+
+// 扫描分段内容重建索引
+inline void buildSectionBlockIndex(const ChunkSection& section, uint64_t revision, SectionBlockIndex& index) {
+    for (int i = 0; i < BLOCK_INDEX_WORDS; i++) {
+        index.presence[i] = 0;
+    }
+    index.ores.clear();
+    for (int cell = 0; cell < CHUNK_VOLUME; cell++) {
+        BlockType type = section.blocks[cell].type;
+        index.presence[type >> 6] |= 1ULL << (type & 63);
+        if (isIndexedOre(type)) {
+            index.ores.push_back({ static_cast<uint16_t>(cell), static_cast<uint8_t>(type) });
+        }
+    }
+    index.revision = revision;
+}
+
+#endif // BLOCK_INDEX_H
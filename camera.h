@@ -104,9 +104,9 @@ public:
         fov = radians;
     }
     
-    // 获取视图投影矩阵
+    // 获取视图投影矩阵（DirectX行向量约定：先视图变换再投影，clip = v * View * Projection）
     Mat4 getViewProjectionMatrix() const {
-        return getProjectionMatrix() * getViewMatrix();
+        return getViewMatrix() * getProjectionMatrix();
     }
     
     // 移动相机
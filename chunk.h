@@ -0,0 +1,116 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "math3d.h"
+#include "renderer.h"  // Block / BlockType 定义
+
+// 区块尺寸（每个区块分段包含16x16x16个方块）
+const int CHUNK_SHIFT = 4;
+const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+const int CHUNK_MASK = CHUNK_SIZE - 1;
+const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+// 区块分段 - 16x16x16方块的连续存储
+// 分段通过shared_ptr在世界和快照之间共享，写入前若被共享则先复制（写时复制）
+struct ChunkSection {
+    Block blocks[CHUNK_VOLUME];
+
+    // 分段内局部索引（与世界数组保持相同的z-y-x顺序）
+    static int localIndex(int lx, int ly, int lz) {
+        return (lz << (CHUNK_SHIFT * 2)) | (ly << CHUNK_SHIFT) | lx;
+    }
+};
+
+// 检查方块类型是否为透明或半透明（不依赖世界状态，可在后台线程中使用）
+inline bool isTransparentBlockType(BlockType type) {
+    // 首先检查基础透明方块类型
+    bool baseTransparent = type == BLOCK_AIR || 
+           type == BLOCK_WATER || 
+           type == BLOCK_LEAVES || 
+           type == BLOCK_ICE ||
+           type == BLOCK_LAVA ||
+           type == BLOCK_SLIME;
+           
+    // 如果是基本透明类型，直接返回true
+    if (baseTransparent) {
+        return true;
+    }
+    
+    // 对于CHANGE_BLOCK，由于这里不能直接访问方块实例，我们返回true
+    // 实际透明度将在渲染时根据具体方块实例进行处理
+    if (type == BLOCK_CHANGE_BLOCK) {
+        return true;
+    }
+    
+    return false;
+}
+
+typedef std::shared_ptr<ChunkSection> ChunkSectionPtr;
+typedef std::shared_ptr<const ChunkSection> ConstChunkSectionPtr;
+// 压缩后的冷分段（不可变，可在世界和快照之间直接共享）
+typedef std::shared_ptr<const std::vector<uint8_t>> CompressedSectionPtr;
+
+// 区块列的64位键：高32位为区块X，低32位为区块Z（支持负坐标）
+inline uint64_t chunkColumnKey(int chunkX, int chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+}
+
+// 区块列 - 同一(chunkX, chunkZ)上从下到上的全部分段
+// 常驻分段存放在sections中；被压缩进冷池的分段sections项为空，数据在coldSections中
+struct ChunkColumn {
+    int chunkX = 0;
+    int chunkZ = 0;
+    std::vector<ChunkSectionPtr> sections;
+    std::vector<CompressedSectionPtr> coldSections;
+    std::vector<int> wakeUpdate;   // 分段最近一次被解压时的驻留更新序号
+    std::vector<uint64_t> revisions; // 分段修订号：内容变化时更新，网格据此判断是否需要重新生成
+    bool modified = false;         // 生成后是否被编辑过（卸载时需要保留）
+    
+    // 分配指定数量的空气分段
+    void allocate(int x, int z, int sectionCount) {
+        chunkX = x;
+        chunkZ = z;
+        sections.resize(sectionCount);
+        for (auto& section : sections) {
+            section = std::make_shared<ChunkSection>();
+        }
+        coldSections.assign(sectionCount, CompressedSectionPtr());
+        wakeUpdate.assign(sectionCount, 0);
+        revisions.assign(sectionCount, 0);
+        modified = false;
+    }
+    
+    // 列内方块（调用方保证分段常驻，局部坐标在范围内）
+    Block& localBlock(int lx, int y, int lz) {
+        return sections[y >> CHUNK_SHIFT]->blocks[ChunkSection::localIndex(lx, y & CHUNK_MASK, lz)];
+    }
+};
+
+// 区块列快照
+struct ColumnSnapshot {
+    int chunkX = 0;
+    int chunkZ = 0;
+    std::vector<ConstChunkSectionPtr> sections;
+    // 与sections一一对应：分段处于冷池中时sections为空，数据在这里
+    std::vector<CompressedSectionPtr> coldSections;
+};
+
+// 世界快照 - 某一时刻所有分段的只读引用
+// 创建快照只复制分段指针（O(区块数)），之后主线程的写入会触发写时复制，快照内容保持不变
+struct WorldSnapshot {
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+    int chunksY = 0;
+    unsigned int seed = 0;
+    bool superFlat = false;
+    bool infinite = false;
+    BlockType superFlatBlockType = BLOCK_GRASS;
+    Vec3 spawnPoint;
+    std::vector<ColumnSnapshot> columns;
+};
+
+#endif // CHUNK_H
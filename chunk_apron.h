@@ -0,0 +1,82 @@
+#ifndef CHUNK_APRON_H
+#define CHUNK_APRON_H
+
+#include <cstdint>
+#include "chunk.h"
+#include "face_mask.h"
+
+// 带1格边框的分段副本（18^3）
+//
+// 网格生成、可见性、光照、环境光遮蔽这类内核需要频繁读取相邻方块。
+// 通过World::getBlockConst读取时每次都要做边界检查、查找区块列和分段；
+// 先把分段连同周围一圈方块复制到连续的数组里，内核就可以用固定步长无分支地访问相邻方块。
+// 存储顺序与ChunkSection一致（z为最高维，x为最低维）。
+
+const int APRON_SIZE = CHUNK_SIZE + 2;
+const int APRON_VOLUME = APRON_SIZE * APRON_SIZE * APRON_SIZE;
+const int APRON_STRIDE_X = 1;
+const int APRON_STRIDE_Y = APRON_SIZE;
+const int APRON_STRIDE_Z = APRON_SIZE * APRON_SIZE;
+
+struct ChunkApron {
+    uint8_t types[APRON_VOLUME]; // 方块类型，边框外（世界范围外/未加载）为空气
+
+    // 分段局部坐标（-1..16）对应的数组下标
+    static int index(int lx, int ly, int lz) {
+        return (lz + 1) * APRON_STRIDE_Z + (ly + 1) * APRON_STRIDE_Y + (lx + 1);
+    }
+
+    BlockType typeAt(int lx, int ly, int lz) const {
+        return static_cast<BlockType>(types[index(lx, ly, lz)]);
+    }
+};
+
+// 方块类型的透明查找表（uint8_t，便于在内核中直接参与位运算）
+inline const uint8_t* transparentTypeTable() {
+    struct Table {
+        uint8_t values[256];
+        Table() {
+            for (int i = 0; i < 256; i++) {
+                values[i] = i < BLOCK_COUNT ? (isTransparentBlockType(static_cast<BlockType>(i)) ? 1 : 0) : 1;
+            }
+        }
+    };
+    static const Table table;
+    return table.values;
+}
+
+// 基于副本的面掩码内核：每个方块固定读取6个相邻位置，内层循环没有边界判断
+inline void computeApronFaceMasks(const ChunkApron& apron, uint8_t masks[CHUNK_VOLUME]) {
+    const uint8_t* transparent = transparentTypeTable();
+    const uint8_t* types = apron.types;
+
+    for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+        for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+            const uint8_t* row = types + ChunkApron::index(0, ly, lz);
+            uint8_t* out = masks + ChunkSection::localIndex(0, ly, lz);
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                const uint8_t* cell = row + lx;
+                uint8_t solid = cell[0] != BLOCK_AIR ? 0xFF : 0x00;
+                uint8_t mask = static_cast<uint8_t>(
+                    (transparent[cell[APRON_STRIDE_Z]] << FACE_FRONT) |
+                    (transparent[cell[-APRON_STRIDE_Z]] << FACE_BACK) |
+                    (transparent[cell[-APRON_STRIDE_X]] << FACE_LEFT) |
+                    (transparent[cell[APRON_STRIDE_X]] << FACE_RIGHT) |
+                    (transparent[cell[APRON_STRIDE_Y]] << FACE_TOP) |
+                    (transparent[cell[-APRON_STRIDE_Y]] << FACE_BOTTOM));
+                out[lx] = mask & solid;
+            }
+        }
+    }
+}
+
+// 副本内容的校验和（基准测试中用于确认两种路径结果一致）
+inline uint64_t faceMaskChecksum(const uint8_t masks[CHUNK_VOLUME], uint64_t hash) {
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        hash ^= masks[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+#endif // CHUNK_APRON_H
@@ -0,0 +1,54 @@
+#ifndef CHUNK_DRAW_ORDER_H
+#define CHUNK_DRAW_ORDER_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// 按视线距离排序的绘制顺序
+//
+// 每帧把通过剔除的区块按到相机的距离排序一次：不透明的一遍由近到远提交，
+// 近处先写入深度，远处被挡住的像素在深度测试时就被拒绝；半透明的一遍由远到近提交，
+// 水、树叶、冰的混合顺序才正确。距离量化成16位整数（1/16格精度）后用两趟8位基数排序，
+// 排序是稳定的，距离相同的区块保持收集时的顺序，画面不会逐帧闪烁。
+
+// 量化后的距离：1/16格，超出范围的饱和到最大值
+inline uint16_t quantizeDrawDistance(float distSq) {
+    float scaled = std::sqrt(std::max(0.0f, distSq)) * 16.0f;
+    return scaled >= 65535.0f ? static_cast<uint16_t>(65535) : static_cast<uint16_t>(scaled);
+}
+
+// 按T::key（16位）升序的稳定基数排序，scratch为复用的临时缓冲
+template <typename T>
+inline void radixSortByKey(std::vector<T>& items, std::vector<T>& scratch) {
+    if (items.size() < 2) return;
+    scratch.resize(items.size());
+    for (int shift = 0; shift < 16; shift += 8) {
+        size_t offsets[256] = {};
+        for (const T& item : items) {
+            offsets[(item.key >> shift) & 0xFF]++;
+        }
+        size_t sum = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            size_t count = offsets[bucket];
+            offsets[bucket] = sum;
+            sum += count;
+        }
+        for (const T& item : items) {
+            scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+// 本帧要绘制的区块
+struct ChunkDrawItem {
+    int chunkX = 0;
+    int chunkY = 0;
+    int chunkZ = 0;
+    float distSq = 0.0f; // 区块中心到相机的距离（平方）
+    uint16_t key = 0;    // 量化后的距离
+};
+
+#endif // CHUNK_DRAW_ORDER_H
@@ -0,0 +1,121 @@
+#ifndef CHUNK_INTERN_H
+#define CHUNK_INTERN_H
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include "chunk.h"
+
+// 区块分段去重
+//
+// 地下的整块石头、超平坦世界的"一层方块+空气"等分段内容完全相同。
+// 按内容哈希把相同的分段指向同一块内存；分段本来就是写时复制的，第一次编辑时会自动复制出独立的一份。
+// 表中只保存weak_ptr，不会增加引用计数，因此没有重复内容的分段仍然可以原地写入。
+
+// 分段内容哈希（FNV-1a，只哈希有意义的字段，避免结构体填充字节的影响）
+inline uint64_t sectionContentHash(const ChunkSection& section) {
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        const Block& block = section.blocks[i];
+        mix(static_cast<uint32_t>(block.type) | (block.isVisible ? 0x100u : 0u) | (block.hasCustomColors ? 0x200u : 0u) |
+            (static_cast<uint32_t>(block.faceMask) << 16));
+        if (block.hasCustomColors) {
+            for (int face = 0; face < FACE_COUNT; face++) {
+                mix(block.customColors[face].toUint32());
+            }
+        }
+    }
+    return hash;
+}
+
+// 分段内容是否完全相同
+inline bool sectionContentEquals(const ChunkSection& a, const ChunkSection& b) {
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        const Block& blockA = a.blocks[i];
+        const Block& blockB = b.blocks[i];
+        if (blockA.type != blockB.type || blockA.isVisible != blockB.isVisible ||
+            blockA.faceMask != blockB.faceMask || blockA.hasCustomColors != blockB.hasCustomColors) {
+            return false;
+        }
+        for (int face = 0; face < FACE_COUNT; face++) {
+            if (blockA.customColors[face].toUint32() != blockB.customColors[face].toUint32()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 分段去重表
+class SectionInterner {
+private:
+    std::unordered_map<uint64_t, std::vector<std::weak_ptr<ChunkSection>>> table;
+    uint64_t internRequests = 0; // 请求去重的次数
+    uint64_t internShared = 0;   // 找到相同分段并共享的次数
+
+public:
+    // 返回内容相同的已有分段；没有时登记并返回传入的分段
+    ChunkSectionPtr intern(const ChunkSectionPtr& section) {
+        internRequests++;
+        std::vector<std::weak_ptr<ChunkSection>>& bucket = table[sectionContentHash(*section)];
+
+        for (size_t i = 0; i < bucket.size();) {
+            ChunkSectionPtr existing = bucket[i].lock();
+            if (!existing) {
+                // 顺带清理已释放的条目
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                continue;
+            }
+            if (existing == section) {
+                return section;
+            }
+            // 已登记的分段若在独占时被原地修改，内容比较会失败，不会错误共享
+            if (sectionContentEquals(*existing, *section)) {
+                internShared++;
+                return existing;
+            }
+            i++;
+        }
+
+        bucket.push_back(section);
+        return section;
+    }
+
+    // 清理已释放的条目
+    void purgeExpired() {
+        for (auto it = table.begin(); it != table.end();) {
+            auto& bucket = it->second;
+            for (size_t i = 0; i < bucket.size();) {
+                if (bucket[i].expired()) {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                } else {
+                    i++;
+                }
+            }
+            if (bucket.empty()) {
+                it = table.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void clear() {
+        table.clear();
+        internRequests = 0;
+        internShared = 0;
+    }
+
+    uint64_t getInternRequests() const { return internRequests; }
+    uint64_t getInternShared() const { return internShared; }
+};
+
+#endif // CHUNK_INTERN_H
@@ -0,0 +1,141 @@
+#ifndef CHUNK_LOD_H
+#define CHUNK_LOD_H
+
+#include <cstdint>
+#include "chunk.h"
+#include "face_mask.h"
+#include "section_visibility.h"
+#include "chunk_mesh.h"
+
+// 远处分段的低细节网格
+//
+// 第lod级把分段按(2^lod)^3的小格降采样：格内非空气方块不少于一半时整格为实心，
+// 类型取格内最多的非空气类型（多数表决），每个暴露的格面输出一个边长2^lod的四边形。
+// 分段内部的格面按相邻格判断是否暴露；分段边界上的格面沿用格内边界层方块的面掩码
+// （面掩码是按整个世界算的）：边界层里只要有暴露的方块面就输出这个格面，
+// 多数表决为空的格也一样（类型取边界层暴露方块中最多的类型）。相邻分段按面掩码认为这些方块是实心的，
+// 不会朝它们输出面，所以这一侧必须补上，相邻分段即使用的是另一级网格，交界处也不会露出缝隙。
+// 连通性和遮挡盒仍按原分段计算，可见性剔除和遮挡剔除不受细节级别影响。
+// 级别的选择（按距离、带回差）见chunk_mesh.h中的selectMeshLod。
+
+// 生成第lod级网格（lod为0时生成完整网格）
+inline void buildSectionLodMesh(const ChunkSection& section, int originX, int originY, int originZ, int lod, ChunkMesh& mesh) {
+    if (lod <= 0) {
+        buildSectionMesh(section, originX, originY, originZ, mesh);
+        return;
+    }
+    mesh.clear();
+    mesh.lod = lod;
+    const int scale = 1 << lod;
+    const int cells = CHUNK_SIZE >> lod;
+    const int cellVolume = scale * scale * scale;
+    const MeshTypeTable& table = meshTypeTable();
+
+    // 多数表决：每格的类型（空气表示空格）
+    uint8_t cellTypes[CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE / 8];
+    auto cellIndex = [cells](int cx, int cy, int cz) { return (cz * cells + cy) * cells + cx; };
+    int counts[BLOCK_COUNT];
+    for (int cz = 0; cz < cells; cz++) {
+        for (int cy = 0; cy < cells; cy++) {
+            for (int cx = 0; cx < cells; cx++) {
+                for (int type = 0; type < BLOCK_COUNT; type++) counts[type] = 0;
+                for (int z = 0; z < scale; z++) {
+                    for (int y = 0; y < scale; y++) {
+                        const Block* row = &section.blocks[ChunkSection::localIndex(cx * scale, cy * scale + y, cz * scale + z)];
+                        for (int x = 0; x < scale; x++) {
+                            counts[row[x].type]++;
+                        }
+                    }
+                }
+                int best = BLOCK_AIR;
+                if ((cellVolume - counts[BLOCK_AIR]) * 2 >= cellVolume) {
+                    int bestCount = 0;
+                    for (int type = 0; type < BLOCK_COUNT; type++) {
+                        if (type == BLOCK_AIR || counts[type] <= bestCount) continue;
+                        best = type;
+                        bestCount = counts[type];
+                    }
+                }
+                cellTypes[cellIndex(cx, cy, cz)] = static_cast<uint8_t>(best);
+            }
+        }
+    }
+
+    // 格在face方向的边界层里暴露方块最多的类型（分段边界上的格面用，没有暴露面时为空气）
+    auto boundaryFaceType = [&](int cx, int cy, int cz, int face) {
+        const int normal = MESH_FACE_AXES[face][0];
+        const int axisU = MESH_FACE_AXES[face][1];
+        const int axisV = MESH_FACE_AXES[face][2];
+        int local[3] = { cx * scale, cy * scale, cz * scale };
+        if (FACE_DIRECTIONS[face][normal] > 0) local[normal] += scale - 1;
+        int u0 = local[axisU];
+        int v0 = local[axisV];
+        int layerCounts[BLOCK_COUNT] = {};
+        int best = BLOCK_AIR;
+        int bestCount = 0;
+        for (int v = 0; v < scale; v++) {
+            for (int u = 0; u < scale; u++) {
+                local[axisU] = u0 + u;
+                local[axisV] = v0 + v;
+                const Block& block = section.blocks[ChunkSection::localIndex(local[0], local[1], local[2])];
+                if (block.type == BLOCK_AIR || !(block.faceMask & (1 << face))) continue;
+                if (++layerCounts[block.type] > bestCount) {
+                    best = block.type;
+                    bestCount = layerCounts[block.type];
+                }
+            }
+        }
+        return static_cast<BlockType>(best);
+    };
+
+    // 按面方向依次输出，不透明四边形按朝向分段（与完整网格一致）
+    const float size[3] = { static_cast<float>(scale), static_cast<float>(scale), static_cast<float>(scale) };
+    for (int face = 0; face < FACE_COUNT; face++) {
+        mesh.opaqueFaceStart[face] = mesh.quadCount(MESH_PASS_OPAQUE);
+        for (int cz = 0; cz < cells; cz++) {
+            for (int cy = 0; cy < cells; cy++) {
+                for (int cx = 0; cx < cells; cx++) {
+                    BlockType type = static_cast<BlockType>(cellTypes[cellIndex(cx, cy, cz)]);
+                    int nx = cx + FACE_DIRECTIONS[face][0];
+                    int ny = cy + FACE_DIRECTIONS[face][1];
+                    int nz = cz + FACE_DIRECTIONS[face][2];
+                    bool border = nx < 0 || ny < 0 || nz < 0 || nx >= cells || ny >= cells || nz >= cells;
+                    if (type == BLOCK_AIR && !border) continue;
+
+                    bool exposed;
+                    if (border) {
+                        // 多数表决为空的格，边界层里有暴露方块时也要输出，类型取边界层的
+                        BlockType layerType = boundaryFaceType(cx, cy, cz, face);
+                        exposed = layerType != BLOCK_AIR;
+                        if (type == BLOCK_AIR) type = layerType;
+                    } else {
+                        // 与面掩码相同的规则：相邻为空，或相邻透明且类型不同
+                        BlockType neighbor = static_cast<BlockType>(cellTypes[cellIndex(nx, ny, nz)]);
+                        exposed = neighbor == BLOCK_AIR || (isTransparentLookup(neighbor) && neighbor != type);
+                    }
+                    if (!exposed) continue;
+
+                    const float base[3] = {
+                        static_cast<float>(originX + cx * scale),
+                        static_cast<float>(originY + cy * scale),
+                        static_cast<float>(originZ + cz * scale)
+                    };
+                    float quadSize[3] = { size[0], size[1], size[2] };
+                    quadSize[MESH_FACE_AXES[face][0]] = 1.0f;
+                    // 法线轴为正方向的面在格的另一侧
+                    float quadBase[3] = { base[0], base[1], base[2] };
+                    if (FACE_DIRECTIONS[face][MESH_FACE_AXES[face][0]] > 0) {
+                        quadBase[MESH_FACE_AXES[face][0]] += static_cast<float>(scale - 1);
+                    }
+                    appendMeshQuad(mesh.vertices[table.passes[type]], face, quadBase, quadSize, table.colors[type][face]);
+                    mesh.faceCount += scale * scale;
+                }
+            }
+        }
+    }
+    mesh.opaqueFaceStart[FACE_COUNT] = mesh.quadCount(MESH_PASS_OPAQUE);
+    mesh.visibility = computeSectionVisibility(section);
+    mesh.occluder = computeSectionOccluder(section);
+}
+
+#endif // CHUNK_LOD_H
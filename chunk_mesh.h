@@ -0,0 +1,613 @@
+#ifndef CHUNK_MESH_H
+#define CHUNK_MESH_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include "chunk.h"
+#include "face_mask.h"
+#include "section_visibility.h"
+#include "chunk_draw_order.h"
+#include "render_backend.h"
+
+// 区块网格
+//
+// 每个16^3分段的暴露面预先展开成顶点数组（按不透明/半透明分成两遍），
+// 渲染时每个分段每遍只需一次绘制调用，不再每帧逐方块、逐面地提交。
+// 网格只取决于分段自身的方块类型、颜色和面掩码：分段内容（包括被相邻编辑改写的边界面掩码）
+// 变化时分段修订号递增，网格在下次使用时才重新生成。
+// 生成过程不访问图形设备，可以离线统计四边形数量和顶点校验和。
+// 不透明的一遍按面朝向分成六段连续的四边形：相机在分段包围盒某一侧之外时，
+// 背向相机的整段（例如相机在分段上方时的所有底面）直接跳过，不提交给图形设备。
+
+enum MeshPass {
+    MESH_PASS_OPAQUE = 0,      // 不透明方块
+    MESH_PASS_TRANSPARENT = 1, // 半透明方块（水、树叶、半透明的可变方块等）
+    MESH_PASS_COUNT = 2
+};
+
+// 每个四边形4个顶点、6个索引；所有网格共用同一份索引模式
+const int MESH_VERTICES_PER_QUAD = 4;
+const int MESH_INDICES_PER_QUAD = 6;
+// 16位索引一次最多寻址16384个四边形，超过时分批绘制
+const int MESH_MAX_QUADS_PER_BATCH = 65536 / MESH_VERTICES_PER_QUAD;
+
+// 单位方块各面的四个角（与GPURenderer::DrawBlockFace的顶点顺序一致）
+const uint8_t MESH_FACE_CORNERS[FACE_COUNT][4][3] = {
+    { {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1} }, // FACE_FRONT (Z+)
+    { {1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0} }, // FACE_BACK (Z-)
+    { {0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0} }, // FACE_LEFT (X-)
+    { {1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1} }, // FACE_RIGHT (X+)
+    { {0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0} }, // FACE_TOP (Y+)
+    { {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1} }  // FACE_BOTTOM (Y-)
+};
+
+// 各面的坐标轴（0=x，1=y，2=z）：法线轴，以及面内的两个轴（贪心合并时的宽、高方向）
+const int MESH_FACE_AXES[FACE_COUNT][3] = {
+    { 2, 0, 1 }, // FACE_FRONT：切片沿z，面内x、y
+    { 2, 0, 1 }, // FACE_BACK
+    { 0, 2, 1 }, // FACE_LEFT：切片沿x，面内z、y
+    { 0, 2, 1 }, // FACE_RIGHT
+    { 1, 0, 2 }, // FACE_TOP：切片沿y，面内x、z
+    { 1, 0, 2 }  // FACE_BOTTOM
+};
+
+// 面朝向的亮度（顶面最亮，底面最暗）
+const float MESH_FACE_SHADE[FACE_COUNT] = { 0.8f, 0.8f, 0.7f, 0.7f, 1.0f, 0.6f };
+
+// 按面朝向调整亮度后的顶点颜色
+inline uint32_t shadeFaceColor(const Color& color, int face) {
+    float shade = MESH_FACE_SHADE[face];
+    return packVertexColor(
+        static_cast<uint8_t>(color.r * shade),
+        static_cast<uint8_t>(color.g * shade),
+        static_cast<uint8_t>(color.b * shade),
+        color.a
+    );
+}
+
+// 普通方块的顶点颜色和所属的遍只取决于类型，预先计算好
+struct MeshTypeTable {
+    uint32_t colors[BLOCK_COUNT][FACE_COUNT];
+    uint8_t passes[BLOCK_COUNT];
+
+    MeshTypeTable() {
+        for (int i = 0; i < BLOCK_COUNT; i++) {
+            Block block(static_cast<BlockType>(i));
+            for (int f = 0; f < FACE_COUNT; f++) {
+                colors[i][f] = shadeFaceColor(block.getFaceColor(static_cast<Face>(f)), f);
+            }
+            passes[i] = isTransparentBlockType(static_cast<BlockType>(i)) ? MESH_PASS_TRANSPARENT : MESH_PASS_OPAQUE;
+        }
+    }
+};
+
+inline const MeshTypeTable& meshTypeTable() {
+    static const MeshTypeTable table;
+    return table;
+}
+
+inline uint32_t meshFaceColor(BlockType type, int face) {
+    return meshTypeTable().colors[type][face];
+}
+
+// 方块属于哪一遍：透明类型，或有任一面半透明的可变方块
+inline int meshPassOf(const Block& block) {
+    if (meshTypeTable().passes[block.type] == MESH_PASS_TRANSPARENT) {
+        return MESH_PASS_TRANSPARENT;
+    }
+    if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
+        for (int i = 0; i < FACE_COUNT; i++) {
+            if (block.customColors[i].a < 255) {
+                return MESH_PASS_TRANSPARENT;
+            }
+        }
+    }
+    return MESH_PASS_OPAQUE;
+}
+
+// 半透明四边形还没有按相机位置排过序
+const uint64_t MESH_UNSORTED = ~0ull;
+
+// 一个分段的网格
+struct ChunkMesh {
+    std::vector<VertexPositionColor> vertices[MESH_PASS_COUNT];
+    int faceCount = 0;      // 四边形覆盖的方块面数（不合并时等于四边形数）
+    int lod = 0;            // 细节级别（0为完整网格，见chunk_lod.h）
+    uint64_t revision = 0;  // 生成网格时分段的修订号
+    int lastUsedFrame = 0;  // 最近一次被渲染的帧序号（用于淘汰）
+    SectionVisibility visibility = SectionVisibility::open(); // 分段面连通性（与网格一起生成）
+    SectionOccluder occluder;                                  // 分段内的实心遮挡盒
+    uint64_t transparentOrderKey = MESH_UNSORTED;               // 半透明四边形按哪个相机区块排过序
+    int opaqueFaceStart[FACE_COUNT + 1] = {};                  // 不透明四边形中朝向face的一段为[start[face], start[face + 1])
+
+    int quadCount(int pass) const {
+        return static_cast<int>(vertices[pass].size()) / MESH_VERTICES_PER_QUAD;
+    }
+
+    int totalQuads() const {
+        return quadCount(MESH_PASS_OPAQUE) + quadCount(MESH_PASS_TRANSPARENT);
+    }
+
+    void clear() {
+        for (int pass = 0; pass < MESH_PASS_COUNT; pass++) {
+            vertices[pass].clear();
+        }
+        faceCount = 0;
+        lod = 0;
+        for (int face = 0; face <= FACE_COUNT; face++) {
+            opaqueFaceStart[face] = 0;
+        }
+        visibility = SectionVisibility::open();
+        occluder = SectionOccluder();
+        transparentOrderKey = MESH_UNSORTED;
+    }
+};
+
+// 把半透明四边形按到视点的距离从远到近重新排列（四边形之间的混合顺序）
+inline void sortMeshTransparentQuads(ChunkMesh& mesh, float eyeX, float eyeY, float eyeZ) {
+    struct QuadOrder {
+        uint32_t index;
+        uint16_t key;
+    };
+    std::vector<VertexPositionColor>& quads = mesh.vertices[MESH_PASS_TRANSPARENT];
+    int quadCount = mesh.quadCount(MESH_PASS_TRANSPARENT);
+    if (quadCount < 2) return;
+
+    std::vector<QuadOrder> order(quadCount);
+    std::vector<QuadOrder> scratch;
+    for (int q = 0; q < quadCount; q++) {
+        // 对角两个顶点的中点就是四边形中心
+        const VertexPositionColor* v = &quads[q * MESH_VERTICES_PER_QUAD];
+        float dx = (v[0].x + v[2].x) * 0.5f - eyeX;
+        float dy = (v[0].y + v[2].y) * 0.5f - eyeY;
+        float dz = (v[0].z + v[2].z) * 0.5f - eyeZ;
+        order[q].index = static_cast<uint32_t>(q);
+        order[q].key = quantizeDrawDistance(dx * dx + dy * dy + dz * dz);
+    }
+    radixSortByKey(order, scratch);
+
+    std::vector<VertexPositionColor> sorted(quads.size());
+    for (int q = 0; q < quadCount; q++) {
+        const VertexPositionColor* src = &quads[order[quadCount - 1 - q].index * MESH_VERTICES_PER_QUAD];
+        std::copy(src, src + MESH_VERTICES_PER_QUAD, &sorted[q * MESH_VERTICES_PER_QUAD]);
+    }
+    quads.swap(sorted);
+}
+
+// 追加一个四边形：base为最小角的世界坐标，size为三个轴上的跨度（法线轴为1）
+inline void appendMeshQuad(std::vector<VertexPositionColor>& out, int face, const float base[3], const float size[3], uint32_t color) {
+    size_t first = out.size();
+    out.resize(first + MESH_VERTICES_PER_QUAD);
+    VertexPositionColor* vertex = &out[first];
+    for (int corner = 0; corner < 4; corner++) {
+        const uint8_t* offset = MESH_FACE_CORNERS[face][corner];
+        vertex[corner].x = base[0] + offset[0] * size[0];
+        vertex[corner].y = base[1] + offset[1] * size[1];
+        vertex[corner].z = base[2] + offset[2] * size[2];
+        vertex[corner].color = color;
+    }
+}
+
+// 方块某一面的顶点颜色
+inline uint32_t meshBlockFaceColor(const Block& block, int face) {
+    if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
+        return shadeFaceColor(block.getFaceColor(static_cast<Face>(face)), face);
+    }
+    return meshFaceColor(block.type, face);
+}
+
+// 包围盒内的方块面可能朝向相机的方向（面掩码）
+// 朝向+x的面所在平面在[min.x + 1, max.x]内，相机x不大于min.x + 1时这些面全部背向相机或与视线平行，其余方向同理。
+inline uint8_t meshFacingMask(const Vec3& eye, const Vec3& boxMin, const Vec3& boxMax) {
+    uint8_t mask = 0;
+    if (eye.z > boxMin.z + 1.0f) mask |= faceBit(FACE_FRONT);
+    if (eye.z < boxMax.z - 1.0f) mask |= faceBit(FACE_BACK);
+    if (eye.x < boxMax.x - 1.0f) mask |= faceBit(FACE_LEFT);
+    if (eye.x > boxMin.x + 1.0f) mask |= faceBit(FACE_RIGHT);
+    if (eye.y > boxMin.y + 1.0f) mask |= faceBit(FACE_TOP);
+    if (eye.y < boxMax.y - 1.0f) mask |= faceBit(FACE_BOTTOM);
+    return mask;
+}
+
+// 按朝向掩码遍历不透明四边形：相邻的可见朝向合并成一段，draw(首个四边形, 四边形数)
+template <typename Draw>
+inline void forEachFacingRun(const ChunkMesh& mesh, uint8_t facing, Draw draw) {
+    int face = 0;
+    while (face < FACE_COUNT) {
+        if (!(facing & (1 << face))) {
+            face++;
+            continue;
+        }
+        int first = face;
+        while (face < FACE_COUNT && (facing & (1 << face))) {
+            face++;
+        }
+        int begin = mesh.opaqueFaceStart[first];
+        int end = mesh.opaqueFaceStart[face];
+        if (end > begin) draw(begin, end - begin);
+    }
+}
+
+// 所有网格共用的四边形索引：(0,1,2)(0,2,3)，每个四边形偏移4
+inline const uint16_t* meshQuadIndices() {
+    struct Indices {
+        std::vector<uint16_t> values;
+        Indices() {
+            values.resize(static_cast<size_t>(MESH_MAX_QUADS_PER_BATCH) * MESH_INDICES_PER_QUAD);
+            for (int quad = 0; quad < MESH_MAX_QUADS_PER_BATCH; quad++) {
+                uint16_t base = static_cast<uint16_t>(quad * MESH_VERTICES_PER_QUAD);
+                uint16_t* out = &values[static_cast<size_t>(quad) * MESH_INDICES_PER_QUAD];
+                out[0] = base;
+                out[1] = static_cast<uint16_t>(base + 1);
+                out[2] = static_cast<uint16_t>(base + 2);
+                out[3] = base;
+                out[4] = static_cast<uint16_t>(base + 2);
+                out[5] = static_cast<uint16_t>(base + 3);
+            }
+        }
+    };
+    static const Indices indices;
+    return indices.values.data();
+}
+
+// 由分段内容生成网格（origin为分段最小角的世界坐标）
+// 每个面掩码置位的面输出一个四边形，颜色与逐面绘制时完全一致
+inline void buildSectionMesh(const ChunkSection& section, int originX, int originY, int originZ, ChunkMesh& mesh) {
+    mesh.clear();
+    // 不透明的面先按朝向分桶，最后依次拼接（按线程复用，拼接后清空）
+    thread_local std::vector<VertexPositionColor> opaqueByFace[FACE_COUNT];
+    for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+        for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                const Block& block = section.blocks[ChunkSection::localIndex(lx, ly, lz)];
+                if (block.faceMask == 0 || block.type == BLOCK_AIR) continue;
+
+                int pass = meshPassOf(block);
+                const float base[3] = {
+                    static_cast<float>(originX + lx),
+                    static_cast<float>(originY + ly),
+                    static_cast<float>(originZ + lz)
+                };
+                const float unit[3] = { 1.0f, 1.0f, 1.0f };
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    if (!(block.faceMask & (1 << face))) continue;
+                    std::vector<VertexPositionColor>& out = pass == MESH_PASS_OPAQUE ? opaqueByFace[face] : mesh.vertices[pass];
+                    appendMeshQuad(out, face, base, unit, meshBlockFaceColor(block, face));
+                    mesh.faceCount++;
+                }
+            }
+        }
+    }
+    std::vector<VertexPositionColor>& opaque = mesh.vertices[MESH_PASS_OPAQUE];
+    for (int face = 0; face < FACE_COUNT; face++) {
+        mesh.opaqueFaceStart[face] = static_cast<int>(opaque.size()) / MESH_VERTICES_PER_QUAD;
+        opaque.insert(opaque.end(), opaqueByFace[face].begin(), opaqueByFace[face].end());
+        opaqueByFace[face].clear();
+    }
+    mesh.opaqueFaceStart[FACE_COUNT] = mesh.quadCount(MESH_PASS_OPAQUE);
+    mesh.visibility = computeSectionVisibility(section);
+    mesh.occluder = computeSectionOccluder(section);
+}
+
+// 贪心合并生成网格：每个面方向逐层切片，把相邻、颜色相同且属于同一遍的暴露面合并成最大矩形
+// 先沿宽方向尽量延伸，再逐行向高方向延伸；合并后颜色不变，只减少四边形数量
+//
+// 第一步按存储顺序扫描一遍分段，只处理有暴露面的方块，把合并键写入各面方向的切片；
+// 第二步在切片内合并（按面方向依次进行，不透明四边形自然按朝向分段）。合并时会把用过的键清零，因此切片缓冲区在每次调用结束时都回到全零，
+// 可以按线程复用而不必每次清空。
+inline void buildSectionMeshGreedy(const ChunkSection& section, int originX, int originY, int originZ, ChunkMesh& mesh) {
+    mesh.clear();
+    const int origin[3] = { originX, originY, originZ };
+    const MeshTypeTable& table = meshTypeTable();
+
+    // 合并键：0表示没有暴露面，否则为(有效位 | 遍 | 颜色)；按[面][切片][v][u]存放
+    const int SLICE_AREA = CHUNK_SIZE * CHUNK_SIZE;
+    thread_local std::vector<uint64_t> keyBuffer(static_cast<size_t>(FACE_COUNT) * CHUNK_SIZE * SLICE_AREA, 0);
+    uint64_t* keys = keyBuffer.data();
+    uint16_t usedSlices[FACE_COUNT] = {}; // 每个面方向上有暴露面的切片
+
+    for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+        for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                const Block& block = section.blocks[ChunkSection::localIndex(lx, ly, lz)];
+                if (block.faceMask == 0 || block.type == BLOCK_AIR) continue;
+
+                bool custom = block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors;
+                uint64_t passBits = static_cast<uint64_t>(custom ? meshPassOf(block) : table.passes[block.type]) << 32;
+                const int local[3] = { lx, ly, lz };
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    if (!(block.faceMask & (1 << face))) continue;
+                    uint32_t color = custom ? meshBlockFaceColor(block, face) : table.colors[block.type][face];
+                    int slice = local[MESH_FACE_AXES[face][0]];
+                    int u = local[MESH_FACE_AXES[face][1]];
+                    int v = local[MESH_FACE_AXES[face][2]];
+                    keys[(face * CHUNK_SIZE + slice) * SLICE_AREA + v * CHUNK_SIZE + u] =
+                        (1ULL << 40) | passBits | static_cast<uint32_t>(color);
+                    usedSlices[face] |= static_cast<uint16_t>(1u << slice);
+                }
+            }
+        }
+    }
+
+    for (int face = 0; face < FACE_COUNT; face++) {
+        mesh.opaqueFaceStart[face] = mesh.quadCount(MESH_PASS_OPAQUE);
+        const int axisD = MESH_FACE_AXES[face][0];
+        const int axisU = MESH_FACE_AXES[face][1];
+        const int axisV = MESH_FACE_AXES[face][2];
+
+        for (int slice = 0; slice < CHUNK_SIZE; slice++) {
+            if (!(usedSlices[face] & (1u << slice))) continue;
+            uint64_t* sliceKeys = keys + (face * CHUNK_SIZE + slice) * SLICE_AREA;
+
+            for (int v = 0; v < CHUNK_SIZE; v++) {
+                for (int u = 0; u < CHUNK_SIZE; u++) {
+                    uint64_t key = sliceKeys[v * CHUNK_SIZE + u];
+                    if (key == 0) continue;
+
+                    int w = 1;
+                    while (u + w < CHUNK_SIZE && sliceKeys[v * CHUNK_SIZE + u + w] == key) {
+                        w++;
+                    }
+                    int h = 1;
+                    for (; v + h < CHUNK_SIZE; h++) {
+                        const uint64_t* row = sliceKeys + (v + h) * CHUNK_SIZE + u;
+                        int i = 0;
+                        while (i < w && row[i] == key) {
+                            i++;
+                        }
+                        if (i < w) break;
+                    }
+                    for (int j = 0; j < h; j++) {
+                        for (int i = 0; i < w; i++) {
+                            sliceKeys[(v + j) * CHUNK_SIZE + u + i] = 0;
+                        }
+                    }
+
+                    float base[3];
+                    float size[3];
+                    base[axisD] = static_cast<float>(origin[axisD] + slice);
+                    base[axisU] = static_cast<float>(origin[axisU] + u);
+                    base[axisV] = static_cast<float>(origin[axisV] + v);
+                    size[axisD] = 1.0f;
+                    size[axisU] = static_cast<float>(w);
+                    size[axisV] = static_cast<float>(h);
+                    appendMeshQuad(mesh.vertices[(key >> 32) & 1], face, base, size, static_cast<uint32_t>(key & 0xFFFFFFFFULL));
+                    mesh.faceCount += w * h;
+                    u += w - 1;
+                }
+            }
+        }
+    }
+    mesh.opaqueFaceStart[FACE_COUNT] = mesh.quadCount(MESH_PASS_OPAQUE);
+    mesh.visibility = computeSectionVisibility(section);
+    mesh.occluder = computeSectionOccluder(section);
+}
+
+// 网格内容的校验和（FNV-1a，覆盖两遍的顶点位置和颜色）
+inline uint64_t meshChecksum(const ChunkMesh& mesh, uint64_t hash = 1469598103934665603ULL) {
+    for (int pass = 0; pass < MESH_PASS_COUNT; pass++) {
+        hash ^= static_cast<uint64_t>(mesh.vertices[pass].size()) + pass;
+        hash *= 1099511628211ULL;
+        for (const VertexPositionColor& vertex : mesh.vertices[pass]) {
+            uint32_t words[4];
+            std::memcpy(&words[0], &vertex.x, sizeof(float));
+            std::memcpy(&words[1], &vertex.y, sizeof(float));
+            std::memcpy(&words[2], &vertex.z, sizeof(float));
+            words[3] = static_cast<uint32_t>(vertex.color);
+            for (int i = 0; i < 4; i++) {
+                hash ^= words[i];
+                hash *= 1099511628211ULL;
+            }
+        }
+    }
+    return hash;
+}
+
+// 细节级别：远处的分段使用降采样的网格（生成见chunk_lod.h）
+// 按分段中心到相机的距离选择，带回差：越过阈值MESH_LOD_HYSTERESIS格后才切换，在阈值附近走动时网格不会逐帧跳变
+enum {
+    MESH_LOD_LEVELS = 4 // 0：完整网格，1~3：2x、4x、8x降采样
+};
+
+// 各级开始使用的距离（格）
+const float MESH_LOD_DISTANCES[MESH_LOD_LEVELS] = { 0.0f, 64.0f, 112.0f, 176.0f };
+const float MESH_LOD_HYSTERESIS = 8.0f;
+
+// 按距离选择级别：previous为上次选择的级别（没有时传-1）
+inline int selectMeshLod(float distance, int previous) {
+    if (previous < 0 || previous >= MESH_LOD_LEVELS) {
+        int level = 0;
+        while (level + 1 < MESH_LOD_LEVELS && distance >= MESH_LOD_DISTANCES[level + 1]) level++;
+        return level;
+    }
+    int level = previous;
+    while (level + 1 < MESH_LOD_LEVELS && distance > MESH_LOD_DISTANCES[level + 1] + MESH_LOD_HYSTERESIS) level++;
+    while (level > 0 && distance < MESH_LOD_DISTANCES[level] - MESH_LOD_HYSTERESIS) level--;
+    return level;
+}
+
+// 网格统计（显示在F3调试界面）
+struct ChunkMeshStats {
+    int cachedMeshes = 0;   // 缓存中的网格数
+    int cachedQuads = 0;    // 缓存网格的四边形总数
+    int cachedFaces = 0;    // 缓存网格覆盖的方块面总数（与四边形数之比即合并比例）
+    int rebuilds = 0;       // 上一帧重新生成的网格数
+    int drawnMeshes = 0;    // 上一帧提交的网格绘制次数
+    int drawnQuads = 0;     // 上一帧绘制的四边形数
+    int transparentSorts = 0; // 上一帧重新排序半透明四边形的网格数
+    int backfaceCulledQuads = 0;             // 上一帧因整段背向相机而跳过的不透明四边形数
+    int drawnQuadsByFace[FACE_COUNT] = {};   // 上一帧绘制的不透明四边形按朝向的分布
+    int drawnQuadsByLod[MESH_LOD_LEVELS] = {};             // 上一帧绘制的四边形按细节级别（0为完整网格）的分布
+    uint64_t totalRebuilds = 0;
+    bool greedy = false;    // 是否启用贪心合并
+    bool threaded = false;  // 是否在后台线程生成网格
+    int pendingJobs = 0;    // 已提交、尚未取回的后台网格任务数
+};
+
+// 淘汰超过这么多帧未使用的网格
+const int MESH_CACHE_MAX_IDLE_FRAMES = 300;
+
+// 按分段坐标和细节级别缓存的网格
+class ChunkMeshCache {
+private:
+    // 分段上次选择的细节级别（回差需要记住上一次的选择）
+    struct LodSelection {
+        int level = 0;
+        int lastUsedFrame = 0;
+    };
+
+    std::unordered_map<uint64_t, ChunkMesh> meshes;
+    std::unordered_map<uint64_t, LodSelection> lodSelections;
+    int frame = 0;
+    int epoch = 0;          // 每次清空后递增，用于丢弃清空前提交的后台任务结果
+    ChunkMeshStats stats;
+    ChunkMeshStats current; // 本帧正在累计的统计
+
+public:
+    // 分段键：区块X、Z各27位，细节级别2位，分段Y 8位
+    static uint64_t key(int chunkX, int sectionY, int chunkZ, int lod = 0) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX) & 0x07FFFFFF) << 37) |
+               (static_cast<uint64_t>(lod & 0x3) << 35) |
+               (static_cast<uint64_t>(sectionY & 0xFF) << 27) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(chunkZ) & 0x07FFFFFF));
+    }
+
+    // 取得分段网格；修订号不一致时调用build(mesh)重新生成
+    template <typename Build>
+    const ChunkMesh& get(int chunkX, int sectionY, int chunkZ, int lod, uint64_t revision, Build build) {
+        auto inserted = meshes.emplace(key(chunkX, sectionY, chunkZ, lod), ChunkMesh());
+        ChunkMesh& mesh = inserted.first->second;
+        if (inserted.second || mesh.revision != revision) {
+            current.cachedQuads -= mesh.totalQuads();
+            current.cachedFaces -= mesh.faceCount;
+            build(mesh);
+            mesh.revision = revision;
+            current.cachedQuads += mesh.totalQuads();
+            current.cachedFaces += mesh.faceCount;
+            current.rebuilds++;
+            current.totalRebuilds++;
+        }
+        mesh.lastUsedFrame = frame;
+        return mesh;
+    }
+
+    // 查找已缓存的网格（可能已过期），没有时返回空指针
+    const ChunkMesh* find(int chunkX, int sectionY, int chunkZ, int lod = 0) {
+        auto it = meshes.find(key(chunkX, sectionY, chunkZ, lod));
+        if (it == meshes.end()) {
+            return nullptr;
+        }
+        it->second.lastUsedFrame = frame;
+        return &it->second;
+    }
+
+    // 放入后台生成的网格；比缓存中已有的网格旧时丢弃
+    bool install(int chunkX, int sectionY, int chunkZ, int lod, uint64_t revision, ChunkMesh&& built) {
+        auto inserted = meshes.emplace(key(chunkX, sectionY, chunkZ, lod), ChunkMesh());
+        ChunkMesh& mesh = inserted.first->second;
+        if (!inserted.second && mesh.revision >= revision) {
+            return false;
+        }
+        current.cachedQuads -= mesh.totalQuads();
+        current.cachedFaces -= mesh.faceCount;
+        int lastUsedFrame = inserted.second ? frame : mesh.lastUsedFrame;
+        mesh = std::move(built);
+        mesh.revision = revision;
+        mesh.lastUsedFrame = lastUsedFrame;
+        current.cachedQuads += mesh.totalQuads();
+        current.cachedFaces += mesh.faceCount;
+        current.rebuilds++;
+        current.totalRebuilds++;
+        return true;
+    }
+
+    // 记录一次网格绘制
+    void recordDraw(int quads, int lod = 0) {
+        current.drawnMeshes++;
+        current.drawnQuads += quads;
+        current.drawnQuadsByLod[lod] += quads;
+    }
+
+    // 按分段中心到相机的距离选择细节级别（带回差，选择结果按分段记住）
+    int selectLod(int chunkX, int sectionY, int chunkZ, float distance) {
+        auto inserted = lodSelections.emplace(key(chunkX, sectionY, chunkZ), LodSelection());
+        LodSelection& selection = inserted.first->second;
+        selection.level = selectMeshLod(distance, inserted.second ? -1 : selection.level);
+        selection.lastUsedFrame = frame;
+        return selection.level;
+    }
+
+    // 记录不透明网格按朝向的绘制和跳过情况
+    void recordFacing(const ChunkMesh& mesh, uint8_t facing) {
+        for (int face = 0; face < FACE_COUNT; face++) {
+            int quads = mesh.opaqueFaceStart[face + 1] - mesh.opaqueFaceStart[face];
+            if (facing & (1 << face)) current.drawnQuadsByFace[face] += quads;
+            else current.backfaceCulledQuads += quads;
+        }
+    }
+
+    // 相机进入另一个区块后，按新的视点把分段的半透明四边形从远到近重新排序
+    void sortTransparentQuads(int chunkX, int sectionY, int chunkZ, int lod, float eyeX, float eyeY, float eyeZ, uint64_t eyeKey) {
+        auto it = meshes.find(key(chunkX, sectionY, chunkZ, lod));
+        if (it == meshes.end() || it->second.transparentOrderKey == eyeKey) {
+            return;
+        }
+        sortMeshTransparentQuads(it->second, eyeX, eyeY, eyeZ);
+        it->second.transparentOrderKey = eyeKey;
+        current.transparentSorts++;
+    }
+
+    // 结束一帧：淘汰长时间未使用的网格并发布本帧统计
+    void endFrame() {
+        for (auto it = meshes.begin(); it != meshes.end();) {
+            if (frame - it->second.lastUsedFrame > MESH_CACHE_MAX_IDLE_FRAMES) {
+                current.cachedQuads -= it->second.totalQuads();
+                current.cachedFaces -= it->second.faceCount;
+                it = meshes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = lodSelections.begin(); it != lodSelections.end();) {
+            if (frame - it->second.lastUsedFrame > MESH_CACHE_MAX_IDLE_FRAMES) {
+                it = lodSelections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        current.cachedMeshes = static_cast<int>(meshes.size());
+        stats = current;
+        current.rebuilds = 0;
+        current.drawnMeshes = 0;
+        current.drawnQuads = 0;
+        current.transparentSorts = 0;
+        current.backfaceCulledQuads = 0;
+        for (int face = 0; face < FACE_COUNT; face++) {
+            current.drawnQuadsByFace[face] = 0;
+        }
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            current.drawnQuadsByLod[lod] = 0;
+        }
+        frame++;
+    }
+
+    void clear() {
+        meshes.clear();
+        lodSelections.clear();
+        current = ChunkMeshStats();
+        stats = ChunkMeshStats();
+        epoch++;
+    }
+
+    int getEpoch() const {
+        return epoch;
+    }
+
+    const ChunkMeshStats& getStats() const {
+        return stats;
+    }
+};
+
+#endif // CHUNK_MESH_H
@@ -0,0 +1,264 @@
+#ifndef CHUNK_MESH_WORKERS_H
+#define CHUNK_MESH_WORKERS_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_map>
+#include <algorithm>
+#include "chunk.h"
+#include "chunk_mesh.h"
+#include "chunk_lod.h"
+#include "trace.h"
+
+// 后台网格生成
+//
+// 主线程每帧把需要重新生成网格的可见分段按优先级（距离、是否在视线方向）排序后提交，
+// 任务携带分段的只读引用（写时复制保证之后的编辑不会影响任务看到的内容），
+// 工作线程生成网格后放入无锁队列，主线程在每帧的时间预算内取回并放入网格缓存。
+// 结果回来之前继续绘制旧网格，编辑和新进入视野的分段不会卡住一帧。
+
+// 每帧最多提交的网格任务数（其余的下一帧重新排序后再提交）
+const int MESH_MAX_QUEUED_JOBS = 512;
+// 每帧取回网格结果的时间预算（毫秒）
+const double MESH_UPLOAD_BUDGET_MS = 2.0;
+
+// 网格任务
+struct MeshJob {
+    int chunkX = 0;
+    int sectionY = 0;
+    int chunkZ = 0;
+    uint64_t revision = 0;       // 分段在提交时的修订号
+    int epoch = 0;               // 提交时网格缓存的清空次数
+    bool greedy = false;         // 是否贪心合并
+    int lod = 0;                 // 细节级别（大于0时生成降采样网格）
+    float priority = 0.0f;       // 越小越先生成
+    ConstChunkSectionPtr section; // 分段内容的只读引用
+};
+
+// 网格任务结果
+struct MeshJobResult {
+    int chunkX = 0;
+    int sectionY = 0;
+    int chunkZ = 0;
+    uint64_t revision = 0;
+    int epoch = 0;
+    bool greedy = false;
+    int lod = 0;
+    ChunkMesh mesh;
+    // 任务的分段引用随结果交回主线程释放：编辑时按引用计数判断是否需要复制，
+    // 引用必须在主线程上放掉，写入才能与工作线程的读取建立先后关系
+    ConstChunkSectionPtr section;
+};
+
+// 多生产者、单消费者的无锁队列（链表，入队只需一次原子交换）
+// 工作线程入队，只有主线程出队
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        std::atomic<Node*> next;
+        T value;
+        Node() : next(nullptr) {}
+    };
+
+    std::atomic<Node*> head; // 最新入队的节点（生产者端）
+    Node* tail;              // 哑节点，其后继是最早入队的节点（消费者端）
+
+public:
+    MpscQueue() {
+        Node* stub = new Node();
+        head.store(stub);
+        tail = stub;
+    }
+
+    ~MpscQueue() {
+        T discarded;
+        while (tryPop(discarded)) {
+        }
+        delete tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T&& value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // 只能由消费者线程调用
+    bool tryPop(T& out) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        out = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+};
+
+// 网格生成线程池
+class ChunkMeshWorkers {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<MeshJob> jobs;               // 尚未开始的任务（优先级最高的在末尾）
+    bool stopRequested = false;
+    MpscQueue<MeshJobResult> results;
+    // 以下只在主线程访问：已提交、尚未取回的分段及其修订号
+    std::unordered_map<uint64_t, uint64_t> inFlight;
+
+    void run() {
+        while (true) {
+            MeshJob job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !jobs.empty() || stopRequested; });
+                if (stopRequested) {
+                    return;
+                }
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            }
+
+            MeshJobResult result;
+            result.chunkX = job.chunkX;
+            result.sectionY = job.sectionY;
+            result.chunkZ = job.chunkZ;
+            result.revision = job.revision;
+            result.epoch = job.epoch;
+            result.greedy = job.greedy;
+            result.lod = job.lod;
+            int originX = job.chunkX * CHUNK_SIZE;
+            int originY = job.sectionY * CHUNK_SIZE;
+            int originZ = job.chunkZ * CHUNK_SIZE;
+            if (job.lod > 0) {
+                buildSectionLodMesh(*job.section, originX, originY, originZ, job.lod, result.mesh);
+            } else if (job.greedy) {
+                buildSectionMeshGreedy(*job.section, originX, originY, originZ, result.mesh);
+            } else {
+                buildSectionMesh(*job.section, originX, originY, originZ, result.mesh);
+            }
+            TRACE(TRACE_MESH, TRACE_LEVEL_DEBUG, "Meshed section (%d, %d, %d) rev %llu lod %d: %d quads%s",
+                  job.chunkX, job.sectionY, job.chunkZ, static_cast<unsigned long long>(job.revision), job.lod,
+                  result.mesh.totalQuads(), job.greedy ? " (greedy)" : "");
+            result.section = std::move(job.section);
+            results.push(std::move(result));
+        }
+    }
+
+public:
+    explicit ChunkMeshWorkers(int workerCount) {
+        for (int i = 0; i < workerCount; i++) {
+            workers.push_back(std::thread(&ChunkMeshWorkers::run, this));
+        }
+    }
+
+    ~ChunkMeshWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    ChunkMeshWorkers(const ChunkMeshWorkers&) = delete;
+    ChunkMeshWorkers& operator=(const ChunkMeshWorkers&) = delete;
+
+    // 该修订号的分段是否已提交且结果尚未取回
+    bool isInFlight(uint64_t key, uint64_t revision) const {
+        auto it = inFlight.find(key);
+        return it != inFlight.end() && it->second == revision;
+    }
+
+    // 用本帧的请求替换尚未开始的任务
+    // requests按优先级由高到低排列，不含分段内容；需要新任务时调用snapshot(job)取得分段的只读引用。
+    // 仍在排队的同一修订号任务直接沿用（只更新优先级），已经开始的任务不重复提交。
+    template <typename Snapshot>
+    void submit(const std::vector<MeshJob>& requests, Snapshot snapshot) {
+        std::vector<MeshJob> queued;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queued.swap(jobs);
+        }
+
+        std::unordered_map<uint64_t, size_t> queuedIndex;
+        for (size_t i = 0; i < queued.size(); i++) {
+            queuedIndex[ChunkMeshCache::key(queued[i].chunkX, queued[i].sectionY, queued[i].chunkZ, queued[i].lod)] = i;
+        }
+
+        std::vector<MeshJob> ordered;
+        ordered.reserve(std::min(requests.size(), static_cast<size_t>(MESH_MAX_QUEUED_JOBS)));
+        for (const MeshJob& request : requests) {
+            if (static_cast<int>(ordered.size()) >= MESH_MAX_QUEUED_JOBS) break;
+            uint64_t key = ChunkMeshCache::key(request.chunkX, request.sectionY, request.chunkZ, request.lod);
+            auto found = queuedIndex.find(key);
+            if (found != queuedIndex.end() && queued[found->second].revision == request.revision &&
+                queued[found->second].epoch == request.epoch) {
+                MeshJob& job = queued[found->second];
+                job.priority = request.priority;
+                ordered.push_back(std::move(job));
+                queuedIndex.erase(found);
+                continue;
+            }
+            if (isInFlight(key, request.revision)) continue; // 正在生成
+
+            MeshJob job = request;
+            job.section = snapshot(job);
+            if (!job.section) continue;
+            inFlight[key] = job.revision;
+            ordered.push_back(std::move(job));
+        }
+
+        // 没有被沿用的排队任务作废
+        for (const auto& entry : queuedIndex) {
+            const MeshJob& job = queued[entry.second];
+            auto it = inFlight.find(entry.first);
+            if (it != inFlight.end() && it->second == job.revision) {
+                inFlight.erase(it);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 工作线程从末尾取任务，因此反向存放
+            jobs.reserve(ordered.size());
+            for (auto it = ordered.rbegin(); it != ordered.rend(); ++it) {
+                jobs.push_back(std::move(*it));
+            }
+        }
+        condition.notify_all();
+    }
+
+    // 取回一个已完成的网格（只能由主线程调用）
+    bool tryCollect(MeshJobResult& out) {
+        if (!results.tryPop(out)) {
+            return false;
+        }
+        uint64_t key = ChunkMeshCache::key(out.chunkX, out.sectionY, out.chunkZ, out.lod);
+        auto it = inFlight.find(key);
+        if (it != inFlight.end() && it->second == out.revision) {
+            inFlight.erase(it);
+        }
+        return true;
+    }
+
+    int getPendingCount() const {
+        return static_cast<int>(inFlight.size());
+    }
+};
+
+#endif // CHUNK_MESH_WORKERS_H
@@ -0,0 +1,269 @@
+#ifndef CHUNK_RESIDENCY_H
+#define CHUNK_RESIDENCY_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include "chunk.h"
+
+// 区块驻留管理 - 远离相机的分段被压缩进内存冷池，访问时再按需解压
+//
+// 压缩流程：ChunkSection -> 紧凑字节流（类型/可见性与面掩码/自定义颜色） -> LZ压缩
+// 一个16^3的空气或石头分段从128KB压缩到几十字节，地表分段通常在1KB以内
+
+// 默认内存预算（去重后常驻分段占用的字节数上限）
+const size_t DEFAULT_RESIDENCY_BUDGET_BYTES = 128u * 1024u * 1024u;
+// 被唤醒的分段至少保留这么多次驻留更新后才允许再次压缩，避免反复压缩/解压
+const int RESIDENCY_COOLDOWN_UPDATES = 120;
+// 每次驻留更新最多压缩的分段数，把压缩开销分摊到多帧
+const int RESIDENCY_MAX_EVICTIONS_PER_UPDATE = 16;
+// 每隔多少次驻留更新重新统计一次去重后的实际内存
+const int RESIDENCY_REPORT_INTERVAL = 60;
+
+// 驻留统计（显示在F3调试界面）
+struct ChunkResidencyStats {
+    uint64_t hits = 0;           // 访问常驻分段的次数
+    uint64_t misses = 0;         // 访问冷分段的次数
+    uint64_t decompressions = 0; // 解压次数
+    uint64_t compressions = 0;   // 压缩次数
+    int residentSections = 0;    // 常驻分段数（按引用计）
+    int coldSections = 0;        // 冷分段数
+    size_t residentBytes = 0;    // 常驻分段按引用计的内存（不去重时的占用）
+    int uniqueSections = 0;      // 去重后实际存在的分段缓冲区数
+    size_t uniqueBytes = 0;      // 去重后实际占用的内存（与预算比较）
+    uint64_t internShared = 0;   // 去重时找到相同分段的次数
+    size_t coldBytes = 0;        // 冷池占用内存
+    size_t budgetBytes = 0;      // 内存预算
+};
+
+// ---------------------------------------------------------------------------
+// LZ压缩（LZ4风格的字节流格式）
+//   token: 高4位为字面量长度，低4位为匹配长度-4；长度为15时后续字节继续累加（255表示还有后续）
+//   随后是字面量，再是2字节小端偏移
+//   最后一个序列只有字面量
+// ---------------------------------------------------------------------------
+const int LZ_MIN_MATCH = 4;
+const int LZ_HASH_BITS = 12;
+const int LZ_MAX_OFFSET = 65535;
+
+inline void lzWriteLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+inline void lzCompress(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(size / 4 + 16);
+
+    int hashTable[1 << LZ_HASH_BITS];
+    for (int i = 0; i < (1 << LZ_HASH_BITS); i++) {
+        hashTable[i] = -1;
+    }
+
+    auto hash4 = [src](size_t pos) -> uint32_t {
+        uint32_t value;
+        std::memcpy(&value, src + pos, sizeof(value));
+        return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+    };
+
+    auto emitSequence = [&out, src](size_t literalStart, size_t literalLength, size_t matchLength, size_t offset) {
+        size_t tokenLiteral = literalLength < 15 ? literalLength : 15;
+        size_t matchCode = matchLength >= LZ_MIN_MATCH ? matchLength - LZ_MIN_MATCH : 0;
+        size_t tokenMatch = matchCode < 15 ? matchCode : 15;
+        out.push_back(static_cast<uint8_t>((tokenLiteral << 4) | tokenMatch));
+        if (tokenLiteral == 15) {
+            lzWriteLength(out, literalLength - 15);
+        }
+        out.insert(out.end(), src + literalStart, src + literalStart + literalLength);
+        if (matchLength >= LZ_MIN_MATCH) {
+            out.push_back(static_cast<uint8_t>(offset & 0xFF));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+            if (tokenMatch == 15) {
+                lzWriteLength(out, matchCode - 15);
+            }
+        }
+    };
+
+    size_t literalStart = 0;
+    size_t pos = 0;
+    while (pos + LZ_MIN_MATCH <= size) {
+        uint32_t h = hash4(pos);
+        int candidate = hashTable[h];
+        hashTable[h] = static_cast<int>(pos);
+
+        if (candidate >= 0 && pos - candidate <= LZ_MAX_OFFSET &&
+            std::memcmp(src + candidate, src + pos, LZ_MIN_MATCH) == 0) {
+            // 向后延伸匹配（允许与当前位置重叠，用于长串重复）
+            size_t matchLength = LZ_MIN_MATCH;
+            while (pos + matchLength < size && src[candidate + matchLength] == src[pos + matchLength]) {
+                matchLength++;
+            }
+            emitSequence(literalStart, pos - literalStart, matchLength, pos - candidate);
+            pos += matchLength;
+            literalStart = pos;
+        } else {
+            pos++;
+        }
+    }
+
+    // 结尾的字面量
+    emitSequence(literalStart, size - literalStart, 0, 0);
+}
+
+// 解压到固定大小的缓冲区，数据损坏时返回false
+inline bool lzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstSize) {
+    size_t in = 0;
+    size_t out = 0;
+
+    auto readLength = [&](size_t& length) -> bool {
+        uint8_t b;
+        do {
+            if (in >= size) return false;
+            b = src[in++];
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (in < size) {
+        uint8_t token = src[in++];
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !readLength(literalLength)) return false;
+        if (in + literalLength > size || out + literalLength > dstSize) return false;
+        std::memcpy(dst + out, src + in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        // 最后一个序列没有匹配部分
+        if (in >= size) break;
+
+        if (in + 2 > size) return false;
+        size_t offset = src[in] | (src[in + 1] << 8);
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(matchLength)) return false;
+        matchLength += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > out || out + matchLength > dstSize) return false;
+        // 逐字节复制以支持重叠匹配
+        const uint8_t* match = dst + out - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            dst[out + i] = match[i];
+        }
+        out += matchLength;
+    }
+
+    return out == dstSize;
+}
+
+// ---------------------------------------------------------------------------
+// 分段序列化
+//   [4096字节类型][4096字节标志：低6位面掩码，第7位可见][u16 自定义颜色方块数][(u16 局部索引, 6*RGBA) ...]
+// ---------------------------------------------------------------------------
+const size_t SECTION_FLAG_BYTES = CHUNK_VOLUME;
+const uint8_t SECTION_FLAG_VISIBLE = 0x40;
+const size_t SECTION_CUSTOM_ENTRY_BYTES = 2 + FACE_COUNT * 4;
+
+inline void encodeSection(const ChunkSection& section, std::vector<uint8_t>& raw) {
+    raw.assign(CHUNK_VOLUME + SECTION_FLAG_BYTES + 2, 0);
+
+    uint16_t customCount = 0;
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        const Block& block = section.blocks[i];
+        raw[i] = static_cast<uint8_t>(block.type);
+        raw[CHUNK_VOLUME + i] = static_cast<uint8_t>((block.faceMask & 0x3F) | (block.isVisible ? SECTION_FLAG_VISIBLE : 0));
+        if (block.hasCustomColors) {
+            customCount++;
+        }
+    }
+
+    size_t countOffset = CHUNK_VOLUME + SECTION_FLAG_BYTES;
+    raw[countOffset] = static_cast<uint8_t>(customCount & 0xFF);
+    raw[countOffset + 1] = static_cast<uint8_t>(customCount >> 8);
+
+    for (int i = 0; i < CHUNK_VOLUME && customCount > 0; i++) {
+        const Block& block = section.blocks[i];
+        if (!block.hasCustomColors) continue;
+        raw.push_back(static_cast<uint8_t>(i & 0xFF));
+        raw.push_back(static_cast<uint8_t>(i >> 8));
+        for (int face = 0; face < FACE_COUNT; face++) {
+            const Color& c = block.customColors[face];
+            raw.push_back(c.r);
+            raw.push_back(c.g);
+            raw.push_back(c.b);
+            raw.push_back(c.a);
+        }
+    }
+}
+
+inline bool decodeSection(const uint8_t* raw, size_t size, ChunkSection& section) {
+    size_t countOffset = CHUNK_VOLUME + SECTION_FLAG_BYTES;
+    if (size < countOffset + 2) return false;
+
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        Block& block = section.blocks[i];
+        block = Block(static_cast<BlockType>(raw[i]));
+        uint8_t flags = raw[CHUNK_VOLUME + i];
+        block.isVisible = (flags & SECTION_FLAG_VISIBLE) != 0;
+        block.faceMask = flags & 0x3F;
+    }
+
+    size_t customCount = raw[countOffset] | (raw[countOffset + 1] << 8);
+    size_t pos = countOffset + 2;
+    if (pos + customCount * SECTION_CUSTOM_ENTRY_BYTES > size) return false;
+    for (size_t n = 0; n < customCount; n++) {
+        int index = raw[pos] | (raw[pos + 1] << 8);
+        pos += 2;
+        if (index >= CHUNK_VOLUME) return false;
+        Block& block = section.blocks[index];
+        for (int face = 0; face < FACE_COUNT; face++) {
+            block.customColors[face] = Color(raw[pos], raw[pos + 1], raw[pos + 2], raw[pos + 3]);
+            pos += 4;
+        }
+        block.hasCustomColors = true;
+    }
+    return true;
+}
+
+// 压缩分段：冷数据前4字节记录序列化后的原始长度
+inline CompressedSectionPtr compressSection(const ChunkSection& section) {
+    std::vector<uint8_t> raw;
+    encodeSection(section, raw);
+
+    std::vector<uint8_t> packed;
+    lzCompress(raw.data(), raw.size(), packed);
+
+    auto result = std::make_shared<std::vector<uint8_t>>();
+    result->reserve(packed.size() + 4);
+    uint32_t rawSize = static_cast<uint32_t>(raw.size());
+    for (int i = 0; i < 4; i++) {
+        result->push_back(static_cast<uint8_t>(rawSize >> (i * 8)));
+    }
+    result->insert(result->end(), packed.begin(), packed.end());
+    result->shrink_to_fit();
+    return result;
+}
+
+// 解压分段，数据损坏时返回空指针
+inline ChunkSectionPtr decompressSection(const std::vector<uint8_t>& compressed) {
+    if (compressed.size() < 4) return nullptr;
+    uint32_t rawSize = compressed[0] | (compressed[1] << 8) | (compressed[2] << 16) | (static_cast<uint32_t>(compressed[3]) << 24);
+
+    std::vector<uint8_t> raw(rawSize);
+    if (!lzDecompress(compressed.data() + 4, compressed.size() - 4, raw.data(), raw.size())) {
+        return nullptr;
+    }
+
+    auto section = std::make_shared<ChunkSection>();
+    if (!decodeSection(raw.data(), raw.size(), *section)) {
+        return nullptr;
+    }
+    return section;
+}
+
+#endif // CHUNK_RESIDENCY_H
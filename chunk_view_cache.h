@@ -0,0 +1,199 @@
+#ifndef CHUNK_VIEW_CACHE_H
+#define CHUNK_VIEW_CACHE_H
+
+#include <vector>
+#include <cstdint>
+
+// 最近看到的区块缓存（渲染器用它让刚离开渲染距离的区块继续绘制一小段时间）
+//
+// 按区块坐标的开放寻址哈希表（线性探测，删除时向后移位，不留墓碑）查找，
+// 条目挂在两条侵入式LRU链表上：不在视野中的一条、在视野中的一条，都按最后看到的时间排序。
+// 查找、刷新、淘汰都是O(1)：满了先淘汰不在视野中最久没看到的，过期只需从两条链表头部往后扫。
+
+// 缓存统计（显示在F3调试界面）
+struct ChunkViewCacheStats {
+    int size = 0;             // 缓存中的区块数
+    int capacity = 0;         // 最大区块数
+    int frameLookups = 0;     // 上一帧的查询次数
+    int frameHits = 0;        // 上一帧命中的次数
+    uint64_t lookups = 0;     // 累计查询次数
+    uint64_t hits = 0;        // 累计命中次数
+    uint64_t evictions = 0;   // 缓存满时淘汰的区块数
+    uint64_t expirations = 0; // 超时移除的区块数
+};
+
+class ChunkViewCache {
+private:
+    enum { NONE = -1 };
+
+    struct Entry {
+        uint64_t key = 0;
+        float lastSeenTime = 0.0f;
+        bool inView = false;
+        int prev = NONE;
+        int next = NONE;
+    };
+
+    std::vector<Entry> entries;     // 固定容量的条目池
+    std::vector<int> freeEntries;   // 空闲条目下标
+    std::vector<int> slots;         // 哈希表：条目下标，NONE表示空槽
+    uint32_t slotMask = 0;
+    int head[2] = { NONE, NONE };   // [0]不在视野中、[1]在视野中，链表头是最久没看到的
+    int tail[2] = { NONE, NONE };
+    int size = 0;
+    ChunkViewCacheStats stats;
+    int currentLookups = 0;
+    int currentHits = 0;
+
+    // 区块坐标各取21位拼成键（负坐标按补码截断，无限世界范围内不会冲突）
+    static uint64_t makeKey(int x, int y, int z) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x) & 0x1FFFFF) << 42) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(y) & 0x1FFFFF) << 21) |
+               static_cast<uint64_t>(static_cast<uint32_t>(z) & 0x1FFFFF);
+    }
+
+    uint32_t slotOf(uint64_t key) const {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<uint32_t>(key) & slotMask;
+    }
+
+    // 返回键所在的槽，不存在时返回NONE
+    int findSlot(uint64_t key) const {
+        if (slots.empty()) return NONE;
+        for (uint32_t slot = slotOf(key); ; slot = (slot + 1) & slotMask) {
+            int index = slots[slot];
+            if (index == NONE) return NONE;
+            if (entries[index].key == key) return static_cast<int>(slot);
+        }
+    }
+
+    void unlink(int index) {
+        Entry& entry = entries[index];
+        int list = entry.inView ? 1 : 0;
+        if (entry.prev != NONE) entries[entry.prev].next = entry.next; else head[list] = entry.next;
+        if (entry.next != NONE) entries[entry.next].prev = entry.prev; else tail[list] = entry.prev;
+        entry.prev = entry.next = NONE;
+    }
+
+    void linkTail(int index) {
+        Entry& entry = entries[index];
+        int list = entry.inView ? 1 : 0;
+        entry.prev = tail[list];
+        entry.next = NONE;
+        if (tail[list] != NONE) entries[tail[list]].next = index; else head[list] = index;
+        tail[list] = index;
+    }
+
+    // 删除槽中的条目，之后的探测链向前移位填补空槽
+    void removeSlot(int slot) {
+        int index = slots[slot];
+        unlink(index);
+        freeEntries.push_back(index);
+        size--;
+
+        uint32_t hole = static_cast<uint32_t>(slot);
+        slots[hole] = NONE;
+        for (uint32_t next = (hole + 1) & slotMask; slots[next] != NONE; next = (next + 1) & slotMask) {
+            uint32_t home = slotOf(entries[slots[next]].key);
+            // home不在(hole, next]区间内时，这个条目可以移到空槽
+            bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+            if (movable) {
+                slots[hole] = slots[next];
+                slots[next] = NONE;
+                hole = next;
+            }
+        }
+    }
+
+    void removeEntry(int index) {
+        removeSlot(findSlot(entries[index].key));
+    }
+
+public:
+    explicit ChunkViewCache(int capacity) {
+        entries.resize(capacity);
+        freeEntries.reserve(capacity);
+        for (int i = capacity - 1; i >= 0; i--) {
+            freeEntries.push_back(i);
+        }
+        // 装载因子不超过1/2，线性探测链保持很短
+        uint32_t slotCount = 1;
+        while (slotCount < static_cast<uint32_t>(capacity) * 2) slotCount <<= 1;
+        slots.assign(slotCount, NONE);
+        slotMask = slotCount - 1;
+        stats.capacity = capacity;
+    }
+
+    // 区块是否在缓存中（计入命中率）
+    bool contains(int x, int y, int z) {
+        currentLookups++;
+        stats.lookups++;
+        if (findSlot(makeKey(x, y, z)) == NONE) return false;
+        currentHits++;
+        stats.hits++;
+        return true;
+    }
+
+    // 记录区块在time时刻被看到；缓存满时淘汰不在视野中最久没看到的区块（都在视野中则淘汰最久的）
+    void touch(int x, int y, int z, bool inView, float time) {
+        uint64_t key = makeKey(x, y, z);
+        int slot = findSlot(key);
+        int index;
+        if (slot != NONE) {
+            index = slots[slot];
+            unlink(index);
+        } else {
+            if (freeEntries.empty()) {
+                int victim = head[0] != NONE ? head[0] : head[1];
+                if (victim == NONE) return;
+                removeEntry(victim);
+                stats.evictions++;
+            }
+            index = freeEntries.back();
+            freeEntries.pop_back();
+            entries[index].key = key;
+            for (uint32_t s = slotOf(key); ; s = (s + 1) & slotMask) {
+                if (slots[s] == NONE) {
+                    slots[s] = index;
+                    break;
+                }
+            }
+            size++;
+        }
+        entries[index].lastSeenTime = time;
+        entries[index].inView = inView;
+        linkTail(index);
+    }
+
+    // 移除超过lifetime秒没有看到的区块（两条链表都按时间排序，只需检查头部）
+    void expire(float time, float lifetime) {
+        for (int list = 0; list < 2; list++) {
+            while (head[list] != NONE && time - entries[head[list]].lastSeenTime > lifetime) {
+                removeEntry(head[list]);
+                stats.expirations++;
+            }
+        }
+    }
+
+    // 每帧开始时调用：发布上一帧的命中统计
+    void beginFrame() {
+        stats.frameLookups = currentLookups;
+        stats.frameHits = currentHits;
+        currentLookups = 0;
+        currentHits = 0;
+    }
+
+    int getSize() const {
+        return size;
+    }
+
+    ChunkViewCacheStats getStats() const {
+        ChunkViewCacheStats result = stats;
+        result.size = size;
+        return result;
+    }
+};
+
+#endif // CHUNK_VIEW_CACHE_H
@@ -0,0 +1,262 @@
+#ifndef CLOUD_LAYER_H
+#define CLOUD_LAYER_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "math3d.h"
+#include "frustum.h"
+#include "render_backend.h"
+
+// 云层
+//
+// 云的形状来自一张按周期平铺的二维占用网格：CLOUD_GRID_SIZE x CLOUD_GRID_SIZE格，每格CLOUD_CELL_SIZE格宽，
+// 由固定种子的周期值噪声（两层倍频）按阈值生成，左右、前后边缘相接，平铺后看不出接缝。
+// 整个云层只沿X轴平移一个统一的偏移量，不再逐朵移动。网格只覆盖相机周围CLOUD_VIEW_RADIUS_CELLS格，
+// 顶点放在云层自己的坐标里（不含偏移），只有相机所在的云层格变化（相机走动或偏移越过一格）时才重新生成；
+// 格内的平移在绘制时加到顶点上。生成时每行相邻的顶面、底面和同一侧的侧面合并成长条，
+// 侧面只在相邻格没有云时输出。网格按CLOUD_BLOCK_CELLS x CLOUD_BLOCK_CELLS格分块并记录包围盒，
+// 视锥体外的块不绘制，其余块合并成一次绘制；相机在云层上方时不画底面，在下方时不画顶面。
+// 云面不写深度，所有面用同一种颜色和不透明度，重叠处的混合结果与绘制顺序无关。
+
+enum {
+    CLOUD_GRID_SIZE = 64,          // 占用网格每边的格数（图案按这个周期平铺，必须是2的幂）
+    CLOUD_CELL_SIZE = 12,          // 每格边长（格）
+    CLOUD_VIEW_RADIUS_CELLS = 20,  // 相机周围生成网格的半径（格）
+    CLOUD_BLOCK_CELLS = 8,         // 剔除块每边的格数（能整除网格边长2*CLOUD_VIEW_RADIUS_CELLS）
+    CLOUD_ALPHA = 150              // 云的不透明度
+};
+
+const float CLOUD_THICKNESS = 4.0f;  // 云层厚度
+const float CLOUD_THRESHOLD = 0.56f; // 噪声超过这个值的格有云
+
+// 云层统计
+struct CloudStats {
+    int quads = 0;        // 网格的四边形数
+    int blocks = 0;       // 有云的剔除块数
+    int drawnBlocks = 0;  // 本帧绘制的块数
+    int drawnQuads = 0;   // 本帧绘制的四边形数
+    int rebuilds = 0;     // 网格累计重新生成的次数
+};
+
+class CloudLayer {
+private:
+    // 块的顶点依次为顶面、底面、侧面
+    struct Block {
+        size_t firstVertex = 0;
+        size_t topVertices = 0;
+        size_t bottomVertices = 0;
+        size_t vertexCount = 0;
+        float minX = 0.0f; // 包围盒（云层坐标，高度方向就是云层的上下表面）
+        float minZ = 0.0f;
+        float maxX = 0.0f;
+        float maxZ = 0.0f;
+    };
+
+    uint8_t occupancy[CLOUD_GRID_SIZE * CLOUD_GRID_SIZE] = {};
+    std::vector<VertexPositionColor> vertices;      // 云层坐标
+    std::vector<Block> blocks;
+    std::vector<VertexPositionColor> frameVertices; // 本帧要绘制的四边形（加上偏移后的世界坐标）
+    float height = 0.0f;   // 云层底面高度
+    float offset = 0.0f;   // 沿X轴的平移（按图案周期取模）
+    int originCellX = 0;   // 生成网格时相机所在的云层格
+    int originCellZ = 0;
+    bool built = false;
+    CloudStats stats;
+
+    static uint32_t hashLattice(uint32_t seed, int period, int x, int z) {
+        uint32_t h = seed ^ (static_cast<uint32_t>(period) * 0x9E3779B9u);
+        h ^= static_cast<uint32_t>(x) * 0x85EBCA6Bu;
+        h = (h ^ (h >> 13)) * 0xC2B2AE35u;
+        h ^= static_cast<uint32_t>(z) * 0x27D4EB2Fu;
+        h = (h ^ (h >> 15)) * 0x165667B1u;
+        return h ^ (h >> 16);
+    }
+
+    // 周期为period个格点的值噪声（网格坐标x、z，结果在[0,1)）
+    static float periodicNoise(uint32_t seed, int period, int x, int z) {
+        const int step = CLOUD_GRID_SIZE / period;
+        int x0 = x / step;
+        int z0 = z / step;
+        float tx = static_cast<float>(x % step) / step;
+        float tz = static_cast<float>(z % step) / step;
+        tx = tx * tx * (3.0f - 2.0f * tx);
+        tz = tz * tz * (3.0f - 2.0f * tz);
+        auto value = [&](int lx, int lz) {
+            return (hashLattice(seed, period, lx & (period - 1), lz & (period - 1)) & 0xFFFF) / 65536.0f;
+        };
+        float top = value(x0, z0) + (value(x0 + 1, z0) - value(x0, z0)) * tx;
+        float bottom = value(x0, z0 + 1) + (value(x0 + 1, z0 + 1) - value(x0, z0 + 1)) * tx;
+        return top + (bottom - top) * tz;
+    }
+
+    // 云层格（可以是任意整数，按周期平铺）是否有云
+    bool occupied(int cellX, int cellZ) const {
+        return occupancy[(cellZ & (CLOUD_GRID_SIZE - 1)) * CLOUD_GRID_SIZE + (cellX & (CLOUD_GRID_SIZE - 1))] != 0;
+    }
+
+    // 追加一个四边形（四个角按顺序围成矩形）
+    void appendQuad(float x0, float y0, float z0, float x1, float y1, float z1, float x2, float y2, float z2,
+                    float x3, float y3, float z3, uint32_t color) {
+        const float corners[4][3] = { { x0, y0, z0 }, { x1, y1, z1 }, { x2, y2, z2 }, { x3, y3, z3 } };
+        for (int c = 0; c < 4; c++) {
+            VertexPositionColor vertex;
+            vertex.x = corners[c][0];
+            vertex.y = corners[c][1];
+            vertex.z = corners[c][2];
+            vertex.color = color;
+            vertices.push_back(vertex);
+        }
+    }
+
+    // 生成一个剔除块的四边形：顶面、底面和Z方向的侧面按行合并，X方向的侧面按列合并
+    void buildBlock(int startX, int startZ, int cells, Block& block) {
+        const uint32_t color = packVertexColor(255, 255, 255, CLOUD_ALPHA);
+        const float size = static_cast<float>(CLOUD_CELL_SIZE);
+        const float y0 = height;
+        const float y1 = height + CLOUD_THICKNESS;
+
+        // 逐行（或逐列）找出test成立的连续格，每段调用一次emit(行号, 起点, 终点)
+        auto forRuns = [cells](auto test, auto emit) {
+            for (int line = 0; line < cells; line++) {
+                int start = -1;
+                for (int i = 0; i <= cells; i++) {
+                    bool inRun = i < cells && test(line, i);
+                    if (inRun && start < 0) start = i;
+                    if (!inRun && start >= 0) {
+                        emit(line, start, i);
+                        start = -1;
+                    }
+                }
+            }
+        };
+
+        // 行：line为Z，i为X
+        auto cloudCell = [&](int z, int x) { return occupied(startX + x, startZ + z); };
+        forRuns(cloudCell, [&](int z, int a, int b) {
+            float xa = (startX + a) * size, xb = (startX + b) * size;
+            float za = (startZ + z) * size, zb = za + size;
+            appendQuad(xa, y1, zb, xb, y1, zb, xb, y1, za, xa, y1, za, color);
+        });
+        block.topVertices = vertices.size() - block.firstVertex;
+        forRuns(cloudCell, [&](int z, int a, int b) {
+            float xa = (startX + a) * size, xb = (startX + b) * size;
+            float za = (startZ + z) * size, zb = za + size;
+            appendQuad(xa, y0, za, xb, y0, za, xb, y0, zb, xa, y0, zb, color);
+        });
+        block.bottomVertices = vertices.size() - block.firstVertex - block.topVertices;
+        for (int side = 0; side < 2; side++) {
+            int dz = side == 0 ? -1 : 1;
+            forRuns([&](int z, int x) { return occupied(startX + x, startZ + z) && !occupied(startX + x, startZ + z + dz); },
+                    [&](int z, int a, int b) {
+                float xa = (startX + a) * size, xb = (startX + b) * size;
+                float zf = (startZ + z + (side == 0 ? 0 : 1)) * size;
+                appendQuad(xa, y0, zf, xb, y0, zf, xb, y1, zf, xa, y1, zf, color);
+            });
+        }
+        // 列：line为X，i为Z
+        for (int side = 0; side < 2; side++) {
+            int dx = side == 0 ? -1 : 1;
+            forRuns([&](int x, int z) { return occupied(startX + x, startZ + z) && !occupied(startX + x + dx, startZ + z); },
+                    [&](int x, int a, int b) {
+                float za = (startZ + a) * size, zb = (startZ + b) * size;
+                float xf = (startX + x + (side == 0 ? 0 : 1)) * size;
+                appendQuad(xf, y0, za, xf, y0, zb, xf, y1, zb, xf, y1, za, color);
+            });
+        }
+    }
+
+    void rebuild() {
+        vertices.clear();
+        blocks.clear();
+        const int span = CLOUD_VIEW_RADIUS_CELLS * 2;
+        const int firstX = originCellX - CLOUD_VIEW_RADIUS_CELLS;
+        const int firstZ = originCellZ - CLOUD_VIEW_RADIUS_CELLS;
+        for (int bz = 0; bz < span; bz += CLOUD_BLOCK_CELLS) {
+            for (int bx = 0; bx < span; bx += CLOUD_BLOCK_CELLS) {
+                Block block;
+                block.firstVertex = vertices.size();
+                buildBlock(firstX + bx, firstZ + bz, CLOUD_BLOCK_CELLS, block);
+                block.vertexCount = vertices.size() - block.firstVertex;
+                if (block.vertexCount == 0) continue;
+                block.minX = static_cast<float>((firstX + bx) * CLOUD_CELL_SIZE);
+                block.minZ = static_cast<float>((firstZ + bz) * CLOUD_CELL_SIZE);
+                block.maxX = block.minX + CLOUD_BLOCK_CELLS * CLOUD_CELL_SIZE;
+                block.maxZ = block.minZ + CLOUD_BLOCK_CELLS * CLOUD_CELL_SIZE;
+                blocks.push_back(block);
+            }
+        }
+        built = true;
+        stats.quads = static_cast<int>(vertices.size() / 4);
+        stats.blocks = static_cast<int>(blocks.size());
+        stats.rebuilds++;
+    }
+
+public:
+    // 由种子生成占用网格（丢弃已有的网格）
+    void generate(uint32_t seed, float layerHeight) {
+        height = layerHeight;
+        offset = 0.0f;
+        for (int z = 0; z < CLOUD_GRID_SIZE; z++) {
+            for (int x = 0; x < CLOUD_GRID_SIZE; x++) {
+                float value = 0.65f * periodicNoise(seed, 8, x, z) + 0.35f * periodicNoise(seed, 16, x, z);
+                occupancy[z * CLOUD_GRID_SIZE + x] = value > CLOUD_THRESHOLD ? 1 : 0;
+            }
+        }
+        built = false;
+        stats = CloudStats();
+    }
+
+    // 云层整体沿X轴移动（图案是周期的，偏移量按周期取模，避免浮点数越来越大）
+    void scroll(float distance) {
+        const float period = static_cast<float>(CLOUD_GRID_SIZE * CLOUD_CELL_SIZE);
+        offset = std::fmod(offset + distance, period);
+        if (offset < 0.0f) offset += period;
+    }
+
+    // 收集视锥体内的剔除块，合并后调用一次draw(vertices, quadCount)；相机所在的云层格变化时先重新生成网格
+    template <typename Draw>
+    void draw(const Vec3& eye, const Frustum& frustum, Draw drawQuads) {
+        int cellX = static_cast<int>(std::floor((eye.x - offset) / CLOUD_CELL_SIZE));
+        int cellZ = static_cast<int>(std::floor(eye.z / CLOUD_CELL_SIZE));
+        if (!built || cellX != originCellX || cellZ != originCellZ) {
+            originCellX = cellX;
+            originCellZ = cellZ;
+            rebuild();
+        }
+
+        // 背对相机的顶面或底面不画
+        const bool drawTops = eye.y > height + CLOUD_THICKNESS;
+        const bool drawBottoms = eye.y < height;
+        stats.drawnBlocks = 0;
+        frameVertices.clear();
+        for (const Block& block : blocks) {
+            if (!frustum.intersectsAABB(Vec3(block.minX + offset, height, block.minZ),
+                                        Vec3(block.maxX + offset, height + CLOUD_THICKNESS, block.maxZ))) {
+                continue;
+            }
+            size_t first = frameVertices.size();
+            auto begin = vertices.begin() + block.firstVertex;
+            auto bottoms = begin + block.topVertices;
+            auto sides = bottoms + block.bottomVertices;
+            if (drawTops || !drawBottoms) frameVertices.insert(frameVertices.end(), begin, bottoms);
+            if (drawBottoms || !drawTops) frameVertices.insert(frameVertices.end(), bottoms, sides);
+            frameVertices.insert(frameVertices.end(), sides, begin + block.vertexCount);
+            for (size_t i = first; i < frameVertices.size(); i++) {
+                frameVertices[i].x += offset;
+            }
+            stats.drawnBlocks++;
+        }
+        stats.drawnQuads = static_cast<int>(frameVertices.size() / 4);
+        if (stats.drawnQuads > 0) {
+            drawQuads(frameVertices.data(), stats.drawnQuads);
+        }
+    }
+
+    const CloudStats& getStats() const {
+        return stats;
+    }
+};
+
+#endif // CLOUD_LAYER_H
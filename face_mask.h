@@ -0,0 +1,148 @@
+#ifndef FACE_MASK_H
+#define FACE_MASK_H
+
+#include <cstdint>
+#include "chunk.h"
+
+// 方块面暴露掩码（6位，第i位对应Face枚举中的第i个面）
+//
+// 某个面相邻的方块透明（或在世界边界外）时该面暴露，需要渲染。
+// 整个分段的掩码用位运算一次算出：分段的"透明"位集每个64位字存4行x（16位一行），
+// 与方块数组的存储顺序一致（第w个字的第b位就是blocks[w * 64 + b]），
+// 六个方向的相邻关系都变成字内移位或取相邻的字，一次处理64个方块。
+
+const uint8_t FACE_MASK_ALL = 0x3F;
+
+inline uint8_t faceBit(Face face) {
+    return static_cast<uint8_t>(1u << face);
+}
+
+// 每个分段的位集：64个字 * 64位 = 4096个方块
+const int SECTION_BIT_WORDS = CHUNK_VOLUME / 64;
+
+struct SectionBits {
+    uint64_t words[SECTION_BIT_WORDS];
+
+    void fill(bool value) {
+        uint64_t word = value ? ~0ULL : 0ULL;
+        for (int i = 0; i < SECTION_BIT_WORDS; i++) {
+            words[i] = word;
+        }
+    }
+};
+
+// 按方块类型查表判断透明（避免对每个方块调用isTransparentBlockType）
+inline bool isTransparentLookup(BlockType type) {
+    struct Table {
+        bool transparent[BLOCK_COUNT];
+        Table() {
+            for (int i = 0; i < BLOCK_COUNT; i++) {
+                transparent[i] = isTransparentBlockType(static_cast<BlockType>(i));
+            }
+        }
+    };
+    static const Table table;
+    return type >= 0 && type < BLOCK_COUNT ? table.transparent[type] : true;
+}
+
+// 是否为始终渲染的半透明方块（与World::updateBlockVisibilityAt的规则一致）
+inline bool isAlwaysVisibleBlockType(BlockType type) {
+    return type == BLOCK_WATER || type == BLOCK_LEAVES || type == BLOCK_LAVA;
+}
+
+// 由分段内容生成透明位集和实心（非空气）位集
+inline void buildSectionBits(const ChunkSection& section, SectionBits& transparent, SectionBits& solid) {
+    for (int w = 0; w < SECTION_BIT_WORDS; w++) {
+        uint64_t transparentWord = 0;
+        uint64_t solidWord = 0;
+        const Block* blocks = section.blocks + w * 64;
+        for (int b = 0; b < 64; b++) {
+            BlockType type = blocks[b].type;
+            transparentWord |= static_cast<uint64_t>(isTransparentLookup(type)) << b;
+            solidWord |= static_cast<uint64_t>(type != BLOCK_AIR) << b;
+        }
+        transparent.words[w] = transparentWord;
+        solid.words[w] = solidWord;
+    }
+}
+
+// 计算分段内每个方块的面掩码
+// neighbours按Face枚举顺序给出六个相邻分段的透明位集（世界边界外传入全1）
+// 字布局：w = z * 4 + (y >> 2)，b = (y & 3) * 16 + x
+inline void computeSectionFaceMasks(const SectionBits& transparent, const SectionBits& solid,
+                                    const SectionBits* const neighbours[FACE_COUNT], uint8_t masks[CHUNK_VOLUME]) {
+    const uint64_t ROW_X0 = 0x0001000100010001ULL;
+    const uint64_t ROW_X15 = 0x8000800080008000ULL;
+    const uint64_t* self = transparent.words;
+
+    for (int w = 0; w < SECTION_BIT_WORDS; w++) {
+        uint64_t solidWord = solid.words[w];
+        uint8_t* out = masks + w * 64;
+        if (solidWord == 0) {
+            for (int b = 0; b < 64; b++) {
+                out[b] = 0;
+            }
+            continue;
+        }
+
+        int z = w >> 2;
+        int yq = w & 3;
+        uint64_t t = self[w];
+
+        uint64_t exposed[FACE_COUNT];
+        // +z / -z：相邻的z行在前后第4个字，分段边界取相邻分段的第一/最后一行z
+        exposed[FACE_FRONT] = z < CHUNK_SIZE - 1 ? self[w + 4] : neighbours[FACE_FRONT]->words[yq];
+        exposed[FACE_BACK] = z > 0 ? self[w - 4] : neighbours[FACE_BACK]->words[(CHUNK_SIZE - 1) * 4 + yq];
+        // -x / +x：行内移1位，行首/行尾由相邻分段的x=15/x=0补齐
+        exposed[FACE_LEFT] = ((t << 1) & ~ROW_X0) | ((neighbours[FACE_LEFT]->words[w] >> 15) & ROW_X0);
+        exposed[FACE_RIGHT] = ((t >> 1) & ~ROW_X15) | ((neighbours[FACE_RIGHT]->words[w] << 15) & ROW_X15);
+        // +y / -y：字内移16位，跨字时取上一个/下一个字（分段边界取上下分段）
+        uint64_t above = yq < 3 ? self[w + 1] : neighbours[FACE_TOP]->words[z * 4];
+        uint64_t below = yq > 0 ? self[w - 1] : neighbours[FACE_BOTTOM]->words[z * 4 + 3];
+        exposed[FACE_TOP] = (t >> 16) | (above << 48);
+        exposed[FACE_BOTTOM] = (t << 16) | (below >> 48);
+
+        for (int face = 0; face < FACE_COUNT; face++) {
+            exposed[face] &= solidWord;
+        }
+
+        for (int b = 0; b < 64; b++) {
+            out[b] = static_cast<uint8_t>(
+                ((exposed[FACE_FRONT] >> b) & 1) |
+                (((exposed[FACE_BACK] >> b) & 1) << FACE_BACK) |
+                (((exposed[FACE_LEFT] >> b) & 1) << FACE_LEFT) |
+                (((exposed[FACE_RIGHT] >> b) & 1) << FACE_RIGHT) |
+                (((exposed[FACE_TOP] >> b) & 1) << FACE_TOP) |
+                (((exposed[FACE_BOTTOM] >> b) & 1) << FACE_BOTTOM));
+        }
+    }
+}
+
+// 把计算好的掩码写入分段，返回是否有方块发生变化
+inline bool applySectionFaceMasks(ChunkSection& section, const uint8_t masks[CHUNK_VOLUME]) {
+    bool changed = false;
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        Block& block = section.blocks[i];
+        bool visible = block.type != BLOCK_AIR && (masks[i] != 0 || isAlwaysVisibleBlockType(block.type));
+        if (block.faceMask != masks[i] || block.isVisible != visible) {
+            block.faceMask = masks[i];
+            block.isVisible = visible;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// 比较掩码与分段现有内容，不需要修改时可以避免写时复制
+inline bool sectionFaceMasksDiffer(const ChunkSection& section, const uint8_t masks[CHUNK_VOLUME]) {
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        const Block& block = section.blocks[i];
+        bool visible = block.type != BLOCK_AIR && (masks[i] != 0 || isAlwaysVisibleBlockType(block.type));
+        if (block.faceMask != masks[i] || block.isVisible != visible) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // FACE_MASK_H
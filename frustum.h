@@ -0,0 +1,122 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cmath>
+#include <algorithm>
+#include "math3d.h"
+
+// 视锥体剔除
+//
+// 每帧从视图投影矩阵提取六个裁剪平面（左、右、下、上、近、远），法线指向视锥体内部。
+// 区块用轴对齐包围盒（AABB）与六个平面比较，分为完全在外、与边界相交、完全在内三类：
+// 完全在外的区块整块跳过，完全在内的区块其中的方块不需要再逐个检测。
+
+enum FrustumClass {
+    FRUSTUM_OUTSIDE = 0,   // 完全在视锥体外
+    FRUSTUM_INTERSECT = 1, // 与视锥体边界相交
+    FRUSTUM_INSIDE = 2     // 完全在视锥体内
+};
+
+// 平面：normal·p + d >= 0 的一侧为视锥体内部
+struct FrustumPlane {
+    Vec3 normal;
+    float d = 0.0f;
+
+    float distance(const Vec3& p) const {
+        return normal.dot(p) + d;
+    }
+};
+
+// 点到AABB的最近距离（平方），点在盒内时为0
+inline float aabbNearestDistanceSq(const Vec3& p, const Vec3& boxMin, const Vec3& boxMax) {
+    float dx = std::max(boxMin.x - p.x, std::max(0.0f, p.x - boxMax.x));
+    float dy = std::max(boxMin.y - p.y, std::max(0.0f, p.y - boxMax.y));
+    float dz = std::max(boxMin.z - p.z, std::max(0.0f, p.z - boxMax.z));
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// 点到AABB最远角的距离（平方）
+inline float aabbFarthestDistanceSq(const Vec3& p, const Vec3& boxMin, const Vec3& boxMax) {
+    float dx = std::max(p.x - boxMin.x, boxMax.x - p.x);
+    float dy = std::max(p.y - boxMin.y, boxMax.y - p.y);
+    float dz = std::max(p.z - boxMin.z, boxMax.z - p.z);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+class Frustum {
+public:
+    enum PlaneIndex {
+        PLANE_LEFT = 0,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT
+    };
+
+    FrustumPlane planes[PLANE_COUNT];
+
+    // 从视图投影矩阵提取平面（DirectX行向量约定：clip = v * M，裁剪空间 z 范围 [0, w]）
+    // 裁剪坐标的每个分量是顶点与矩阵某一列的点积，因此平面由列的组合得到
+    void extract(const Mat4& viewProjection) {
+        const float (*m)[4] = viewProjection.m;
+        setPlane(PLANE_LEFT,   m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0]);
+        setPlane(PLANE_RIGHT,  m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0]);
+        setPlane(PLANE_BOTTOM, m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1]);
+        setPlane(PLANE_TOP,    m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1]);
+        setPlane(PLANE_NEAR,   m[0][2],           m[1][2],           m[2][2],           m[3][2]);
+        setPlane(PLANE_FAR,    m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2]);
+    }
+
+    // AABB与视锥体的关系：对每个平面只需检查离平面最远（p顶点）和最近（n顶点）的两个角
+    FrustumClass classifyAABB(const Vec3& boxMin, const Vec3& boxMax) const {
+        FrustumClass result = FRUSTUM_INSIDE;
+        for (int i = 0; i < PLANE_COUNT; i++) {
+            const FrustumPlane& plane = planes[i];
+            Vec3 positive(plane.normal.x >= 0.0f ? boxMax.x : boxMin.x,
+                          plane.normal.y >= 0.0f ? boxMax.y : boxMin.y,
+                          plane.normal.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (plane.distance(positive) < 0.0f) {
+                return FRUSTUM_OUTSIDE;
+            }
+            Vec3 negative(plane.normal.x >= 0.0f ? boxMin.x : boxMax.x,
+                          plane.normal.y >= 0.0f ? boxMin.y : boxMax.y,
+                          plane.normal.z >= 0.0f ? boxMin.z : boxMax.z);
+            if (plane.distance(negative) < 0.0f) {
+                result = FRUSTUM_INTERSECT;
+            }
+        }
+        return result;
+    }
+
+    // AABB是否至少有一部分在视锥体内（不区分相交和完全在内，少做一半的点积）
+    bool intersectsAABB(const Vec3& boxMin, const Vec3& boxMax) const {
+        for (int i = 0; i < PLANE_COUNT; i++) {
+            const FrustumPlane& plane = planes[i];
+            Vec3 positive(plane.normal.x >= 0.0f ? boxMax.x : boxMin.x,
+                          plane.normal.y >= 0.0f ? boxMax.y : boxMin.y,
+                          plane.normal.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (plane.distance(positive) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // 归一化后平面方程的值就是到平面的距离
+    void setPlane(int index, float a, float b, float c, float d) {
+        float length = std::sqrt(a * a + b * b + c * c);
+        if (length > 0.0f) {
+            a /= length;
+            b /= length;
+            c /= length;
+            d /= length;
+        }
+        planes[index].normal = Vec3(a, b, c);
+        planes[index].d = d;
+    }
+};
+
+#endif // FRUSTUM_H
@@ -0,0 +1,257 @@
+#ifndef HORIZON_H
+#define HORIZON_H
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "math3d.h"
+#include "frustum.h"
+#include "render_backend.h"
+
+// 地平线远景环带
+//
+// 渲染距离之外原本只有天空的清屏颜色。这里用区块列的地表高度生成一圈粗糙的高度场：
+// 世界按128x128格切成地砖，每块地砖4x4个网格（每格32格宽），网格顶点取该位置地表方块的顶面高度，
+// 颜色取地表方块顶面的颜色。整圈只有两三千个四边形，比把完整区块渲染得更远便宜得多。
+// 地砖按世界坐标对齐并缓存，相机移动时只生成新进入环带的地砖；
+// 每帧轮流检查几块地砖覆盖的区块列修订号，地表有变化时重新生成，每帧生成的地砖数有上限。
+// 与区块渲染范围相交的网格不绘制（网格最近点在渲染距离以内），高度场整体略微下沉，
+// 接缝处不会盖住真实地形。
+
+enum {
+    HORIZON_TILE_SIZE = 128,   // 地砖边长（格）
+    HORIZON_TILE_CELLS = 4,    // 每块地砖每边的网格数
+    HORIZON_CELL_SIZE = HORIZON_TILE_SIZE / HORIZON_TILE_CELLS,
+    HORIZON_RING_WIDTH = 512,  // 环带从渲染距离向外延伸的宽度（格）
+    HORIZON_MAX_BUILDS_PER_FRAME = 4,  // 每帧最多生成的地砖数
+    HORIZON_CHECKS_PER_FRAME = 8,      // 每帧检查地表是否变化的地砖数
+    HORIZON_MAX_IDLE_FRAMES = 300      // 淘汰超过这么多帧不在环带内的地砖
+};
+
+const float HORIZON_DROP = 2.0f; // 高度场整体下沉的高度
+
+// 地表采样：valid为false表示这里没有地形（有限世界的边界外）
+struct HorizonSample {
+    bool valid = false;
+    float top = 0.0f;    // 地表方块顶面的高度
+    uint32_t color = 0;  // 顶点颜色
+};
+
+// 每帧的远景统计
+struct HorizonStats {
+    int tiles = 0;        // 缓存的地砖数
+    int drawnTiles = 0;   // 本帧绘制的地砖数
+    int drawnQuads = 0;   // 本帧绘制的四边形数
+    int builds = 0;       // 本帧生成的地砖数（新进入环带或地表变化）
+};
+
+class HorizonRing {
+private:
+    struct Tile {
+        std::vector<VertexPositionColor> vertices;     // 按网格顺序，每个有效网格一个四边形
+        int8_t cellQuad[HORIZON_TILE_CELLS * HORIZON_TILE_CELLS]; // 网格对应的四边形序号（没有地形时为-1）
+        float minY = 0.0f;
+        float maxY = 0.0f;
+        uint64_t signature = 0; // 生成时覆盖的区块列的修订号摘要
+        int lastUsedFrame = 0;
+    };
+
+    std::unordered_map<uint64_t, Tile> tiles;
+    std::vector<std::pair<int, uint64_t>> wanted; // 本帧环带内的地砖（按距离排序）
+    std::vector<VertexPositionColor> frameVertices; // 本帧要绘制的四边形（合并成一次绘制）
+    size_t checkCursor = 0;
+    int frame = 0;
+    HorizonStats stats;
+
+    static uint64_t key(int tileX, int tileZ) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32) | static_cast<uint32_t>(tileZ);
+    }
+
+    static int keyX(uint64_t tileKey) {
+        return static_cast<int>(static_cast<uint32_t>(tileKey >> 32));
+    }
+
+    static int keyZ(uint64_t tileKey) {
+        return static_cast<int>(static_cast<uint32_t>(tileKey));
+    }
+
+    // 点到矩形的水平距离（平方）
+    static float rectDistanceSq(float x, float z, float minX, float minZ, float size) {
+        float dx = std::max(0.0f, std::max(minX - x, x - (minX + size)));
+        float dz = std::max(0.0f, std::max(minZ - z, z - (minZ + size)));
+        return dx * dx + dz * dz;
+    }
+
+    template <typename Sample>
+    static void buildTile(int tileX, int tileZ, Tile& tile, Sample& sample) {
+        const int points = HORIZON_TILE_CELLS + 1;
+        HorizonSample grid[(HORIZON_TILE_CELLS + 1) * (HORIZON_TILE_CELLS + 1)];
+        int originX = tileX * HORIZON_TILE_SIZE;
+        int originZ = tileZ * HORIZON_TILE_SIZE;
+        for (int j = 0; j < points; j++) {
+            for (int i = 0; i < points; i++) {
+                sample(originX + i * HORIZON_CELL_SIZE, originZ + j * HORIZON_CELL_SIZE, grid[j * points + i]);
+            }
+        }
+
+        tile.vertices.clear();
+        tile.minY = 1e9f;
+        tile.maxY = -1e9f;
+        int quads = 0;
+        for (int j = 0; j < HORIZON_TILE_CELLS; j++) {
+            for (int i = 0; i < HORIZON_TILE_CELLS; i++) {
+                // 顶点顺序与方块顶面相同：(x0,z1) (x1,z1) (x1,z0) (x0,z0)
+                const HorizonSample* corners[4] = {
+                    &grid[(j + 1) * points + i], &grid[(j + 1) * points + i + 1],
+                    &grid[j * points + i + 1], &grid[j * points + i]
+                };
+                const int cornerX[4] = { i, i + 1, i + 1, i };
+                const int cornerZ[4] = { j + 1, j + 1, j, j };
+                bool valid = true;
+                for (int c = 0; c < 4; c++) valid = valid && corners[c]->valid;
+                if (!valid) {
+                    tile.cellQuad[j * HORIZON_TILE_CELLS + i] = -1;
+                    continue;
+                }
+                tile.cellQuad[j * HORIZON_TILE_CELLS + i] = static_cast<int8_t>(quads++);
+                for (int c = 0; c < 4; c++) {
+                    VertexPositionColor vertex;
+                    vertex.x = static_cast<float>(originX + cornerX[c] * HORIZON_CELL_SIZE);
+                    vertex.y = corners[c]->top - HORIZON_DROP;
+                    vertex.z = static_cast<float>(originZ + cornerZ[c] * HORIZON_CELL_SIZE);
+                    vertex.color = corners[c]->color;
+                    tile.vertices.push_back(vertex);
+                    tile.minY = std::min(tile.minY, vertex.y);
+                    tile.maxY = std::max(tile.maxY, vertex.y);
+                }
+            }
+        }
+    }
+
+public:
+    // 更新环带内的地砖：innerRadius为区块渲染距离，outerRadius为环带外缘
+    // sample(x, z, HorizonSample&)取世界坐标处的地表，signature(minX, minZ, size)返回区域内区块列的修订号摘要
+    template <typename Sample, typename Signature>
+    void update(float eyeX, float eyeZ, float innerRadius, float outerRadius, Sample sample, Signature signature) {
+        stats.builds = 0;
+        wanted.clear();
+        int minTileX = static_cast<int>(std::floor((eyeX - outerRadius) / HORIZON_TILE_SIZE));
+        int maxTileX = static_cast<int>(std::floor((eyeX + outerRadius) / HORIZON_TILE_SIZE));
+        int minTileZ = static_cast<int>(std::floor((eyeZ - outerRadius) / HORIZON_TILE_SIZE));
+        int maxTileZ = static_cast<int>(std::floor((eyeZ + outerRadius) / HORIZON_TILE_SIZE));
+        for (int tileZ = minTileZ; tileZ <= maxTileZ; tileZ++) {
+            for (int tileX = minTileX; tileX <= maxTileX; tileX++) {
+                float minX = static_cast<float>(tileX * HORIZON_TILE_SIZE);
+                float minZ = static_cast<float>(tileZ * HORIZON_TILE_SIZE);
+                float nearestSq = rectDistanceSq(eyeX, eyeZ, minX, minZ, static_cast<float>(HORIZON_TILE_SIZE));
+                if (nearestSq > outerRadius * outerRadius) continue;
+                // 完全在区块渲染范围内的地砖不需要
+                float farX = std::max(std::fabs(eyeX - minX), std::fabs(eyeX - minX - HORIZON_TILE_SIZE));
+                float farZ = std::max(std::fabs(eyeZ - minZ), std::fabs(eyeZ - minZ - HORIZON_TILE_SIZE));
+                if (farX * farX + farZ * farZ < innerRadius * innerRadius) continue;
+                wanted.push_back(std::make_pair(static_cast<int>(nearestSq), key(tileX, tileZ)));
+            }
+        }
+        std::sort(wanted.begin(), wanted.end());
+
+        // 新进入环带的地砖由近到远生成
+        for (const auto& entry : wanted) {
+            auto inserted = tiles.emplace(entry.second, Tile());
+            Tile& tile = inserted.first->second;
+            tile.lastUsedFrame = frame;
+            if (!inserted.second) continue;
+            if (stats.builds >= HORIZON_MAX_BUILDS_PER_FRAME) {
+                tiles.erase(inserted.first);
+                continue;
+            }
+            int tileX = keyX(entry.second);
+            int tileZ = keyZ(entry.second);
+            tile.signature = signature(tileX * HORIZON_TILE_SIZE, tileZ * HORIZON_TILE_SIZE, static_cast<int>(HORIZON_TILE_SIZE));
+            buildTile(tileX, tileZ, tile, sample);
+            stats.builds++;
+        }
+
+        // 轮流检查已有地砖覆盖的区块列是否变化
+        for (int check = 0; check < HORIZON_CHECKS_PER_FRAME && !wanted.empty(); check++) {
+            if (checkCursor >= wanted.size()) checkCursor = 0;
+            uint64_t tileKey = wanted[checkCursor++].second;
+            auto it = tiles.find(tileKey);
+            if (it == tiles.end()) continue;
+            int tileX = keyX(tileKey);
+            int tileZ = keyZ(tileKey);
+            uint64_t current = signature(tileX * HORIZON_TILE_SIZE, tileZ * HORIZON_TILE_SIZE, static_cast<int>(HORIZON_TILE_SIZE));
+            if (current == it->second.signature) continue;
+            if (stats.builds >= HORIZON_MAX_BUILDS_PER_FRAME) break;
+            it->second.signature = current;
+            buildTile(tileX, tileZ, it->second, sample);
+            stats.builds++;
+        }
+
+        for (auto it = tiles.begin(); it != tiles.end();) {
+            if (frame - it->second.lastUsedFrame > HORIZON_MAX_IDLE_FRAMES) {
+                it = tiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        stats.tiles = static_cast<int>(tiles.size());
+        frame++;
+    }
+
+    // 收集视锥体内、区块渲染范围外的网格，合并后调用一次draw(vertices, quadCount)
+    template <typename Draw>
+    void draw(const Vec3& eye, float innerRadius, const Frustum& frustum, Draw drawQuads) {
+        stats.drawnTiles = 0;
+        stats.drawnQuads = 0;
+        frameVertices.clear();
+        float innerSq = innerRadius * innerRadius;
+        for (const auto& entry : wanted) {
+            auto it = tiles.find(entry.second);
+            if (it == tiles.end() || it->second.vertices.empty()) continue;
+            const Tile& tile = it->second;
+            float minX = static_cast<float>(keyX(entry.second) * HORIZON_TILE_SIZE);
+            float minZ = static_cast<float>(keyZ(entry.second) * HORIZON_TILE_SIZE);
+            if (!frustum.intersectsAABB(Vec3(minX, tile.minY, minZ),
+                                        Vec3(minX + HORIZON_TILE_SIZE, tile.maxY, minZ + HORIZON_TILE_SIZE))) {
+                continue;
+            }
+            size_t before = frameVertices.size();
+            if (static_cast<float>(entry.first) >= innerSq) {
+                frameVertices.insert(frameVertices.end(), tile.vertices.begin(), tile.vertices.end());
+            } else {
+                // 与渲染范围相交的地砖逐个网格判断
+                for (int cell = 0; cell < HORIZON_TILE_CELLS * HORIZON_TILE_CELLS; cell++) {
+                    int quad = tile.cellQuad[cell];
+                    if (quad < 0) continue;
+                    float cellX = minX + (cell % HORIZON_TILE_CELLS) * HORIZON_CELL_SIZE;
+                    float cellZ = minZ + (cell / HORIZON_TILE_CELLS) * HORIZON_CELL_SIZE;
+                    if (rectDistanceSq(eye.x, eye.z, cellX, cellZ, static_cast<float>(HORIZON_CELL_SIZE)) < innerSq) continue;
+                    const VertexPositionColor* first = &tile.vertices[static_cast<size_t>(quad) * 4];
+                    frameVertices.insert(frameVertices.end(), first, first + 4);
+                }
+            }
+            if (frameVertices.size() > before) stats.drawnTiles++;
+        }
+        stats.drawnQuads = static_cast<int>(frameVertices.size() / 4);
+        if (stats.drawnQuads > 0) {
+            drawQuads(frameVertices.data(), stats.drawnQuads);
+        }
+    }
+
+    const HorizonStats& getStats() const {
+        return stats;
+    }
+
+    // 关闭远景或世界重新生成时丢弃所有地砖
+    void clear() {
+        tiles.clear();
+        wanted.clear();
+        frameVertices.clear();
+        checkCursor = 0;
+        stats = HorizonStats();
+    }
+};
+
+#endif // HORIZON_H
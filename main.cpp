@@ -5,6 +5,7 @@
 #include <random>
 #include <chrono>
 #include <string>
+#include <cstring>
 #include <iostream>
 #include "math3d.h"
 #include "camera.h"
@@ -12,6 +13,7 @@
 #include "world.h"
 #include "physics.h"
 #include "ui_manager.h"
+#include "world_save.h"
 
 // 全局变量
 int SCREEN_WIDTH = 1024;
@@ -26,6 +28,10 @@ Renderer renderer;
 World world;
 Camera camera;
 Physics physics; // 物理引擎
+WorldAutosaver autosaver; // 后台自动保存
+const float AUTOSAVE_INTERVAL = 60.0f; // 自动保存间隔（秒）
+float autosaveTimer = 0.0f;
+const int RESIDENCY_KEEP_MARGIN = 2 * CHUNK_SIZE; // 视距外额外保留的常驻范围（方块）
 bool keys[256] = {false};
 bool running = true;
 float deltaTime = 0.0f;
@@ -170,6 +176,12 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 keys['X'] = false; // 防止被processInput处理
             }
             
+            // 处理G键 - 切换贪心合并网格
+            if (wParam == 'G' && uiManager && uiManager->getGameState() == GAME_PLAYING) {
+                world.toggleGreedyMeshing();
+                keys['G'] = false; // 防止被processInput处理
+            }
+            
             // 处理F3键 - 显示/隐藏调试信息
             if (wParam == VK_F3) {
                 if (uiManager) {
@@ -311,13 +323,17 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                         // 完全删除世界并重新初始化
                         world = World();
                         
-                        if (superFlatWorld) {
+                        if (uiManager->getInfiniteWorld()) {
+                            // 世界大小滑块拉到最大时创建无限世界
+                            world.initInfinite(64, seed, superFlatWorld, flatBlockType);
+                        } else if (superFlatWorld) {
                             // 使用超平坦设置初始化世界
                             world.init(worldSize, 64, worldSize, seed, true, flatBlockType);
                         } else {
                             // 使用普通设置初始化世界
                             world.init(worldSize, 64, worldSize, seed);
                         }
+                        uiManager->setWorldInfo(world.getWidth(), world.getHeight(), world.getDepth(), world.getSeed());
                         
                         // 计算生成时间
                         auto endTime = std::chrono::high_resolution_clock::now();
@@ -425,13 +441,14 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 // 简单的射线检测
                 for (float t = 0.0f; t < maxDistance; t += 0.1f) {
                     Vec3 pos = rayStart + rayDir * t;
-                    int blockX = static_cast<int>(pos.x);
-                    int blockY = static_cast<int>(pos.y);
-                    int blockZ = static_cast<int>(pos.z);
+                    int blockX = static_cast<int>(std::floor(pos.x));
+                    int blockY = static_cast<int>(std::floor(pos.y));
+                    int blockZ = static_cast<int>(std::floor(pos.z));
                     
                     // 检查是否在世界范围内
                     if (world.isInBounds(blockX, blockY, blockZ)) {
-                        Block& block = world.getBlock(blockX, blockY, blockZ);
+                        // 只读访问，避免为超平坦世界分配区块列
+                        const Block& block = world.getBlockConst(blockX, blockY, blockZ);
                         if (block.type != BLOCK_AIR && block.isVisible) {
                             // 如果是自定义方块，复制其颜色到编辑器
                             if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
@@ -467,15 +484,16 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 // 简单的射线检测
                 for (float t = 0.0f; t < maxDistance; t += 0.1f) {
                     Vec3 pos = rayStart + rayDir * t;
-                    int blockX = static_cast<int>(pos.x);
-                    int blockY = static_cast<int>(pos.y);
-                    int blockZ = static_cast<int>(pos.z);
+                    int blockX = static_cast<int>(std::floor(pos.x));
+                    int blockY = static_cast<int>(std::floor(pos.y));
+                    int blockZ = static_cast<int>(std::floor(pos.z));
                     
                     // 检查是否在世界范围内
                     if (world.isInBounds(blockX, blockY, blockZ)) {
-                        Block& block = world.getBlock(blockX, blockY, blockZ);
-                        if (block.type != BLOCK_AIR && block.isVisible) {
-                            // 破坏方块（设置为空气）
+                        if (world.getBlockConst(blockX, blockY, blockZ).type != BLOCK_AIR &&
+                            world.getBlockConst(blockX, blockY, blockZ).isVisible) {
+                            // 破坏方块（设置为空气）；确认命中后才取可写引用
+                            Block& block = world.getBlock(blockX, blockY, blockZ);
                             block.type = BLOCK_AIR;
                             block.isVisible = false;
                             // 更新周围方块的可见性，特别是下方方块
@@ -502,22 +520,21 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 // 简单的射线检测
                 for (float t = 0.0f; t < maxDistance; t += 0.1f) {
                     Vec3 pos = rayStart + rayDir * t;
-                    int blockX = static_cast<int>(pos.x);
-                    int blockY = static_cast<int>(pos.y);
-                    int blockZ = static_cast<int>(pos.z);
+                    int blockX = static_cast<int>(std::floor(pos.x));
+                    int blockY = static_cast<int>(std::floor(pos.y));
+                    int blockZ = static_cast<int>(std::floor(pos.z));
                     
                     // 检查是否在世界范围内
                     if (world.isInBounds(blockX, blockY, blockZ)) {
-                        Block& block = world.getBlock(blockX, blockY, blockZ);
+                        const Block& block = world.getBlockConst(blockX, blockY, blockZ);
                         if (block.type != BLOCK_AIR && block.isVisible) {
                             // 找到了一个非空气方块，在上一个位置放置新方块
-                            int lastX = static_cast<int>(lastPos.x);
-                            int lastY = static_cast<int>(lastPos.y);
-                            int lastZ = static_cast<int>(lastPos.z);
+                            int lastX = static_cast<int>(std::floor(lastPos.x));
+                            int lastY = static_cast<int>(std::floor(lastPos.y));
+                            int lastZ = static_cast<int>(std::floor(lastPos.z));
                             
                             if (world.isInBounds(lastX, lastY, lastZ)) {
-                                Block& lastBlock = world.getBlock(lastX, lastY, lastZ);
-                                if (lastBlock.type == BLOCK_AIR) {
+                                if (world.getBlockConst(lastX, lastY, lastZ).type == BLOCK_AIR) {
                                     // 获取当前选中的方块类型
                                     BlockType blockType = uiManager->getCurrentBlockType();
                                     // 只有当选中的方块类型不是BLOCK_AIR时才放置方块
@@ -525,6 +542,8 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                                         // 检查放置方块是否会导致玩家被卡住
                                         Vec3 blockPos(lastX, lastY, lastZ);
                                         if (uiManager->canPlaceBlockAt(blockPos, camera.position, physics.isFlying())) {
+                                            // 确定要放置后才取可写引用（会生成超平坦区块列、标记修改、提升分段修订号）
+                                            Block& lastBlock = world.getBlock(lastX, lastY, lastZ);
                                             // 直接使用选中的方块类型，不需要额外的switch判断
                                             lastBlock.type = blockType;
                                             lastBlock.isVisible = true;
@@ -781,10 +800,13 @@ void cleanup() {
     DeleteObject(hBitmap);
     DeleteDC(hdcMem);
     ReleaseDC(mainWindow, hdc);
+    
+    // 输出还在缓冲区中的跟踪记录并停止后台线程
+    traceShutdown();
 }
 
 // 主函数
-int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance [[maybe_unused]], LPSTR lpCmdLine [[maybe_unused]], int nCmdShow) {
+int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance [[maybe_unused]], LPSTR lpCmdLine, int nCmdShow) {
     // Register window class
     WNDCLASS wc = {};
     wc.lpfnWndProc = WindowProc;
@@ -814,6 +836,12 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance [[maybe_unused]]
     // 设置渲染器的窗口句柄
     renderer.setHWND(mainWindow);
     
+    // -software：不使用GPU，由软件光栅化后端绘制到位图中
+    if (lpCmdLine && strstr(lpCmdLine, "-software")) {
+        renderer.setBackend(std::unique_ptr<RenderBackend>(new SoftwareRenderBackend()));
+        std::cout << "Using software rasterizer" << std::endl;
+    }
+    
     // Initialize renderer and world
     renderer.init(SCREEN_WIDTH, SCREEN_HEIGHT, static_cast<uint32_t*>(pBits));
     
@@ -977,11 +1005,100 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance [[maybe_unused]]
                 
                 uiManager->hasPendingFillCommand = false;
             }
+            
+            // 处理 locate 命令
+            if (uiManager->hasPendingLocateCommand) {
+                World::LocateResult result = world.locateBlock(uiManager->cmdLocateType, camera.position, uiManager->cmdLocateRadius);
+                if (result.found) {
+                    uiManager->addSystemMessage("Nearest " + uiManager->cmdLocateName + " at (" + std::to_string(result.x) + "," +
+                                                std::to_string(result.y) + "," + std::to_string(result.z) + "), " +
+                                                std::to_string(static_cast<int>(result.distance + 0.5f)) + " blocks away");
+                } else {
+                    uiManager->addSystemMessage("No " + uiManager->cmdLocateName + " within " +
+                                                std::to_string(uiManager->cmdLocateRadius * CHUNK_SIZE) + " blocks");
+                }
+                uiManager->addSystemMessage("Searched " + std::to_string(result.sectionsChecked) + " sections, scanned " +
+                                            std::to_string(result.sectionsScanned) + " in " +
+                                            std::to_string(static_cast<int>(result.searchMs)) + " ms");
+                uiManager->hasPendingLocateCommand = false;
+            }
+            
+            // 处理 benchmark 命令
+            if (uiManager->hasPendingBenchmarkCommand) {
+                if (uiManager->cmdBenchmarkName == "apron") {
+                    World::ApronBenchmarkResult result = world.benchmarkApron(camera.position, uiManager->cmdBenchmarkRadius);
+                    uiManager->addSystemMessage("Apron benchmark: " + std::to_string(result.sections) + " sections");
+                    uiManager->addSystemMessage("Accessor " + std::to_string(static_cast<int>(result.accessorMs)) + " ms, apron " +
+                                                std::to_string(static_cast<int>(result.apronMs)) + " ms (copy " +
+                                                std::to_string(static_cast<int>(result.copyMs)) + " ms)" +
+                                                (result.matched ? "" : " - RESULTS DIFFER"));
+                } else if (uiManager->cmdBenchmarkName == "mesh") {
+                    World::MeshBenchmarkResult result = world.benchmarkMesh(camera.position, uiManager->cmdBenchmarkRadius);
+                    uiManager->addSystemMessage("Mesh benchmark: " + std::to_string(result.sections) + " sections, " +
+                                                std::to_string(result.quads) + " quads in " +
+                                                std::to_string(static_cast<int>(result.meshMs)) + " ms");
+                    uiManager->addSystemMessage("Greedy " + std::to_string(result.greedyQuads) + " quads in " +
+                                                std::to_string(static_cast<int>(result.greedyMs)) + " ms (max " +
+                                                std::to_string(static_cast<int>(result.maxGreedySectionMs * 1000.0)) + " us/section)");
+                    uiManager->addSystemMessage(std::string("Exposed faces ") + std::to_string(result.exposedFaces) +
+                                                (result.matched ? ", results match" : " - RESULTS DIFFER"));
+                } else if (uiManager->cmdBenchmarkName == "frustum") {
+                    Renderer::FrustumBenchmarkResult result = renderer.benchmarkFrustum(world, camera, uiManager->cmdBenchmarkRadius);
+                    uiManager->addSystemMessage("Frustum benchmark: " + std::to_string(result.chunks) + " chunks, view cone keeps " +
+                                                std::to_string(result.coneVisible) + " in " +
+                                                std::to_string(static_cast<int>(result.coneMs)) + " ms");
+                    uiManager->addSystemMessage("Planes keep " + std::to_string(result.planeIntersect + result.planeInside) +
+                                                " (" + std::to_string(result.planeInside) + " fully inside), cull " +
+                                                std::to_string(result.planeOutside) + " in " +
+                                                std::to_string(static_cast<int>(result.planeMs)) + " ms" +
+                                                ", " + std::to_string(result.planeOnly) + " kept only by planes");
+                } else if (uiManager->cmdBenchmarkName == "lod") {
+                    World::LodBenchmarkResult result = world.benchmarkLod(camera.position, uiManager->cmdBenchmarkRadius);
+                    uiManager->addSystemMessage("LOD benchmark: " + std::to_string(result.sections) + " sections");
+                    std::string quadsText = "Quads";
+                    for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                        quadsText += " " + std::to_string(1 << lod) + "x " + std::to_string(result.quads[lod]) + " (" +
+                                     std::to_string(static_cast<int>(result.meshMs[lod])) + " ms)";
+                    }
+                    uiManager->addSystemMessage(quadsText + (result.matched ? "" : " - RESULTS DIFFER"));
+                }
+                uiManager->hasPendingBenchmarkCommand = false;
+            }
         }
         
+        // 定期自动保存：主线程只创建快照，写盘在后台线程完成（写完的快照交回主线程释放）
+        autosaver.releaseFinished();
+        autosaveTimer += deltaTime;
+        if (autosaveTimer >= AUTOSAVE_INTERVAL && !autosaver.isBusy()) {
+            autosaver.requestSave(world.createSnapshot());
+            autosaveTimer = 0.0f;
+        }
+        
+        // 无限世界：在相机周围流式加载/卸载区块列
+        world.updateStreaming(camera.position, renderDistance + RESIDENCY_KEEP_MARGIN);
+        
+        // 区块驻留管理：超出内存预算时压缩视距外的分段
+        world.updateResidency(camera.position, static_cast<float>(renderDistance + RESIDENCY_KEEP_MARGIN));
+        
         // 更新UI管理器中的玩家位置，用于相对坐标命令
         if (uiManager) {
             uiManager->updatePlayerPosition(camera.position);
+            uiManager->setResidencyStats(world.getResidencyStats());
+            // 按/multithreading设置开关后台网格生成
+            world.setMeshThreadsEnabled(uiManager->getMultiThreadingEnabled());
+            uiManager->setMeshStats(world.getMeshStats());
+            uiManager->setChunkCacheStats(renderer.getChunkCacheStats());
+            renderer.setCaveCullingEnabled(uiManager->getCaveCullingEnabled());
+            uiManager->setOcclusionStats(renderer.getOcclusionStats());
+            renderer.setOcclusionCullingEnabled(uiManager->getOcclusionCullingEnabled());
+            renderer.setBackfaceCullingEnabled(uiManager->getBackfaceCullingEnabled());
+            renderer.setLodEnabled(uiManager->getLodEnabled());
+            uiManager->setHorizonStats(renderer.getHorizonStats());
+            renderer.setHorizonEnabled(uiManager->getHorizonEnabled());
+            uiManager->setCloudStats(renderer.getCloudStats());
+            if (world.isInfinite()) {
+                uiManager->setStreamingStats(world.getLoadedColumnCount(), world.getPendingColumnCount(), world.getUnloadedColumnCount());
+            }
         }
         
         // Clear screen
@@ -997,8 +1114,16 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance [[maybe_unused]]
         
         // 结束帧渲染
         renderer.endFrame();
+        
+        // 软件光栅化的画面在位图中，需要自己显示到窗口
+        if (renderer.getBackend().WritesFrameBuffer()) {
+            BitBlt(hdc, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, hdcMem, 0, 0, SRCCOPY);
+        }
     }
     
+    // 退出前保存一次世界（析构时会等待后台线程写完）
+    autosaver.requestSave(world.createSnapshot());
+    
     // Clean up resources
     delete uiManager;
     cleanup();
@@ -0,0 +1,271 @@
+#ifndef OCCLUSION_BUFFER_H
+#define OCCLUSION_BUFFER_H
+
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "math3d.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE2 1
+#else
+#define OCCLUSION_USE_SSE2 0
+#endif
+
+// 软件层次Z遮挡剔除
+//
+// 每帧在CPU上维护一张256x128的低分辨率深度图：先把离相机最近的一批实心遮挡盒
+// （分段内完整实心的方块层）光栅化进去，再逐级取2x2最大值生成深度金字塔。
+// 待绘制区块的包围盒投影到屏幕上，在覆盖范围不超过4x4个纹素的那一级比较：
+// 所有纹素记录的最远遮挡深度都比包围盒最近的深度还近时，这个区块被完全挡住，不提交绘制。
+// 两边都取保守值：遮挡盒只写完全被覆盖的像素、深度取盒子最远的角，
+// 被测包围盒的屏幕范围向外取整、深度取最近的角，所以只会少剔除，不会误剔除。
+// 深度用视空间深度（裁剪坐标w），不需要透视除法后的非线性z。
+
+const int OCCLUSION_WIDTH = 256;
+const int OCCLUSION_HEIGHT = 128;
+const int OCCLUSION_MAX_OCCLUDERS = 128;       // 每帧最多光栅化的遮挡盒
+const float OCCLUSION_OCCLUDER_DISTANCE = 96.0f; // 只有这个距离内的分段作为遮挡盒
+
+// 每帧的遮挡剔除统计
+struct OcclusionStats {
+    int occluders = 0; // 光栅化的遮挡盒
+    int tested = 0;    // 测试的区块
+    int culled = 0;    // 被挡住、没有提交绘制的区块
+};
+
+class OcclusionBuffer {
+private:
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::vector<float> depth;
+    };
+    struct ScreenPoint {
+        float x, y;
+    };
+
+    Level levels[8];     // 0级为全分辨率，每级宽高减半（256x128到2x1）
+    int levelCount = 0;
+    Mat4 viewProjection;
+    float nearPlane = 0.1f;
+    bool ready = false;  // 本帧的金字塔是否已生成（没有生成时不剔除任何东西）
+
+    // 顶点变换到裁剪坐标，只需要x、y、w（行向量约定）
+    void project(float x, float y, float z, float& cx, float& cy, float& cw) const {
+        const float (*m)[4] = viewProjection.m;
+        cx = x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0];
+        cy = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
+        cw = x * m[0][3] + y * m[1][3] + z * m[2][3] + m[3][3];
+    }
+
+    // 包围盒的八个角投影到0级像素坐标；有角在近平面之前时返回false
+    bool projectBox(const Vec3& boxMin, const Vec3& boxMax, ScreenPoint points[8], float& minW, float& maxW) const {
+        minW = FLT_MAX;
+        maxW = 0.0f;
+        for (int i = 0; i < 8; i++) {
+            float cx, cy, cw;
+            project((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y, (i & 4) ? boxMax.z : boxMin.z, cx, cy, cw);
+            if (cw < nearPlane) return false;
+            float invW = 1.0f / cw;
+            points[i].x = (cx * invW + 1.0f) * 0.5f * OCCLUSION_WIDTH;
+            points[i].y = (1.0f - cy * invW) * 0.5f * OCCLUSION_HEIGHT;
+            minW = std::min(minW, cw);
+            maxW = std::max(maxW, cw);
+        }
+        return true;
+    }
+
+    // 单调链求凸包（逆时针，屏幕坐标y向下），返回顶点数
+    static int convexHull(ScreenPoint points[8], ScreenPoint hull[16]) {
+        std::sort(points, points + 8, [](const ScreenPoint& a, const ScreenPoint& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        auto cross = [](const ScreenPoint& o, const ScreenPoint& a, const ScreenPoint& b) {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        };
+        int count = 0;
+        for (int i = 0; i < 8; i++) {
+            while (count >= 2 && cross(hull[count - 2], hull[count - 1], points[i]) <= 0.0f) count--;
+            hull[count++] = points[i];
+        }
+        for (int i = 6, lower = count + 1; i >= 0; i--) {
+            while (count >= lower && cross(hull[count - 2], hull[count - 1], points[i]) <= 0.0f) count--;
+            hull[count++] = points[i];
+        }
+        return count - 1;
+    }
+
+public:
+    OcclusionBuffer() {
+        int w = OCCLUSION_WIDTH;
+        int h = OCCLUSION_HEIGHT;
+        while (levelCount < 8 && h >= 1) {
+            levels[levelCount].width = w;
+            levels[levelCount].height = h;
+            levels[levelCount].depth.assign(static_cast<size_t>(w) * h, FLT_MAX);
+            levelCount++;
+            w /= 2;
+            h /= 2;
+        }
+    }
+
+    // 开始新的一帧：清空深度图（FLT_MAX表示没有遮挡）
+    void begin(const Mat4& viewProjectionMatrix, float near) {
+        viewProjection = viewProjectionMatrix;
+        nearPlane = near;
+        std::fill(levels[0].depth.begin(), levels[0].depth.end(), FLT_MAX);
+        ready = false;
+    }
+
+    // 本帧不做遮挡剔除
+    void disable() {
+        ready = false;
+    }
+
+    // 光栅化一个实心遮挡盒，返回是否写入（穿过近平面或太小的盒子跳过）
+    bool addOccluder(const Vec3& boxMin, const Vec3& boxMax) {
+        ScreenPoint points[8];
+        float minW, maxW;
+        if (!projectBox(boxMin, boxMax, points, minW, maxW)) return false;
+
+        ScreenPoint hull[16];
+        int hullCount = convexHull(points, hull);
+        if (hullCount < 3) return false;
+
+        float left = FLT_MAX, right = -FLT_MAX, top = FLT_MAX, bottom = -FLT_MAX;
+        for (int i = 0; i < hullCount; i++) {
+            left = std::min(left, hull[i].x);
+            right = std::max(right, hull[i].x);
+            top = std::min(top, hull[i].y);
+            bottom = std::max(bottom, hull[i].y);
+        }
+        int x0 = std::max(0, static_cast<int>(std::ceil(left - 0.5f)));
+        int x1 = std::min(OCCLUSION_WIDTH - 1, static_cast<int>(std::floor(right - 0.5f)));
+        int y0 = std::max(0, static_cast<int>(std::ceil(top - 0.5f)));
+        int y1 = std::min(OCCLUSION_HEIGHT - 1, static_cast<int>(std::floor(bottom - 0.5f)));
+        if (x0 > x1 || y0 > y1) return false;
+
+        // 边函数 E(x, y) = a*x + b*y + c，凸包内部为正；
+        // 像素中心的值不小于 (|a|+|b|)/2 时整个像素都在边的内侧
+        float edgeA[16], edgeB[16], edgeC[16];
+        for (int i = 0; i < hullCount; i++) {
+            const ScreenPoint& p0 = hull[i];
+            const ScreenPoint& p1 = hull[(i + 1) % hullCount];
+            edgeA[i] = -(p1.y - p0.y);
+            edgeB[i] = p1.x - p0.x;
+            edgeC[i] = -(edgeA[i] * p0.x + edgeB[i] * p0.y) - 0.5f * (std::fabs(edgeA[i]) + std::fabs(edgeB[i]));
+        }
+
+        // 盒子最远的角作为整个遮挡盒的深度
+        float depth = maxW;
+        float* buffer = levels[0].depth.data();
+#if OCCLUSION_USE_SSE2
+        int alignedX0 = x0 & ~3;
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 depthValue = _mm_set1_ps(depth);
+        for (int y = y0; y <= y1; y++) {
+            float py = y + 0.5f;
+            float* row = buffer + y * OCCLUSION_WIDTH;
+            for (int x = alignedX0; x <= x1; x += 4) {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int i = 0; i < hullCount; i++) {
+                    __m128 e = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edgeA[i]), px), _mm_set1_ps(edgeB[i] * py + edgeC[i]));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(e, _mm_setzero_ps()));
+                }
+                if (_mm_movemask_ps(inside) == 0) continue;
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 nearer = _mm_min_ps(old, depthValue);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+            }
+        }
+#else
+        for (int y = y0; y <= y1; y++) {
+            float py = y + 0.5f;
+            float* row = buffer + y * OCCLUSION_WIDTH;
+            for (int x = x0; x <= x1; x++) {
+                float px = x + 0.5f;
+                bool inside = true;
+                for (int i = 0; i < hullCount && inside; i++) {
+                    inside = edgeA[i] * px + edgeB[i] * py + edgeC[i] >= 0.0f;
+                }
+                if (inside && depth < row[x]) row[x] = depth;
+            }
+        }
+#endif
+        return true;
+    }
+
+    // 遮挡盒全部光栅化后调用：逐级取2x2的最大值（最远的遮挡深度）
+    void buildPyramid() {
+        for (int level = 1; level < levelCount; level++) {
+            const Level& src = levels[level - 1];
+            Level& dst = levels[level];
+            for (int y = 0; y < dst.height; y++) {
+                const float* row0 = src.depth.data() + (y * 2) * src.width;
+                const float* row1 = row0 + src.width;
+                float* out = dst.depth.data() + y * dst.width;
+                int x = 0;
+#if OCCLUSION_USE_SSE2
+                // 一次处理源图的8列：先上下两行取最大，再把相邻两列取最大
+                for (; x + 4 <= dst.width; x += 4) {
+                    __m128 a = _mm_max_ps(_mm_loadu_ps(row0 + x * 2), _mm_loadu_ps(row1 + x * 2));
+                    __m128 b = _mm_max_ps(_mm_loadu_ps(row0 + x * 2 + 4), _mm_loadu_ps(row1 + x * 2 + 4));
+                    __m128 even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                    __m128 odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                    _mm_storeu_ps(out + x, _mm_max_ps(even, odd));
+                }
+#endif
+                for (; x < dst.width; x++) {
+                    out[x] = std::max(std::max(row0[x * 2], row0[x * 2 + 1]), std::max(row1[x * 2], row1[x * 2 + 1]));
+                }
+            }
+        }
+        ready = true;
+    }
+
+    // 包围盒是否被已光栅化的遮挡盒完全挡住
+    bool isOccluded(const Vec3& boxMin, const Vec3& boxMax) const {
+        if (!ready) return false;
+        ScreenPoint points[8];
+        float minW, maxW;
+        if (!projectBox(boxMin, boxMax, points, minW, maxW)) return false;
+
+        float left = FLT_MAX, right = -FLT_MAX, top = FLT_MAX, bottom = -FLT_MAX;
+        for (int i = 0; i < 8; i++) {
+            left = std::min(left, points[i].x);
+            right = std::max(right, points[i].x);
+            top = std::min(top, points[i].y);
+            bottom = std::max(bottom, points[i].y);
+        }
+        // 覆盖到的像素（向外取整），裁到屏幕内；整个在屏幕外的交给视锥体剔除
+        int x0 = std::max(0, static_cast<int>(std::floor(left)));
+        int x1 = std::min(OCCLUSION_WIDTH - 1, static_cast<int>(std::floor(right)));
+        int y0 = std::max(0, static_cast<int>(std::floor(top)));
+        int y1 = std::min(OCCLUSION_HEIGHT - 1, static_cast<int>(std::floor(bottom)));
+        if (x0 > x1 || y0 > y1) return false;
+
+        // 选覆盖范围不超过4x4个纹素的一级
+        int level = 0;
+        while (level + 1 < levelCount && (((x1 >> level) - (x0 >> level)) >= 4 || ((y1 >> level) - (y0 >> level)) >= 4)) {
+            level++;
+        }
+        const Level& mip = levels[level];
+        for (int y = y0 >> level; y <= (y1 >> level); y++) {
+            const float* row = mip.depth.data() + y * mip.width;
+            for (int x = x0 >> level; x <= (x1 >> level); x++) {
+                if (row[x] >= minW) return false;
+            }
+        }
+        return true;
+    }
+
+    bool isReady() const {
+        return ready;
+    }
+};
+
+#endif // OCCLUSION_BUFFER_H
@@ -0,0 +1,354 @@
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <memory>
+#include "math3d.h"
+
+// 渲染后端接口
+//
+// Renderer和World::renderWorld只通过这个接口提交绘制：帧开始/结束、变换矩阵、
+// 分段网格批次、单个方块面、2D图元和文字。GPURenderer（Direct3D 9）是默认实现；
+// 另外提供两个不依赖图形API的实现，用于没有GPU的机器上运行帧管线：
+//   NullRenderBackend      只统计绘制调用和三角形数
+//   RecordingRenderBackend 记录每一帧的绘制命令流，可比较两帧/两个版本的剔除与合批结果
+// GPURenderer的状态缓存与合批队列见render_command_queue.h（其中的BatchedRecordingBackend是它的无GPU替身）。
+// 本头文件只依赖math3d.h，不包含任何Windows/Direct3D头文件。
+// 注意：<windows.h>会把DrawText定义成DrawTextA，因此与GPURenderer一起使用时
+// 需要在本文件之前包含<windows.h>（render_gpu.h已经保证了这一点）。
+
+// 顶点结构（颜色为ARGB，与D3DCOLOR布局相同）
+struct VertexPositionColor {
+    float x, y, z;    // 位置
+    uint32_t color;   // 颜色
+};
+
+// 按ARGB打包颜色（等价于D3DCOLOR_RGBA）
+inline uint32_t packVertexColor(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return ((a & 0xFF) << 24) | ((r & 0xFF) << 16) | ((g & 0xFF) << 8) | (b & 0xFF);
+}
+
+// 状态缓存与合批统计（每帧）
+struct RenderBatchStats {
+    int drawRequests = 0;  // 收到的绘制（逐面、逐批次提交时的绘制调用数）
+    int drawSubmits = 0;   // 合批后实际提交给设备的绘制调用数
+    int stateRequests = 0; // 逐次绘制时需要设置的状态数（渲染状态、世界矩阵、顶点格式）
+    int stateChanges = 0;  // 经过状态缓存过滤后实际提交给设备的状态数
+};
+
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+
+    // 后端名称（调试输出用）
+    virtual const char* GetName() const = 0;
+
+    virtual void Resize(int width, int height) = 0;
+
+    // 设置CPU帧缓冲（只有在CPU上绘制的后端会写入它）
+    virtual void SetFrameBuffer(uint32_t* pixels [[maybe_unused]], int width [[maybe_unused]], int height [[maybe_unused]]) {}
+
+    // EndScene之后帧缓冲中是否是完整的画面（需要由窗口自行显示）
+    virtual bool WritesFrameBuffer() const { return false; }
+
+    // 帧开始（清屏）与结束（呈现）
+    virtual bool BeginScene(const Color& clearColor) = 0;
+    virtual void EndScene() = 0;
+
+    // 变换矩阵
+    virtual void SetTransform(const Mat4& viewMatrix, const Mat4& projectionMatrix) = 0;
+    virtual void SetWorldMatrix(const Mat4& worldMatrix) = 0;
+
+    // 单个方块面（X-ray模式逐方块绘制）
+    virtual void DrawBlockFace(const Vec3& position, int face, const Color& color) = 0;
+
+    // 网格批次：每4个顶点一个四边形，共用quadIndices索引模式，超过maxQuadsPerBatch时分批
+    virtual void DrawQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                              int maxQuadsPerBatch, bool alphaBlend) = 0;
+
+    // 云层网格：与DrawQuadMesh相同的顶点布局，混合、测试深度但不写入深度
+    virtual void DrawCloudMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                               int maxQuadsPerBatch) = 0;
+
+    // 世界空间中的半透明四边形（太阳）
+    virtual void DrawSun(Vec3 vertices[4], const Color& color) = 0;
+
+    // 2D图元与文字（屏幕坐标）
+    virtual void DrawLine(int x1, int y1, int x2, int y2, const Color& color) = 0;
+    virtual void DrawRect(int x, int y, int width, int height, const Color& color) = 0;
+    virtual void DrawRectOutline(int x, int y, int width, int height, const Color& color) = 0;
+    virtual void DrawText(int x, int y, const std::string& text, const Color& color) = 0;
+
+    // 渲染统计
+    virtual int GetTrianglesRendered() const = 0;
+    virtual int GetDrawCalls() const = 0;
+
+    // 上一帧的状态缓存与合批统计（不做合批的后端全部为0）
+    virtual RenderBatchStats GetBatchStats() const { return RenderBatchStats(); }
+};
+
+// 空后端：不绘制任何东西，只统计每帧的绘制调用和三角形数
+class NullRenderBackend : public RenderBackend {
+protected:
+    int trianglesRendered = 0;
+    int drawCalls = 0;
+
+public:
+    const char* GetName() const override { return "Null"; }
+
+    void Resize(int width [[maybe_unused]], int height [[maybe_unused]]) override {}
+
+    bool BeginScene(const Color& clearColor [[maybe_unused]]) override {
+        trianglesRendered = 0;
+        drawCalls = 0;
+        return true;
+    }
+
+    void EndScene() override {}
+
+    void SetTransform(const Mat4& viewMatrix [[maybe_unused]], const Mat4& projectionMatrix [[maybe_unused]]) override {}
+    void SetWorldMatrix(const Mat4& worldMatrix [[maybe_unused]]) override {}
+
+    void DrawBlockFace(const Vec3& position [[maybe_unused]], int face [[maybe_unused]], const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+        trianglesRendered += 2;
+    }
+
+    void DrawQuadMesh(const VertexPositionColor* vertices [[maybe_unused]], int quadCount,
+                      const uint16_t* quadIndices [[maybe_unused]], int maxQuadsPerBatch,
+                      bool alphaBlend [[maybe_unused]]) override {
+        if (quadCount <= 0) return;
+        drawCalls += (quadCount + maxQuadsPerBatch - 1) / maxQuadsPerBatch;
+        trianglesRendered += quadCount * 2;
+    }
+
+    void DrawCloudMesh(const VertexPositionColor* vertices [[maybe_unused]], int quadCount,
+                       const uint16_t* quadIndices [[maybe_unused]], int maxQuadsPerBatch) override {
+        if (quadCount <= 0) return;
+        drawCalls += (quadCount + maxQuadsPerBatch - 1) / maxQuadsPerBatch;
+        trianglesRendered += quadCount * 2;
+    }
+
+    void DrawSun(Vec3 vertices[4] [[maybe_unused]], const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+        trianglesRendered += 2;
+    }
+
+    void DrawLine(int x1 [[maybe_unused]], int y1 [[maybe_unused]], int x2 [[maybe_unused]], int y2 [[maybe_unused]],
+                  const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+    }
+
+    void DrawRect(int x [[maybe_unused]], int y [[maybe_unused]], int width [[maybe_unused]], int height [[maybe_unused]],
+                  const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+        trianglesRendered += 2;
+    }
+
+    void DrawRectOutline(int x [[maybe_unused]], int y [[maybe_unused]], int width [[maybe_unused]], int height [[maybe_unused]],
+                         const Color& color [[maybe_unused]]) override {
+        drawCalls += 4;
+    }
+
+    void DrawText(int x [[maybe_unused]], int y [[maybe_unused]], const std::string& text [[maybe_unused]],
+                  const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+    }
+
+    int GetTrianglesRendered() const override { return trianglesRendered; }
+    int GetDrawCalls() const override { return drawCalls; }
+};
+
+// 记录的绘制命令类型
+enum RenderCommandType {
+    RENDER_CMD_BEGIN_SCENE,
+    RENDER_CMD_SET_TRANSFORM,
+    RENDER_CMD_SET_WORLD_MATRIX,
+    RENDER_CMD_BLOCK_FACE,
+    RENDER_CMD_QUAD_MESH,
+    RENDER_CMD_CLOUD_MESH,
+    RENDER_CMD_SUN,
+    RENDER_CMD_LINE,
+    RENDER_CMD_RECT,
+    RENDER_CMD_RECT_OUTLINE,
+    RENDER_CMD_TEXT
+};
+
+// 一条记录下来的绘制命令
+struct RenderCommand {
+    RenderCommandType type;
+    int count = 0;             // 网格为四边形数，方块面为面编号
+    bool alphaBlend = false;
+    int rect[4] = {0, 0, 0, 0}; // 2D图元的坐标/尺寸
+    Vec3 position;             // 方块面位置、四边形第一个顶点
+    uint32_t color = 0;        // ARGB
+    uint64_t dataHash = 0;     // 顶点数据、矩阵或文字内容的哈希
+    std::string text;
+};
+
+// 录制后端：把每一帧的绘制命令流保存下来（在NullRenderBackend的统计之上）
+// 网格批次只保存四边形数和顶点哈希，不复制顶点；BeginScene开始新的一帧，
+// EndScene之后上一帧的命令可通过getLastFrame()读取。
+class RecordingRenderBackend : public NullRenderBackend {
+private:
+    std::vector<RenderCommand> current;
+    std::vector<RenderCommand> lastFrame;
+    int frames = 0;
+
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    RenderCommand& record(RenderCommandType type, const Color& color) {
+        current.push_back(RenderCommand());
+        RenderCommand& command = current.back();
+        command.type = type;
+        command.color = color.toUint32();
+        return command;
+    }
+
+    RenderCommand& recordRect(RenderCommandType type, int x, int y, int w, int h, const Color& color) {
+        RenderCommand& command = record(type, color);
+        command.rect[0] = x;
+        command.rect[1] = y;
+        command.rect[2] = w;
+        command.rect[3] = h;
+        return command;
+    }
+
+public:
+    const char* GetName() const override { return "Recording"; }
+
+    bool BeginScene(const Color& clearColor) override {
+        NullRenderBackend::BeginScene(clearColor);
+        current.clear();
+        record(RENDER_CMD_BEGIN_SCENE, clearColor);
+        return true;
+    }
+
+    void EndScene() override {
+        lastFrame.swap(current);
+        current.clear();
+        frames++;
+    }
+
+    void SetTransform(const Mat4& viewMatrix, const Mat4& projectionMatrix) override {
+        RenderCommand& command = record(RENDER_CMD_SET_TRANSFORM, Color());
+        command.dataHash = hashBytes(projectionMatrix.m, sizeof(projectionMatrix.m), hashBytes(viewMatrix.m, sizeof(viewMatrix.m)));
+    }
+
+    void SetWorldMatrix(const Mat4& worldMatrix) override {
+        RenderCommand& command = record(RENDER_CMD_SET_WORLD_MATRIX, Color());
+        command.dataHash = hashBytes(worldMatrix.m, sizeof(worldMatrix.m));
+    }
+
+    void DrawBlockFace(const Vec3& position, int face, const Color& color) override {
+        NullRenderBackend::DrawBlockFace(position, face, color);
+        RenderCommand& command = record(RENDER_CMD_BLOCK_FACE, color);
+        command.count = face;
+        command.position = position;
+        command.alphaBlend = color.a < 255;
+        const float faceData[4] = { position.x, position.y, position.z, static_cast<float>(face) };
+        command.dataHash = hashBytes(faceData, sizeof(faceData));
+    }
+
+    void DrawQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                      int maxQuadsPerBatch, bool alphaBlend) override {
+        if (quadCount <= 0) return;
+        NullRenderBackend::DrawQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch, alphaBlend);
+        RenderCommand& command = record(RENDER_CMD_QUAD_MESH, Color());
+        command.count = quadCount;
+        command.alphaBlend = alphaBlend;
+        command.position = Vec3(vertices[0].x, vertices[0].y, vertices[0].z);
+        command.dataHash = hashBytes(vertices, sizeof(VertexPositionColor) * static_cast<size_t>(quadCount) * 4);
+    }
+
+    void DrawCloudMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                       int maxQuadsPerBatch) override {
+        if (quadCount <= 0) return;
+        NullRenderBackend::DrawCloudMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch);
+        RenderCommand& command = record(RENDER_CMD_CLOUD_MESH, Color());
+        command.count = quadCount;
+        command.alphaBlend = true;
+        command.position = Vec3(vertices[0].x, vertices[0].y, vertices[0].z);
+        command.dataHash = hashBytes(vertices, sizeof(VertexPositionColor) * static_cast<size_t>(quadCount) * 4);
+    }
+
+    void DrawSun(Vec3 vertices[4], const Color& color) override {
+        NullRenderBackend::DrawSun(vertices, color);
+        RenderCommand& command = record(RENDER_CMD_SUN, color);
+        command.position = vertices[0];
+        command.alphaBlend = true;
+        command.dataHash = hashBytes(vertices, sizeof(Vec3) * 4);
+    }
+
+    void DrawLine(int x1, int y1, int x2, int y2, const Color& color) override {
+        NullRenderBackend::DrawLine(x1, y1, x2, y2, color);
+        recordRect(RENDER_CMD_LINE, x1, y1, x2, y2, color);
+    }
+
+    void DrawRect(int x, int y, int width, int height, const Color& color) override {
+        NullRenderBackend::DrawRect(x, y, width, height, color);
+        recordRect(RENDER_CMD_RECT, x, y, width, height, color);
+    }
+
+    void DrawRectOutline(int x, int y, int width, int height, const Color& color) override {
+        NullRenderBackend::DrawRectOutline(x, y, width, height, color);
+        recordRect(RENDER_CMD_RECT_OUTLINE, x, y, width, height, color);
+    }
+
+    void DrawText(int x, int y, const std::string& text, const Color& color) override {
+        NullRenderBackend::DrawText(x, y, text, color);
+        RenderCommand& command = recordRect(RENDER_CMD_TEXT, x, y, 0, 0, color);
+        command.text = text;
+        command.dataHash = hashBytes(text.data(), text.size());
+    }
+
+    // 上一帧（最近一次EndScene之前）记录的命令
+    const std::vector<RenderCommand>& getLastFrame() const {
+        return lastFrame;
+    }
+
+    // 正在记录的当前帧命令
+    const std::vector<RenderCommand>& getCurrentFrame() const {
+        return current;
+    }
+
+    int getFrameCount() const {
+        return frames;
+    }
+
+    // 上一帧命令流的哈希（顺序敏感），用于比较两次运行的绘制结果
+    uint64_t getLastFrameHash() const {
+        uint64_t hash = 14695981039346656037ULL;
+        for (const RenderCommand& command : lastFrame) {
+            hash = hashBytes(&command.type, sizeof(command.type), hash);
+            hash = hashBytes(&command.count, sizeof(command.count), hash);
+            hash = hashBytes(&command.alphaBlend, sizeof(command.alphaBlend), hash);
+            hash = hashBytes(command.rect, sizeof(command.rect), hash);
+            hash = hashBytes(&command.color, sizeof(command.color), hash);
+            const float position[3] = { command.position.x, command.position.y, command.position.z };
+            hash = hashBytes(position, sizeof(position), hash);
+            hash = hashBytes(&command.dataHash, sizeof(command.dataHash), hash);
+        }
+        return hash;
+    }
+
+    // 上一帧中某类命令的数量
+    int countLastFrame(RenderCommandType type) const {
+        int count = 0;
+        for (const RenderCommand& command : lastFrame) {
+            if (command.type == type) count++;
+        }
+        return count;
+    }
+};
+
+#endif // RENDER_BACKEND_H
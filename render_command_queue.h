@@ -0,0 +1,535 @@
+#ifndef RENDER_COMMAND_QUEUE_H
+#define RENDER_COMMAND_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "math3d.h"
+#include "render_backend.h"
+
+// 渲染状态缓存与按排序键合批的绘制命令队列
+//
+// 以前GPURenderer每画一个方块面都要重新设置深度、剔除、世界矩阵、混合和顶点格式，
+// 再单独调用一次DrawPrimitiveUP。现在三维世界的绘制（方块面、分段网格、云）先记录到队列里，
+// 到下一次需要刷新时（换变换矩阵、画太阳/2D图元、帧结束）按64位排序键
+// （遍、混合状态、视空间深度、提交序号）排序，相同状态的方块面合并成一次索引绘制。
+// 所有状态都经过缓存：和设备上当前值相同的设置直接丢弃。
+// 本头文件不依赖Direct3D：设备层由RenderDevice抽象，GPURenderer和无GPU的录制替身
+// （BatchedRecordingBackend）用同一套队列，可以在没有显卡的机器上统计被省掉的状态和绘制。
+// 注意：分段网格只记录顶点指针，指针在队列刷新之前必须保持有效（网格缓存在帧内不会移动）。
+
+// 缓存的渲染状态（取值与Direct3D 9相同，GPURenderer按表映射到D3DRS_*）
+enum RenderStateId {
+    RENDER_STATE_ZENABLE = 0,
+    RENDER_STATE_ZWRITEENABLE,
+    RENDER_STATE_CULLMODE,
+    RENDER_STATE_ALPHABLENDENABLE,
+    RENDER_STATE_SRCBLEND,
+    RENDER_STATE_DESTBLEND,
+    RENDER_STATE_COUNT
+};
+
+const uint32_t RENDER_CULL_NONE = 1;          // D3DCULL_NONE
+const uint32_t RENDER_BLEND_SRCALPHA = 5;     // D3DBLEND_SRCALPHA
+const uint32_t RENDER_BLEND_INVSRCALPHA = 6;  // D3DBLEND_INVSRCALPHA
+
+// 混合状态（排序键的一部分，相同混合状态的绘制排在一起）
+enum RenderBlendState {
+    RENDER_BLEND_OPAQUE = 0,          // 不混合
+    RENDER_BLEND_ALPHA = 1,           // SRCALPHA / INVSRCALPHA
+    RENDER_BLEND_ALPHA_NO_DEPTH_WRITE // 同上，不写深度（云）
+};
+
+// 一次合批最多的四边形数（16位索引）
+const int RENDER_QUEUE_MAX_BATCH_QUADS = 65536 / 4;
+
+// 单位方块各面的四个角（与分段网格、软件光栅化的顶点顺序一致）和朝向亮度
+const uint8_t BLOCK_FACE_CORNERS[6][4][3] = {
+    { {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1} }, // FACE_FRONT (Z+)
+    { {1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0} }, // FACE_BACK (Z-)
+    { {0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0} }, // FACE_LEFT (X-)
+    { {1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1} }, // FACE_RIGHT (X+)
+    { {0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0} }, // FACE_TOP (Y+)
+    { {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1} }  // FACE_BOTTOM (Y-)
+};
+const float BLOCK_FACE_SHADE[6] = { 0.8f, 0.8f, 0.7f, 0.7f, 1.0f, 0.6f };
+
+// 方块面的四个顶点（世界坐标，颜色按朝向调暗）
+inline void buildBlockFaceVertices(const Vec3& position, int face, const Color& color, VertexPositionColor out[4]) {
+    float shade = BLOCK_FACE_SHADE[face];
+    uint32_t faceColor = packVertexColor(static_cast<uint8_t>(color.r * shade), static_cast<uint8_t>(color.g * shade),
+                                         static_cast<uint8_t>(color.b * shade), color.a);
+    for (int corner = 0; corner < 4; corner++) {
+        const uint8_t* offset = BLOCK_FACE_CORNERS[face][corner];
+        out[corner].x = position.x + offset[0];
+        out[corner].y = position.y + offset[1];
+        out[corner].z = position.z + offset[2];
+        out[corner].color = faceColor;
+    }
+}
+
+inline bool isIdentityMatrix(const Mat4& matrix) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (matrix.m[i][j] != (i == j ? 1.0f : 0.0f)) return false;
+        }
+    }
+    return true;
+}
+
+// 设备层：实际执行状态设置和绘制
+class RenderDevice {
+public:
+    virtual ~RenderDevice() {}
+    virtual void ApplyRenderState(RenderStateId state, uint32_t value) = 0;
+    virtual void ApplyIdentityWorld() = 0;
+    virtual void ApplyVertexFormat() = 0;
+    // 每4个顶点一个四边形，quadIndices为共用的索引模式
+    virtual void DrawIndexedQuads(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices) = 0;
+};
+
+// 设备状态的影子副本：只有和设备上当前值不同的设置才需要提交
+class RenderStateCache {
+private:
+    uint32_t values[RENDER_STATE_COUNT] = {};
+    uint32_t knownStates = 0;     // 哪些状态的值已知（第i位对应RenderStateId i）
+    bool worldIsIdentity = false; // 设备上的世界矩阵已知是单位矩阵
+    bool vertexFormatSet = false; // 设备上的顶点格式已知是VertexPositionColor
+    int requests = 0;
+    int changes = 0;
+
+public:
+    // 返回是否需要提交给设备
+    bool set(RenderStateId state, uint32_t value) {
+        requests++;
+        uint32_t bit = 1u << state;
+        if ((knownStates & bit) && values[state] == value) return false;
+        values[state] = value;
+        knownStates |= bit;
+        changes++;
+        return true;
+    }
+
+    bool setIdentityWorld() {
+        requests++;
+        if (worldIsIdentity) return false;
+        worldIsIdentity = true;
+        changes++;
+        return true;
+    }
+
+    bool setVertexFormat() {
+        requests++;
+        if (vertexFormatSet) return false;
+        vertexFormatSet = true;
+        changes++;
+        return true;
+    }
+
+    // 世界矩阵被设成了任意矩阵（总是提交）
+    void worldChanged() {
+        requests++;
+        changes++;
+        worldIsIdentity = false;
+    }
+
+    // 设备状态被缓存之外的代码改动（设备重置、D3DX字体、保存/恢复变换的2D绘制）
+    void invalidate() {
+        knownStates = 0;
+        worldIsIdentity = false;
+        vertexFormatSet = false;
+    }
+
+    int getRequests() const { return requests; }
+    int getChanges() const { return changes; }
+
+    void resetCounters() {
+        requests = 0;
+        changes = 0;
+    }
+};
+
+class DrawCommandQueue {
+private:
+    struct Command {
+        uint64_t key = 0;
+        const VertexPositionColor* vertices = nullptr; // 网格的顶点（方块面为空，顶点在faceVertices中）
+        size_t faceOffset = 0;                         // 方块面在faceVertices中的位置
+        int quadCount = 0;
+        const uint16_t* quadIndices = nullptr;
+        int maxQuadsPerBatch = 0;
+        RenderBlendState blend = RENDER_BLEND_OPAQUE;
+    };
+
+    // 三维世界绘制需要的状态数（深度、深度写入、剔除、混合开关、世界矩阵、顶点格式，混合时再加两个混合因子）
+    enum { WORLD_STATE_COUNT = 6, BLEND_FACTOR_COUNT = 2 };
+
+    std::vector<Command> commands;
+    std::vector<VertexPositionColor> faceVertices;
+    std::vector<VertexPositionColor> batchVertices;
+    std::vector<uint16_t> quadIndexPattern;
+    RenderStateCache stateCache;
+    Mat4 viewMatrix;
+    uint32_t sequence = 0;
+    int drawRequests = 0;
+    int drawSubmits = 0;
+    int mergedStateRequests = 0; // 合批后不再需要逐次设置的状态数
+    RenderBatchStats lastFrameStats;
+
+    // 点的视空间深度（视图矩阵第三列）
+    float viewDepth(float x, float y, float z) const {
+        const float (*m)[4] = viewMatrix.m;
+        return x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
+    }
+
+    // 排序键：[63]遍（半透明在后） [62..59]混合状态 [58..27]深度 [26..0]提交序号
+    // 不透明的深度升序（由近到远），半透明的深度取反（由远到近）；非负浮点数的位模式与大小顺序一致
+    uint64_t makeKey(RenderBlendState blend, float depth) {
+        bool transparent = blend != RENDER_BLEND_OPAQUE;
+        uint32_t depthBits;
+        depth = std::max(0.0f, depth);
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+        if (transparent) depthBits = ~depthBits;
+        return (static_cast<uint64_t>(transparent ? 1 : 0) << 63) | (static_cast<uint64_t>(blend) << 59) |
+               (static_cast<uint64_t>(depthBits) << 27) | (sequence++ & 0x7FFFFFF);
+    }
+
+    void applyWorldStates(RenderDevice& device, RenderBlendState blend) {
+        bool alphaBlend = blend != RENDER_BLEND_OPAQUE;
+        applyState(device, RENDER_STATE_ZENABLE, 1);
+        applyState(device, RENDER_STATE_ZWRITEENABLE, blend == RENDER_BLEND_ALPHA_NO_DEPTH_WRITE ? 0 : 1);
+        applyState(device, RENDER_STATE_CULLMODE, RENDER_CULL_NONE);
+        applyIdentityWorld(device);
+        applyState(device, RENDER_STATE_ALPHABLENDENABLE, alphaBlend ? 1 : 0);
+        if (alphaBlend) {
+            applyState(device, RENDER_STATE_SRCBLEND, RENDER_BLEND_SRCALPHA);
+            applyState(device, RENDER_STATE_DESTBLEND, RENDER_BLEND_INVSRCALPHA);
+        }
+        applyVertexFormat(device);
+    }
+
+    void submitFaceBatch(RenderDevice& device, RenderBlendState blend, int faceDraws) {
+        int quads = static_cast<int>(batchVertices.size() / 4);
+        if (quads == 0) return;
+        applyWorldStates(device, blend);
+        device.DrawIndexedQuads(batchVertices.data(), quads, quadIndexPattern.data());
+        drawSubmits++;
+        mergedStateRequests += (faceDraws - 1) * (WORLD_STATE_COUNT + (blend != RENDER_BLEND_OPAQUE ? BLEND_FACTOR_COUNT : 0));
+        batchVertices.clear();
+    }
+
+public:
+    DrawCommandQueue() {
+        quadIndexPattern.resize(static_cast<size_t>(RENDER_QUEUE_MAX_BATCH_QUADS) * 6);
+        for (int q = 0; q < RENDER_QUEUE_MAX_BATCH_QUADS; q++) {
+            uint16_t base = static_cast<uint16_t>(q * 4);
+            uint16_t* index = &quadIndexPattern[static_cast<size_t>(q) * 6];
+            index[0] = base; index[1] = base + 1; index[2] = base + 2;
+            index[3] = base; index[4] = base + 2; index[5] = base + 3;
+        }
+    }
+
+    RenderStateCache& getStateCache() {
+        return stateCache;
+    }
+
+    // 经过缓存设置一个渲染状态
+    void applyState(RenderDevice& device, RenderStateId state, uint32_t value) {
+        if (stateCache.set(state, value)) device.ApplyRenderState(state, value);
+    }
+
+    void applyIdentityWorld(RenderDevice& device) {
+        if (stateCache.setIdentityWorld()) device.ApplyIdentityWorld();
+    }
+
+    void applyVertexFormat(RenderDevice& device) {
+        if (stateCache.setVertexFormat()) device.ApplyVertexFormat();
+    }
+
+    // 用于计算排序深度的视图矩阵（SetTransform时设置，设置前应先刷新队列）
+    void setViewMatrix(const Mat4& view) {
+        viewMatrix = view;
+    }
+
+    // 记录一个四边形（方块面或云面，4个顶点）
+    void addFace(const VertexPositionColor quad[4], RenderBlendState blend) {
+        Command command;
+        command.faceOffset = faceVertices.size();
+        command.quadCount = 1;
+        command.blend = blend;
+        faceVertices.insert(faceVertices.end(), quad, quad + 4);
+        command.key = makeKey(blend, viewDepth((quad[0].x + quad[2].x) * 0.5f, (quad[0].y + quad[2].y) * 0.5f,
+                                                    (quad[0].z + quad[2].z) * 0.5f));
+        commands.push_back(command);
+        drawRequests++;
+    }
+
+    // 记录一个分段网格或云层网格（深度取首尾两个四边形的中点，近似网格中心）
+    void addQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                     int maxQuadsPerBatch, RenderBlendState blend) {
+        if (quadCount <= 0) return;
+        Command command;
+        command.vertices = vertices;
+        command.quadCount = quadCount;
+        command.quadIndices = quadIndices;
+        command.maxQuadsPerBatch = maxQuadsPerBatch;
+        command.blend = blend;
+        const VertexPositionColor& first = vertices[0];
+        const VertexPositionColor& last = vertices[static_cast<size_t>(quadCount) * 4 - 2];
+        command.key = makeKey(command.blend, viewDepth((first.x + last.x) * 0.5f, (first.y + last.y) * 0.5f,
+                                                    (first.z + last.z) * 0.5f));
+        commands.push_back(command);
+        drawRequests += (quadCount + maxQuadsPerBatch - 1) / maxQuadsPerBatch;
+    }
+
+    bool empty() const {
+        return commands.empty();
+    }
+
+    // 按排序键提交所有记录的绘制：相邻的同状态方块面合并成一次绘制
+    void flush(RenderDevice& device) {
+        if (commands.empty()) return;
+        std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) { return a.key < b.key; });
+
+        RenderBlendState batchBlend = RENDER_BLEND_OPAQUE;
+        int batchFaces = 0;
+        for (const Command& command : commands) {
+            if (!command.vertices) {
+                if (batchFaces > 0 && (command.blend != batchBlend ||
+                                       static_cast<int>(batchVertices.size() / 4) >= RENDER_QUEUE_MAX_BATCH_QUADS)) {
+                    submitFaceBatch(device, batchBlend, batchFaces);
+                    batchFaces = 0;
+                }
+                batchBlend = command.blend;
+                batchVertices.insert(batchVertices.end(), faceVertices.begin() + command.faceOffset,
+                                     faceVertices.begin() + command.faceOffset + 4);
+                batchFaces++;
+                continue;
+            }
+
+            if (batchFaces > 0) {
+                submitFaceBatch(device, batchBlend, batchFaces);
+                batchFaces = 0;
+            }
+            applyWorldStates(device, command.blend);
+            for (int first = 0; first < command.quadCount; first += command.maxQuadsPerBatch) {
+                int count = std::min(command.maxQuadsPerBatch, command.quadCount - first);
+                device.DrawIndexedQuads(command.vertices + static_cast<size_t>(first) * 4, count, command.quadIndices);
+                drawSubmits++;
+            }
+        }
+        if (batchFaces > 0) {
+            submitFaceBatch(device, batchBlend, batchFaces);
+        }
+
+        commands.clear();
+        faceVertices.clear();
+    }
+
+    // 帧开始：设备状态未知，清空统计
+    void beginFrame() {
+        commands.clear();
+        faceVertices.clear();
+        stateCache.invalidate();
+        stateCache.resetCounters();
+        sequence = 0;
+        drawRequests = 0;
+        drawSubmits = 0;
+        mergedStateRequests = 0;
+    }
+
+    // 帧结束（应先flush）：发布本帧统计
+    void endFrame() {
+        lastFrameStats.drawRequests = drawRequests;
+        lastFrameStats.drawSubmits = drawSubmits;
+        lastFrameStats.stateRequests = stateCache.getRequests() + mergedStateRequests;
+        lastFrameStats.stateChanges = stateCache.getChanges();
+    }
+
+    const RenderBatchStats& getStats() const {
+        return lastFrameStats;
+    }
+};
+
+// GPURenderer的无GPU替身：三维世界的绘制走与GPURenderer相同的队列和状态缓存，
+// 设备层只记录调用，用来在没有显卡的机器上验证合批省掉了多少状态设置和绘制调用。
+// 太阳按GPURenderer的状态设置方式经过缓存；2D图元之后状态按未知处理（与GPURenderer一致）。
+class BatchedRecordingBackend : public NullRenderBackend, private RenderDevice {
+public:
+    // 记录的设备调用
+    struct DeviceCall {
+        enum Type { RENDER_STATE, IDENTITY_WORLD, WORLD_MATRIX, VERTEX_FORMAT, DRAW } type;
+        int state = 0;
+        uint32_t value = 0;
+        int quadCount = 0;
+    };
+
+private:
+    DrawCommandQueue queue;
+    std::vector<DeviceCall> currentCalls;
+    std::vector<DeviceCall> lastFrameCalls;
+    uint64_t quadChecksum = 0; // 提交的所有顶点的和校验（与提交顺序无关）
+    uint64_t lastQuadChecksum = 0;
+    int submittedQuads = 0;
+    int lastSubmittedQuads = 0;
+
+    void ApplyRenderState(RenderStateId state, uint32_t value) override {
+        DeviceCall call;
+        call.type = DeviceCall::RENDER_STATE;
+        call.state = state;
+        call.value = value;
+        currentCalls.push_back(call);
+    }
+
+    void ApplyIdentityWorld() override {
+        DeviceCall call;
+        call.type = DeviceCall::IDENTITY_WORLD;
+        currentCalls.push_back(call);
+    }
+
+    void ApplyVertexFormat() override {
+        DeviceCall call;
+        call.type = DeviceCall::VERTEX_FORMAT;
+        currentCalls.push_back(call);
+    }
+
+    void DrawIndexedQuads(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices [[maybe_unused]]) override {
+        DeviceCall call;
+        call.type = DeviceCall::DRAW;
+        call.quadCount = quadCount;
+        currentCalls.push_back(call);
+        for (int i = 0; i < quadCount * 4; i++) {
+            uint32_t bits[3];
+            std::memcpy(bits, &vertices[i], sizeof(bits));
+            quadChecksum += (static_cast<uint64_t>(bits[0]) * 31 + bits[1]) * 31 + bits[2] + vertices[i].color;
+        }
+        submittedQuads += quadCount;
+    }
+
+public:
+    const char* GetName() const override { return "Batched recording"; }
+
+    bool BeginScene(const Color& clearColor) override {
+        NullRenderBackend::BeginScene(clearColor);
+        queue.beginFrame();
+        currentCalls.clear();
+        quadChecksum = 0;
+        submittedQuads = 0;
+        queue.applyState(*this, RENDER_STATE_ZENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_ZWRITEENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_CULLMODE, RENDER_CULL_NONE);
+        queue.applyState(*this, RENDER_STATE_ALPHABLENDENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_SRCBLEND, RENDER_BLEND_SRCALPHA);
+        queue.applyState(*this, RENDER_STATE_DESTBLEND, RENDER_BLEND_INVSRCALPHA);
+        queue.applyIdentityWorld(*this);
+        return true;
+    }
+
+    void EndScene() override {
+        queue.flush(*this);
+        queue.endFrame();
+        lastFrameCalls.swap(currentCalls);
+        currentCalls.clear();
+        lastQuadChecksum = quadChecksum;
+        lastSubmittedQuads = submittedQuads;
+    }
+
+    void SetTransform(const Mat4& viewMatrix, const Mat4& projectionMatrix [[maybe_unused]]) override {
+        queue.flush(*this);
+        queue.setViewMatrix(viewMatrix);
+    }
+
+    void SetWorldMatrix(const Mat4& worldMatrix) override {
+        queue.flush(*this);
+        if (isIdentityMatrix(worldMatrix)) {
+            queue.applyIdentityWorld(*this);
+            return;
+        }
+        queue.getStateCache().worldChanged();
+        DeviceCall call;
+        call.type = DeviceCall::WORLD_MATRIX;
+        currentCalls.push_back(call);
+    }
+
+    void DrawBlockFace(const Vec3& position, int face, const Color& color) override {
+        NullRenderBackend::DrawBlockFace(position, face, color);
+        VertexPositionColor quad[4];
+        buildBlockFaceVertices(position, face, color, quad);
+        queue.addFace(quad, color.a < 255 ? RENDER_BLEND_ALPHA : RENDER_BLEND_OPAQUE);
+    }
+
+    void DrawQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                      int maxQuadsPerBatch, bool alphaBlend) override {
+        NullRenderBackend::DrawQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch, alphaBlend);
+        queue.addQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch,
+                          alphaBlend ? RENDER_BLEND_ALPHA : RENDER_BLEND_OPAQUE);
+    }
+
+    void DrawCloudMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                       int maxQuadsPerBatch) override {
+        NullRenderBackend::DrawCloudMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch);
+        queue.addQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch, RENDER_BLEND_ALPHA_NO_DEPTH_WRITE);
+    }
+
+    // 太阳：按GPURenderer的方式设置混合状态后单独绘制
+    void DrawSun(Vec3 vertices[4], const Color& color) override {
+        NullRenderBackend::DrawSun(vertices, color);
+        queue.flush(*this);
+        queue.applyState(*this, RENDER_STATE_ZENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_ZWRITEENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_ALPHABLENDENABLE, 1);
+        queue.applyState(*this, RENDER_STATE_SRCBLEND, RENDER_BLEND_SRCALPHA);
+        queue.applyState(*this, RENDER_STATE_DESTBLEND, RENDER_BLEND_INVSRCALPHA);
+        queue.applyVertexFormat(*this);
+        DeviceCall call;
+        call.type = DeviceCall::DRAW;
+        call.quadCount = 1;
+        currentCalls.push_back(call);
+        queue.applyState(*this, RENDER_STATE_ALPHABLENDENABLE, 0);
+    }
+
+    void DrawLine(int x1, int y1, int x2, int y2, const Color& color) override {
+        NullRenderBackend::DrawLine(x1, y1, x2, y2, color);
+        queue.flush(*this);
+        queue.getStateCache().invalidate();
+    }
+
+    void DrawRect(int x, int y, int width, int height, const Color& color) override {
+        NullRenderBackend::DrawRect(x, y, width, height, color);
+        queue.flush(*this);
+        queue.getStateCache().invalidate();
+    }
+
+    void DrawRectOutline(int x, int y, int width, int height, const Color& color) override {
+        NullRenderBackend::DrawRectOutline(x, y, width, height, color);
+        queue.flush(*this);
+        queue.getStateCache().invalidate();
+    }
+
+    void DrawText(int x, int y, const std::string& text, const Color& color) override {
+        NullRenderBackend::DrawText(x, y, text, color);
+        queue.flush(*this);
+        queue.getStateCache().invalidate();
+    }
+
+    RenderBatchStats GetBatchStats() const override {
+        return queue.getStats();
+    }
+
+    // 上一帧的设备调用
+    const std::vector<DeviceCall>& getLastFrameCalls() const {
+        return lastFrameCalls;
+    }
+
+    // 上一帧提交给设备的四边形数和顶点校验和（合批前后应当一致）
+    int getLastSubmittedQuads() const {
+        return lastSubmittedQuads;
+    }
+
+    uint64_t getLastQuadChecksum() const {
+        return lastQuadChecksum;
+    }
+};
+
+#endif // RENDER_COMMAND_QUEUE_H
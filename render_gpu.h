@@ -10,6 +10,9 @@
 #include <windows.h>
 #include <algorithm>
 #include "math3d.h"
+#include "trace.h"
+#include "render_backend.h" // 渲染后端接口（须在<windows.h>之后包含）
+#include "render_command_queue.h" // 渲染状态缓存与合批队列
 
 #pragma comment(lib, "d3d9.lib")
 #pragma comment(lib, "d3dx9.lib")
@@ -53,16 +56,24 @@ struct AdapterInfo {
     }
 };
 
-// 顶点结构
-struct VertexPositionColor {
-    float x, y, z;    // 位置
-    DWORD color;      // 颜色
-    
-    static const DWORD FVF = D3DFVF_XYZ | D3DFVF_DIFFUSE;
+// VertexPositionColor的顶点格式
+const DWORD VERTEX_POSITION_COLOR_FVF = D3DFVF_XYZ | D3DFVF_DIFFUSE;
+
+// 状态缓存中的状态对应的Direct3D渲染状态（顺序与RenderStateId一致）
+const D3DRENDERSTATETYPE D3D_CACHED_RENDER_STATES[RENDER_STATE_COUNT] = {
+    D3DRS_ZENABLE,
+    D3DRS_ZWRITEENABLE,
+    D3DRS_CULLMODE,
+    D3DRS_ALPHABLENDENABLE,
+    D3DRS_SRCBLEND,
+    D3DRS_DESTBLEND
 };
+static_assert(RENDER_CULL_NONE == D3DCULL_NONE, "cull mode value must match Direct3D");
+static_assert(RENDER_BLEND_SRCALPHA == D3DBLEND_SRCALPHA && RENDER_BLEND_INVSRCALPHA == D3DBLEND_INVSRCALPHA,
+              "blend factor values must match Direct3D");
 
-// GPU渲染器类
-class GPURenderer {
+// GPU渲染器类（Direct3D 9渲染后端）
+class GPURenderer : public RenderBackend, private RenderDevice {
 private:
     HWND hwnd;                           // 窗口句柄
     LPDIRECT3D9 d3d;                     // Direct3D对象
@@ -81,6 +92,36 @@ private:
     int trianglesRendered;
     int drawCalls;
     
+    // 三维世界绘制的命令队列（排序合批）和渲染状态缓存
+    DrawCommandQueue drawQueue;
+    
+    // RenderDevice：由drawQueue在刷新时调用，状态已经过缓存过滤
+    void ApplyRenderState(RenderStateId state, uint32_t value) override {
+        d3dDevice->SetRenderState(D3D_CACHED_RENDER_STATES[state], value);
+    }
+    
+    void ApplyIdentityWorld() override {
+        D3DXMATRIX identityWorld;
+        D3DXMatrixIdentity(&identityWorld);
+        d3dDevice->SetTransform(D3DTS_WORLD, &identityWorld);
+    }
+    
+    void ApplyVertexFormat() override {
+        d3dDevice->SetFVF(VERTEX_POSITION_COLOR_FVF);
+    }
+    
+    void DrawIndexedQuads(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices) override {
+        d3dDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, quadCount * 4, quadCount * 2,
+                                          quadIndices, D3DFMT_INDEX16, vertices, sizeof(VertexPositionColor));
+        drawCalls++;
+        trianglesRendered += quadCount * 2;
+    }
+    
+    // 经过缓存设置渲染状态
+    void SetCachedState(RenderStateId state, DWORD value) {
+        drawQueue.applyState(*this, state, value);
+    }
+    
     // 查找最佳GPU适配器
     UINT FindBestAdapter() {
         try {
@@ -176,10 +217,8 @@ private:
                 }
                 
                 // 打印调试信息
-                char debugInfo[256];
-                sprintf_s(debugInfo, "Detected GPU Adapter #%u: %s, VendorID: 0x%x, VRAM: %u MB, Discrete: %s",
-                        i, adapter.identifier.Description, adapter.identifier.VendorId, adapter.vramMB, adapter.isDiscrete ? "Yes" : "No");
-                OutputDebugStringA(debugInfo);
+                TRACE(TRACE_GPU, TRACE_LEVEL_INFO, "Detected GPU Adapter #%u: %s, VendorID: 0x%x, VRAM: %u MB, Discrete: %s",
+                      i, adapter.identifier.Description, adapter.identifier.VendorId, adapter.vramMB, adapter.isDiscrete ? "Yes" : "No");
                 
                 // 添加到适配器列表
                 adapters.push_back(adapter);
@@ -414,7 +453,7 @@ public:
     }
     
     // 调整渲染器大小
-    void Resize(int width, int height) {
+    void Resize(int width, int height) override {
         this->width = width;
         this->height = height;
         
@@ -430,6 +469,7 @@ public:
             d3dpp.BackBufferHeight = height;
             
             HRESULT hr = d3dDevice->Reset(&d3dpp);
+            drawQueue.getStateCache().invalidate();
             if (SUCCEEDED(hr)) {
                 // 重新创建字体
                 D3DXCreateFont(d3dDevice, 16, 0, FW_NORMAL, 1, FALSE, DEFAULT_CHARSET,
@@ -459,7 +499,7 @@ public:
     }
     
     // 开始场景渲染
-    bool BeginScene(const Color& clearColor = Color(135, 206, 235)) { // 默认天空蓝色
+    bool BeginScene(const Color& clearColor = Color(135, 206, 235)) override { // 默认天空蓝色
         if (!d3dDevice) return false;
         
         // 清除统计信息
@@ -476,11 +516,14 @@ public:
         hr = d3dDevice->BeginScene();
         if (FAILED(hr)) return false;
         
+        // 新的一帧从未知的设备状态开始，之后的缓存状态都经过drawQueue设置
+        drawQueue.beginFrame();
+        
         // 设置基本渲染状态
-        d3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);           // 启用深度测试
-        d3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);      // 启用深度写入
+        SetCachedState(RENDER_STATE_ZENABLE, TRUE);               // 启用深度测试
+        SetCachedState(RENDER_STATE_ZWRITEENABLE, TRUE);          // 启用深度写入
         d3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);         // 禁用灯光
-        d3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);  // 暂时禁用面剔除，排查渲染问题
+        SetCachedState(RENDER_STATE_CULLMODE, D3DCULL_NONE);      // 暂时禁用面剔除，排查渲染问题
         
         // 设置正确的深度比较函数 - DirectX默认是D3DCMP_LESSEQUAL
         d3dDevice->SetRenderState(D3DRS_ZFUNC, D3DCMP_LESSEQUAL);
@@ -491,9 +534,9 @@ public:
         d3dDevice->SetSamplerState(0, D3DSAMP_MIPFILTER, D3DTEXF_NONE);
         
         // 启用Alpha混合
-        d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        d3dDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        d3dDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        SetCachedState(RENDER_STATE_ALPHABLENDENABLE, TRUE);
+        SetCachedState(RENDER_STATE_SRCBLEND, D3DBLEND_SRCALPHA);
+        SetCachedState(RENDER_STATE_DESTBLEND, D3DBLEND_INVSRCALPHA);
         
         // 设置Alpha测试 - 丢弃低于阈值的Alpha像素
         d3dDevice->SetRenderState(D3DRS_ALPHATESTENABLE, TRUE);
@@ -501,25 +544,31 @@ public:
         d3dDevice->SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATEREQUAL);
 
         // 设置单位世界矩阵作为默认值
-        D3DXMATRIX identity;
-        D3DXMatrixIdentity(&identity);
-        d3dDevice->SetTransform(D3DTS_WORLD, &identity);
+        drawQueue.applyIdentityWorld(*this);
         
         return true;
     }
     
     // 结束场景渲染并呈现
-    void EndScene() {
+    void EndScene() override {
         if (!d3dDevice) return;
         
+        // 提交队列中剩下的绘制，发布本帧的合批统计
+        drawQueue.flush(*this);
+        drawQueue.endFrame();
+        
         d3dDevice->EndScene();
         d3dDevice->Present(NULL, NULL, NULL, NULL);
     }
     
     // 设置变换矩阵
-    void SetTransform(const Mat4& viewMatrix, const Mat4& projectionMatrix) {
+    void SetTransform(const Mat4& viewMatrix, const Mat4& projectionMatrix) override {
         if (!d3dDevice) return;
         
+        // 已记录的绘制属于旧的变换
+        drawQueue.flush(*this);
+        drawQueue.setViewMatrix(viewMatrix);
+        
         // 转换为D3DXMATRIX
         D3DXMATRIX view, projection;
         
@@ -541,9 +590,16 @@ public:
     }
     
     // 设置世界矩阵
-    void SetWorldMatrix(const Mat4& worldMatrix) {
+    void SetWorldMatrix(const Mat4& worldMatrix) override {
         if (!d3dDevice) return;
         
+        drawQueue.flush(*this);
+        if (isIdentityMatrix(worldMatrix)) {
+            drawQueue.applyIdentityWorld(*this);
+            return;
+        }
+        drawQueue.getStateCache().worldChanged();
+        
         D3DXMATRIX world;
         world._11 = worldMatrix.m[0][0]; world._12 = worldMatrix.m[0][1]; world._13 = worldMatrix.m[0][2]; world._14 = worldMatrix.m[0][3];
         world._21 = worldMatrix.m[1][0]; world._22 = worldMatrix.m[1][1]; world._23 = worldMatrix.m[1][2]; world._24 = worldMatrix.m[1][3];
@@ -553,138 +609,34 @@ public:
         d3dDevice->SetTransform(D3DTS_WORLD, &world);
     }
     
-    // 绘制方块面
-    void DrawBlockFace(const Vec3& position, int face, const Color& color) {
+    // 绘制方块面：只记录到队列，刷新时与相同状态的方块面合并成一次绘制
+    void DrawBlockFace(const Vec3& position, int face, const Color& color) override {
         if (!d3dDevice) return;
         
-        // 确保DirectX状态正确设置
-        d3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
-        d3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
-        d3dDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE); // 暂时禁用面剔除，排查渲染问题
-        
-        // 临时设置单位世界矩阵，确保方块在正确位置
-        D3DXMATRIX identityWorld;
-        D3DXMatrixIdentity(&identityWorld);
-        d3dDevice->SetTransform(D3DTS_WORLD, &identityWorld);
-        
-        // 定义方块面的顶点位置（单位方块）
-        Vec3 vertices[4];
-        
-        // 根据面的类型确定四个顶点位置
-        switch (face) {
-            case 0: // FACE_FRONT (Z+ 面)
-                vertices[0] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 1.0f);
-                vertices[1] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 1.0f);
-                vertices[2] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 1.0f);
-                vertices[3] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 1.0f);
-                break;
-            case 1: // FACE_BACK (Z- 面)
-                vertices[0] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[1] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[2] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 0.0f);
-                vertices[3] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 0.0f);
-                break;
-            case 2: // FACE_LEFT (X- 面)
-                vertices[0] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[1] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 1.0f);
-                vertices[2] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 1.0f);
-                vertices[3] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 0.0f);
-                break;
-            case 3: // FACE_RIGHT (X+ 面)
-                vertices[0] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 1.0f);
-                vertices[1] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[2] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 0.0f);
-                vertices[3] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 1.0f);
-                break;
-            case 4: // FACE_TOP (Y+ 面)
-                vertices[0] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 1.0f);
-                vertices[1] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 1.0f);
-                vertices[2] = Vec3(position.x + 1.0f, position.y + 1.0f, position.z + 0.0f);
-                vertices[3] = Vec3(position.x + 0.0f, position.y + 1.0f, position.z + 0.0f);
-                break;
-            case 5: // FACE_BOTTOM (Y- 面)
-                vertices[0] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[1] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 0.0f);
-                vertices[2] = Vec3(position.x + 1.0f, position.y + 0.0f, position.z + 1.0f);
-                vertices[3] = Vec3(position.x + 0.0f, position.y + 0.0f, position.z + 1.0f);
-                break;
-        }
-        
-        // 输出调试信息，观察方块顶点坐标
-        char debug_msg[256];
-        sprintf_s(debug_msg, "Render block face %d at postion (%.1f, %.1f, %.1f)", face, position.x, position.y, position.z);
-        OutputDebugStringA(debug_msg);
-        
-        // 应用简单的面光照 - 根据面的方向调整颜色亮度
-        D3DCOLOR faceColor;
-        
-        switch (face) {
-            case 4: // 顶面最亮
-                faceColor = D3DCOLOR_RGBA(color.r, color.g, color.b, color.a);
-                break;
-            case 5: // 底面最暗
-                faceColor = D3DCOLOR_RGBA(
-                    static_cast<BYTE>(color.r * 0.6f),
-                    static_cast<BYTE>(color.g * 0.6f),
-                    static_cast<BYTE>(color.b * 0.6f),
-                    color.a
-                );
-                break;
-            case 0: // 前面
-            case 1: // 后面
-                faceColor = D3DCOLOR_RGBA(
-                    static_cast<BYTE>(color.r * 0.8f),
-                    static_cast<BYTE>(color.g * 0.8f),
-                    static_cast<BYTE>(color.b * 0.8f),
-                    color.a
-                );
-                break;
-            case 2: // 左面
-            case 3: // 右面
-                faceColor = D3DCOLOR_RGBA(
-                    static_cast<BYTE>(color.r * 0.7f),
-                    static_cast<BYTE>(color.g * 0.7f),
-                    static_cast<BYTE>(color.b * 0.7f),
-                    color.a
-                );
-                break;
-        }
-        
-        // 对于透明方块（如水、树叶等），确保Alpha混合正确设置
-        bool useAlpha = (color.a < 255);
-        if (useAlpha) {
-            d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-            d3dDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-            d3dDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-        } else {
-            d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        }
-        
-        // 创建顶点数据
-        VertexPositionColor verts[6];
-        
-        // 两个三角形组成一个面
-        verts[0].x = vertices[0].x; verts[0].y = vertices[0].y; verts[0].z = vertices[0].z; verts[0].color = faceColor;
-        verts[1].x = vertices[1].x; verts[1].y = vertices[1].y; verts[1].z = vertices[1].z; verts[1].color = faceColor;
-        verts[2].x = vertices[2].x; verts[2].y = vertices[2].y; verts[2].z = vertices[2].z; verts[2].color = faceColor;
-        
-        verts[3].x = vertices[0].x; verts[3].y = vertices[0].y; verts[3].z = vertices[0].z; verts[3].color = faceColor;
-        verts[4].x = vertices[2].x; verts[4].y = vertices[2].y; verts[4].z = vertices[2].z; verts[4].color = faceColor;
-        verts[5].x = vertices[3].x; verts[5].y = vertices[3].y; verts[5].z = vertices[3].z; verts[5].color = faceColor;
-        
-        // 设置顶点格式
-        d3dDevice->SetFVF(VertexPositionColor::FVF);
-        
-        // 使用DrawPrimitiveUP绘制三角形列表
-        d3dDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, 2, verts, sizeof(VertexPositionColor));
+        // 顶点位置（单位方块）和按朝向调暗的颜色
+        VertexPositionColor verts[4];
+        buildBlockFaceVertices(position, face, color, verts);
         
-        drawCalls++;
-        trianglesRendered += 2;
+        // 透明方块（如水、树叶等）进入混合的一组，排在不透明方块之后
+        drawQueue.addFace(verts, color.a < 255 ? RENDER_BLEND_ALPHA : RENDER_BLEND_OPAQUE);
+    }
+    
+    // 绘制预先生成的四边形网格（每4个顶点一个四边形，所有网格共用quadIndices索引模式）
+    // 一个区块分段的一遍只需一次调用；四边形数超过16位索引范围时按maxQuadsPerBatch分批
+    // 顶点指针要保持有效直到队列刷新（下一次换变换、画云/太阳/2D图元或帧结束）
+    void DrawQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                      int maxQuadsPerBatch, bool alphaBlend) override {
+        if (!d3dDevice || quadCount <= 0) return;
+        
+        // 网格顶点已经是世界坐标；状态（单位世界矩阵、混合）在队列刷新时设置
+        drawQueue.addQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch,
+                              alphaBlend ? RENDER_BLEND_ALPHA : RENDER_BLEND_OPAQUE);
     }
     
     // 绘制简单形状 - 横线
-    void DrawLine(int x1, int y1, int x2, int y2, const Color& color) {
+    void DrawLine(int x1, int y1, int x2, int y2, const Color& color) override {
         if (!d3dDevice || !font) return;
+        drawQueue.flush(*this);
         
         // 使用ID3DXLine绘制线条会更高效，但为简单起见，我们使用Direct3D的普通绘制功能
         D3DXVECTOR2 vertices[2];
@@ -729,12 +681,16 @@ public:
         d3dDevice->SetTransform(D3DTS_PROJECTION, &oldProj);
         d3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
         
+        // 2D图元改动了顶点格式、混合等状态，之后按未知处理
+        drawQueue.getStateCache().invalidate();
+        
         drawCalls++;
     }
     
     // 绘制矩形
-    void DrawRect(int x, int y, int width, int height, const Color& color) {
+    void DrawRect(int x, int y, int width, int height, const Color& color) override {
         if (!d3dDevice) return;
+        drawQueue.flush(*this);
         
         // 设置正交投影矩阵以便绘制2D
         D3DXMATRIX orthoProj;
@@ -791,11 +747,14 @@ public:
         d3dDevice->SetTransform(D3DTS_PROJECTION, &oldProj);
         d3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
         
+        // 2D图元改动了顶点格式、混合等状态，之后按未知处理
+        drawQueue.getStateCache().invalidate();
+        
         drawCalls++;
     }
     
     // 绘制矩形边框
-    void DrawRectOutline(int x, int y, int width, int height, const Color& color) {
+    void DrawRectOutline(int x, int y, int width, int height, const Color& color) override {
         // 绘制四条线
         DrawLine(x, y, x + width - 1, y, color);                     // 上边
         DrawLine(x + width - 1, y, x + width - 1, y + height - 1, color); // 右边
@@ -804,8 +763,9 @@ public:
     }
     
     // 绘制文本
-    void DrawText(int x, int y, const std::string& text, const Color& color) {
+    void DrawText(int x, int y, const std::string& text, const Color& color) override {
         if (!font) return;
+        if (d3dDevice) drawQueue.flush(*this);
         
         // 定义文本矩形
         RECT rect;
@@ -818,6 +778,9 @@ public:
         font->DrawTextA(NULL, text.c_str(), -1, &rect, DT_LEFT | DT_NOCLIP,
                        D3DCOLOR_RGBA(color.r, color.g, color.b, color.a));
         
+        // D3DX字体会改动渲染状态
+        drawQueue.getStateCache().invalidate();
+        
         drawCalls++;
     }
     
@@ -827,58 +790,35 @@ public:
     }
     
     // 获取三角形和绘制调用次数
-    int GetTrianglesRendered() const { return trianglesRendered; }
-    int GetDrawCalls() const { return drawCalls; }
+    int GetTrianglesRendered() const override { return trianglesRendered; }
+    int GetDrawCalls() const override { return drawCalls; }
+    RenderBatchStats GetBatchStats() const override { return drawQueue.getStats(); }
     
-    // 绘制云面
-    void DrawCloudFace(Vec3 vertices[4], const Color& color) {
-        if (!d3dDevice) return;
-        
-        // 设置透明混合状态
-        d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        d3dDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        d3dDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-        
-        // 禁用深度写入但保持深度测试
-        d3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, FALSE);
-        
-        // 准备顶点数据
-        VertexPositionColor verts[4];
-        D3DCOLOR cloudColor = D3DCOLOR_ARGB(color.a, color.r, color.g, color.b);
-        
-        // 转换顶点到屏幕空间
-        for (int i = 0; i < 4; i++) {
-            verts[i].x = vertices[i].x;
-            verts[i].y = vertices[i].y;
-            verts[i].z = vertices[i].z;
-            verts[i].color = cloudColor;
-        }
-        
-        // 绘制两个三角形组成的四边形
-        d3dDevice->SetFVF(VertexPositionColor::FVF);
-        d3dDevice->DrawPrimitiveUP(D3DPT_TRIANGLEFAN, 2, verts, sizeof(VertexPositionColor));
-        
-        // 恢复渲染状态
-        d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        d3dDevice->SetRenderState(D3DRS_ZWRITEENABLE, TRUE);
+    const char* GetName() const override { return "Direct3D 9"; }
+    
+    // 绘制云层网格
+    void DrawCloudMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices,
+                       int maxQuadsPerBatch) override {
+        if (!d3dDevice || quadCount <= 0) return;
         
-        // 更新统计信息
-        trianglesRendered += 2;
-        drawCalls++;
+        // 记录到队列的半透明遍（混合、不写深度但保持深度测试），排在水等半透明网格之后
+        drawQueue.addQuadMesh(vertices, quadCount, quadIndices, maxQuadsPerBatch, RENDER_BLEND_ALPHA_NO_DEPTH_WRITE);
     }
     
     // 绘制太阳
-    void DrawSun(Vec3 vertices[4], const Color& color) {
+    void DrawSun(Vec3 vertices[4], const Color& color) override {
         if (!d3dDevice) return;
+        drawQueue.flush(*this);
         
         // 保持深度测试启用，这样太阳会被方块遮挡
-        d3dDevice->SetRenderState(D3DRS_ZENABLE, TRUE);
+        SetCachedState(RENDER_STATE_ZENABLE, TRUE);
+        SetCachedState(RENDER_STATE_ZWRITEENABLE, TRUE);
         d3dDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
         
         // 设置透明混合状态（使太阳边缘更柔和）
-        d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-        d3dDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-        d3dDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        SetCachedState(RENDER_STATE_ALPHABLENDENABLE, TRUE);
+        SetCachedState(RENDER_STATE_SRCBLEND, D3DBLEND_SRCALPHA);
+        SetCachedState(RENDER_STATE_DESTBLEND, D3DBLEND_INVSRCALPHA);
         
         // 准备顶点数据
         VertexPositionColor verts[4];
@@ -893,11 +833,11 @@ public:
         }
         
         // 绘制两个三角形组成的四边形
-        d3dDevice->SetFVF(VertexPositionColor::FVF);
+        drawQueue.applyVertexFormat(*this);
         d3dDevice->DrawPrimitiveUP(D3DPT_TRIANGLEFAN, 2, verts, sizeof(VertexPositionColor));
         
         // 恢复渲染状态
-        d3dDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        SetCachedState(RENDER_STATE_ALPHABLENDENABLE, FALSE);
         
         // 更新统计信息
         trianglesRendered += 2;
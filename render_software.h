@@ -0,0 +1,684 @@
+#ifndef RENDER_SOFTWARE_H
+#define RENDER_SOFTWARE_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include "math3d.h"
+#include "render_backend.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_USE_SSE2 1
+#else
+#define RASTER_USE_SSE2 0
+#endif
+
+// 分块多线程软件光栅化后端
+//
+// 不需要GPU：绘制调用在主线程上完成顶点变换、裁剪和三角形建立，并把三角形按包围盒
+// 分到64x64的屏幕分块里；EndScene时工作线程按分块并行光栅化（每个分块只由一个线程处理，
+// 分块内按提交顺序绘制，半透明混合的先后关系与GPU一致），结果直接写入frameBuffer。
+// 顶点吸附到1/16像素的定点坐标，边函数用整数建立，共享边的两个三角形得到严格相反的值，
+// 配合平局规则保证不漏像素、不重复混合。渲染状态与GPURenderer保持一致：
+// 深度比较为LESSEQUAL，Alpha低于8的像素丢弃，云不写深度，2D图元不做深度测试。
+// 文字没有字体可用，只计入绘制调用。
+
+const int RASTER_TILE_SIZE = 64;
+const int RASTER_SUBPIXEL_SCALE = 16;         // 1/16像素精度
+const float RASTER_GUARD_BAND = 8.0f;         // 防护带：裁剪到屏幕尺寸的8倍以内，保证定点坐标不溢出
+const uint8_t RASTER_ALPHA_REF = 0x08;        // 与GPURenderer的Alpha测试阈值一致
+const int RASTER_MAX_WORKERS = 7;
+
+// 三角形的渲染状态
+enum RasterFlags {
+    RASTER_DEPTH_TEST = 1,
+    RASTER_DEPTH_WRITE = 2,
+    RASTER_BLEND = 4
+};
+
+// 建立好的屏幕空间三角形
+struct RasterTriangle {
+    int minX, minY, maxX, maxY;   // 像素包围盒（闭区间，已裁剪到屏幕）
+    int32_t edgeX[3], edgeY[3];   // 边的起点（定点坐标）
+    int32_t edgeA[3], edgeB[3];   // 边函数 E = (px - edgeX) * edgeA + (py - edgeY) * edgeB
+    float threshold[3];           // E大于该值时覆盖（平局规则：左上边包含E==0）
+    float zx, zy, z0;             // 深度平面 z = zx * x + zy * y + z0（像素坐标）
+    uint32_t color;
+    uint8_t flags;
+};
+
+class SoftwareRenderBackend : public RenderBackend {
+private:
+    uint32_t* target = nullptr;   // 输出的帧缓冲（32位，从上到下）
+    int width = 0;
+    int height = 0;
+    int depthStride = 0;          // 深度缓冲行宽（按4对齐，SIMD整组读写不会跨行）
+    std::vector<float> depthBuffer;
+    uint32_t clearColor = 0xFF000000;
+
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<RasterTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;   // 每个分块的三角形下标（按提交顺序）
+
+    // 变换：行向量约定（与Direct3D一致），clip = v * world * view * projection
+    Mat4 worldMatrix;
+    bool worldIsIdentity = true;
+    Mat4 viewMatrix;
+    Mat4 projectionMatrix;
+    float transform[4][4];
+
+    int trianglesRendered = 0;
+    int drawCalls = 0;
+
+    // 工作线程
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    uint64_t generation = 0;
+    int finishedWorkers = 0;
+    bool stopRequested = false;
+    std::atomic<int> nextTile;
+
+    struct ClipVertex {
+        float x, y, z, w;
+    };
+
+    static void multiply(const Mat4& a, const Mat4& b, Mat4& out) {
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; k++) {
+                    sum += a.m[i][k] * b.m[k][j];
+                }
+                out.m[i][j] = sum;
+            }
+        }
+    }
+
+    // 方块面和网格顶点已经是世界坐标，与GPURenderer一样先换回单位世界矩阵（之后的云和太阳也沿用）
+    void resetWorldMatrix() {
+        if (!worldIsIdentity) {
+            worldMatrix = Mat4();
+            worldIsIdentity = true;
+            updateTransform();
+        }
+    }
+
+    void updateTransform() {
+        Mat4 worldView, combined;
+        multiply(worldMatrix, viewMatrix, worldView);
+        multiply(worldView, projectionMatrix, combined);
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                transform[i][j] = combined.m[i][j];
+            }
+        }
+    }
+
+    ClipVertex toClip(float x, float y, float z) const {
+        ClipVertex v;
+        v.x = x * transform[0][0] + y * transform[1][0] + z * transform[2][0] + transform[3][0];
+        v.y = x * transform[0][1] + y * transform[1][1] + z * transform[2][1] + transform[3][1];
+        v.z = x * transform[0][2] + y * transform[1][2] + z * transform[2][2] + transform[3][2];
+        v.w = x * transform[0][3] + y * transform[1][3] + z * transform[2][3] + transform[3][3];
+        return v;
+    }
+
+    // 第plane个裁剪平面的有向距离（非负为内侧）：近平面和四个防护带平面
+    static float planeDistance(const ClipVertex& v, int plane) {
+        switch (plane) {
+            case 0: return v.z;
+            case 1: return v.x + RASTER_GUARD_BAND * v.w;
+            case 2: return RASTER_GUARD_BAND * v.w - v.x;
+            case 3: return v.y + RASTER_GUARD_BAND * v.w;
+            default: return RASTER_GUARD_BAND * v.w - v.y;
+        }
+    }
+
+    // 裁剪空间三角形：平凡拒绝、Sutherland-Hodgman裁剪、透视除法后按扇形提交
+    void submitClipTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, uint32_t color, uint8_t flags) {
+        // 整个三角形在某个视锥平面外侧时直接丢弃
+        if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+            (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w) ||
+            (a.z > a.w && b.z > b.w && c.z > c.w) || (a.z < 0.0f && b.z < 0.0f && c.z < 0.0f)) {
+            return;
+        }
+
+        ClipVertex polygon[9] = { a, b, c };
+        ClipVertex clipped[9];
+        int count = 3;
+        for (int plane = 0; plane < 5 && count >= 3; plane++) {
+            bool allInside = true;
+            for (int i = 0; i < count; i++) {
+                if (planeDistance(polygon[i], plane) < 0.0f) {
+                    allInside = false;
+                    break;
+                }
+            }
+            if (allInside) continue;
+
+            int outCount = 0;
+            for (int i = 0; i < count; i++) {
+                const ClipVertex& current = polygon[i];
+                const ClipVertex& next = polygon[(i + 1) % count];
+                float dc = planeDistance(current, plane);
+                float dn = planeDistance(next, plane);
+                if (dc >= 0.0f) {
+                    clipped[outCount++] = current;
+                }
+                if ((dc >= 0.0f) != (dn >= 0.0f)) {
+                    float t = dc / (dc - dn);
+                    ClipVertex v;
+                    v.x = current.x + (next.x - current.x) * t;
+                    v.y = current.y + (next.y - current.y) * t;
+                    v.z = current.z + (next.z - current.z) * t;
+                    v.w = current.w + (next.w - current.w) * t;
+                    clipped[outCount++] = v;
+                }
+            }
+            count = outCount;
+            std::copy(clipped, clipped + count, polygon);
+        }
+        if (count < 3) return;
+
+        float sx[9], sy[9], sz[9];
+        for (int i = 0; i < count; i++) {
+            float invW = 1.0f / polygon[i].w;
+            sx[i] = (polygon[i].x * invW * 0.5f + 0.5f) * width;
+            sy[i] = (0.5f - polygon[i].y * invW * 0.5f) * height;
+            sz[i] = polygon[i].z * invW;
+        }
+        for (int i = 1; i + 1 < count; i++) {
+            float tx[3] = { sx[0], sx[i], sx[i + 1] };
+            float ty[3] = { sy[0], sy[i], sy[i + 1] };
+            float tz[3] = { sz[0], sz[i], sz[i + 1] };
+            submitScreenTriangle(tx, ty, tz, color, flags);
+        }
+    }
+
+    // 屏幕空间三角形：吸附到定点坐标、建立边函数和深度平面、分到各个分块
+    void submitScreenTriangle(const float sx[3], const float sy[3], const float sz[3], uint32_t color, uint8_t flags) {
+        int32_t fx[3], fy[3];
+        for (int i = 0; i < 3; i++) {
+            fx[i] = static_cast<int32_t>(std::lround(sx[i] * RASTER_SUBPIXEL_SCALE));
+            fy[i] = static_cast<int32_t>(std::lround(sy[i] * RASTER_SUBPIXEL_SCALE));
+        }
+
+        int64_t area = static_cast<int64_t>(fx[1] - fx[0]) * (fy[2] - fy[0]) -
+                       static_cast<int64_t>(fy[1] - fy[0]) * (fx[2] - fx[0]);
+        if (area == 0) return;
+        int order[3] = { 0, 1, 2 };
+        if (area > 0) {
+            // 统一绕向，使三角形内部的边函数为正（不做背面剔除，与GPU的CULL_NONE一致）
+            std::swap(order[1], order[2]);
+        }
+
+        RasterTriangle tri;
+        int minFx = std::min(fx[0], std::min(fx[1], fx[2]));
+        int maxFx = std::max(fx[0], std::max(fx[1], fx[2]));
+        int minFy = std::min(fy[0], std::min(fy[1], fy[2]));
+        int maxFy = std::max(fy[0], std::max(fy[1], fy[2]));
+        // 覆盖像素中心(px + 0.5)的像素范围
+        tri.minX = std::max(0, (minFx - RASTER_SUBPIXEL_SCALE / 2 + RASTER_SUBPIXEL_SCALE - 1) / RASTER_SUBPIXEL_SCALE - 1);
+        tri.minY = std::max(0, (minFy - RASTER_SUBPIXEL_SCALE / 2 + RASTER_SUBPIXEL_SCALE - 1) / RASTER_SUBPIXEL_SCALE - 1);
+        tri.maxX = std::min(width - 1, (maxFx - RASTER_SUBPIXEL_SCALE / 2) / RASTER_SUBPIXEL_SCALE + 1);
+        tri.maxY = std::min(height - 1, (maxFy - RASTER_SUBPIXEL_SCALE / 2) / RASTER_SUBPIXEL_SCALE + 1);
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+        for (int e = 0; e < 3; e++) {
+            int from = order[e];
+            int to = order[(e + 1) % 3];
+            tri.edgeX[e] = fx[from];
+            tri.edgeY[e] = fy[from];
+            tri.edgeA[e] = fy[to] - fy[from];
+            tri.edgeB[e] = -(fx[to] - fx[from]);
+            // 平局规则：共享边在两个三角形中的系数互为相反数，恰好只有一个包含E==0的像素
+            bool inclusive = tri.edgeA[e] > 0 || (tri.edgeA[e] == 0 && tri.edgeB[e] > 0);
+            tri.threshold[e] = inclusive ? -0.5f : 0.0f;
+        }
+
+        // 深度平面（屏幕空间中z/w是线性的）
+        double x0 = sx[0], y0 = sy[0];
+        double dx1 = sx[1] - x0, dy1 = sy[1] - y0, dz1 = sz[1] - sz[0];
+        double dx2 = sx[2] - x0, dy2 = sy[2] - y0, dz2 = sz[2] - sz[0];
+        double det = dx1 * dy2 - dx2 * dy1;
+        if (det == 0.0) return;
+        double zx = (dz1 * dy2 - dz2 * dy1) / det;
+        double zy = (dx1 * dz2 - dx2 * dz1) / det;
+        tri.zx = static_cast<float>(zx);
+        tri.zy = static_cast<float>(zy);
+        tri.z0 = static_cast<float>(sz[0] - zx * x0 - zy * y0);
+        tri.color = color;
+        tri.flags = flags;
+
+        uint32_t index = static_cast<uint32_t>(triangles.size());
+        triangles.push_back(tri);
+
+        int tileMinX = tri.minX / RASTER_TILE_SIZE;
+        int tileMaxX = tri.maxX / RASTER_TILE_SIZE;
+        int tileMinY = tri.minY / RASTER_TILE_SIZE;
+        int tileMaxY = tri.maxY / RASTER_TILE_SIZE;
+        for (int ty = tileMinY; ty <= tileMaxY; ty++) {
+            for (int tx = tileMinX; tx <= tileMaxX; tx++) {
+                bins[static_cast<size_t>(ty) * tilesX + tx].push_back(index);
+            }
+        }
+    }
+
+    // 世界空间四边形（两个三角形：0-1-2、0-2-3）
+    void submitWorldQuad(const float x[4], const float y[4], const float z[4], uint32_t color, uint8_t flags) {
+        trianglesRendered += 2;
+        if ((color >> 24) < RASTER_ALPHA_REF) return;
+        ClipVertex v[4];
+        for (int i = 0; i < 4; i++) {
+            v[i] = toClip(x[i], y[i], z[i]);
+        }
+        submitClipTriangle(v[0], v[1], v[2], color, flags);
+        submitClipTriangle(v[0], v[2], v[3], color, flags);
+    }
+
+    // 屏幕空间矩形（2D图元）
+    void submitScreenRect(float x0, float y0, float x1, float y1, uint32_t color) {
+        if ((color >> 24) < RASTER_ALPHA_REF) return;
+        uint8_t flags = (color >> 24) < 255 ? RASTER_BLEND : 0;
+        float z[3] = { 0.0f, 0.0f, 0.0f };
+        float ax[3] = { x0, x1, x1 }, ay[3] = { y0, y0, y1 };
+        float bx[3] = { x0, x1, x0 }, by[3] = { y0, y1, y1 };
+        submitScreenTriangle(ax, ay, z, color, flags);
+        submitScreenTriangle(bx, by, z, color, flags);
+    }
+
+    static uint32_t blendPixel(uint32_t src, uint32_t dst) {
+        uint32_t alpha = src >> 24;
+        uint32_t inv = 255 - alpha;
+        uint32_t r = (((src >> 16) & 0xFF) * alpha + ((dst >> 16) & 0xFF) * inv + 127) / 255;
+        uint32_t g = (((src >> 8) & 0xFF) * alpha + ((dst >> 8) & 0xFF) * inv + 127) / 255;
+        uint32_t b = ((src & 0xFF) * alpha + (dst & 0xFF) * inv + 127) / 255;
+        return 0xFF000000 | (r << 16) | (g << 8) | b;
+    }
+
+    // 写入一组像素（mask的第i位对应x + i）
+    void writePixels(uint32_t* row, int x, int mask, uint32_t color, bool blend) const {
+        uint32_t opaque = color | 0xFF000000;
+        while (mask) {
+            int lane = 0;
+            while (!(mask & (1 << lane))) lane++;
+            mask &= ~(1 << lane);
+            uint32_t& pixel = row[x + lane];
+            pixel = blend ? blendPixel(color, pixel) : opaque;
+        }
+    }
+
+    // 在一个分块内光栅化一个三角形
+    void rasterizeInTile(const RasterTriangle& tri, int tileX0, int tileY0, int tileX1, int tileY1) {
+        int x0 = std::max(tri.minX, tileX0);
+        int x1 = std::min(tri.maxX + 1, tileX1);
+        int y0 = std::max(tri.minY, tileY0);
+        int y1 = std::min(tri.maxY + 1, tileY1);
+        if (x0 >= x1 || y0 >= y1) return;
+
+        // 按4对齐的起点：分块边界是64的倍数，4个一组的读写不会越过分块
+        int alignedX0 = x0 & ~3;
+        bool depthTest = (tri.flags & RASTER_DEPTH_TEST) != 0;
+        bool depthWrite = (tri.flags & RASTER_DEPTH_WRITE) != 0;
+        bool blend = (tri.flags & RASTER_BLEND) != 0;
+        float stepX[3];
+        for (int e = 0; e < 3; e++) {
+            stepX[e] = static_cast<float>(tri.edgeA[e] * RASTER_SUBPIXEL_SCALE);
+        }
+
+        for (int y = y0; y < y1; y++) {
+            // 每行起点的边函数用64位整数精确计算
+            int64_t py = static_cast<int64_t>(y) * RASTER_SUBPIXEL_SCALE + RASTER_SUBPIXEL_SCALE / 2;
+            int64_t px = static_cast<int64_t>(alignedX0) * RASTER_SUBPIXEL_SCALE + RASTER_SUBPIXEL_SCALE / 2;
+            float rowEdge[3];
+            for (int e = 0; e < 3; e++) {
+                rowEdge[e] = static_cast<float>((px - tri.edgeX[e]) * tri.edgeA[e] + (py - tri.edgeY[e]) * tri.edgeB[e]);
+            }
+            float rowZ = tri.z0 + tri.zx * (alignedX0 + 0.5f) + tri.zy * (y + 0.5f);
+            float* depthRow = depthBuffer.data() + static_cast<size_t>(y) * depthStride;
+            uint32_t* colorRow = target + static_cast<size_t>(y) * width;
+
+#if RASTER_USE_SSE2
+            const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            __m128 edge0 = _mm_add_ps(_mm_set1_ps(rowEdge[0]), _mm_mul_ps(lanes, _mm_set1_ps(stepX[0])));
+            __m128 edge1 = _mm_add_ps(_mm_set1_ps(rowEdge[1]), _mm_mul_ps(lanes, _mm_set1_ps(stepX[1])));
+            __m128 edge2 = _mm_add_ps(_mm_set1_ps(rowEdge[2]), _mm_mul_ps(lanes, _mm_set1_ps(stepX[2])));
+            __m128 step0 = _mm_set1_ps(stepX[0] * 4.0f);
+            __m128 step1 = _mm_set1_ps(stepX[1] * 4.0f);
+            __m128 step2 = _mm_set1_ps(stepX[2] * 4.0f);
+            __m128 threshold0 = _mm_set1_ps(tri.threshold[0]);
+            __m128 threshold1 = _mm_set1_ps(tri.threshold[1]);
+            __m128 threshold2 = _mm_set1_ps(tri.threshold[2]);
+            __m128 depth = _mm_add_ps(_mm_set1_ps(rowZ), _mm_mul_ps(lanes, _mm_set1_ps(tri.zx)));
+            __m128 depthStep = _mm_set1_ps(tri.zx * 4.0f);
+            for (int x = alignedX0; x < x1; x += 4) {
+                __m128 inside = _mm_and_ps(_mm_cmpgt_ps(edge0, threshold0),
+                                _mm_and_ps(_mm_cmpgt_ps(edge1, threshold1), _mm_cmpgt_ps(edge2, threshold2)));
+                int mask = _mm_movemask_ps(inside);
+                if (x < x0) mask &= 0xF << (x0 - x);
+                if (x + 4 > x1) mask &= 0xF >> (x + 4 - x1);
+                if (mask) {
+                    if (depthTest || depthWrite) {
+                        float* d = depthRow + x;
+                        __m128 stored = _mm_loadu_ps(d);
+                        if (depthTest) {
+                            mask &= _mm_movemask_ps(_mm_cmple_ps(depth, stored));
+                        }
+                        if (mask && depthWrite) {
+                            static const int laneBits[4] = { 1, 2, 4, 8 };
+                            __m128 write = _mm_castsi128_ps(_mm_setr_epi32(
+                                (mask & laneBits[0]) ? -1 : 0, (mask & laneBits[1]) ? -1 : 0,
+                                (mask & laneBits[2]) ? -1 : 0, (mask & laneBits[3]) ? -1 : 0));
+                            _mm_storeu_ps(d, _mm_or_ps(_mm_and_ps(write, depth), _mm_andnot_ps(write, stored)));
+                        }
+                    }
+                    if (mask) {
+                        writePixels(colorRow, x, mask, tri.color, blend);
+                    }
+                }
+                edge0 = _mm_add_ps(edge0, step0);
+                edge1 = _mm_add_ps(edge1, step1);
+                edge2 = _mm_add_ps(edge2, step2);
+                depth = _mm_add_ps(depth, depthStep);
+            }
+#else
+            for (int x = alignedX0; x < x1; x += 4) {
+                int mask = 0;
+                for (int lane = 0; lane < 4; lane++) {
+                    float offset = static_cast<float>(x - alignedX0 + lane);
+                    if (x + lane < x0 || x + lane >= x1) continue;
+                    bool inside = true;
+                    for (int e = 0; e < 3; e++) {
+                        inside = inside && (rowEdge[e] + stepX[e] * offset > tri.threshold[e]);
+                    }
+                    if (!inside) continue;
+                    float z = rowZ + tri.zx * offset;
+                    float& stored = depthRow[x + lane];
+                    if (depthTest && !(z <= stored)) continue;
+                    if (depthWrite) stored = z;
+                    mask |= 1 << lane;
+                }
+                if (mask) {
+                    writePixels(colorRow, x, mask, tri.color, blend);
+                }
+            }
+#endif
+        }
+    }
+
+    // 光栅化一个分块：先清屏，再按提交顺序绘制分到这里的三角形
+    void rasterizeTile(int tile) {
+        int tileX0 = (tile % tilesX) * RASTER_TILE_SIZE;
+        int tileY0 = (tile / tilesX) * RASTER_TILE_SIZE;
+        int tileX1 = std::min(tileX0 + RASTER_TILE_SIZE, width);
+        int tileY1 = std::min(tileY0 + RASTER_TILE_SIZE, height);
+        for (int y = tileY0; y < tileY1; y++) {
+            std::fill(target + static_cast<size_t>(y) * width + tileX0, target + static_cast<size_t>(y) * width + tileX1, clearColor);
+            float* depthRow = depthBuffer.data() + static_cast<size_t>(y) * depthStride;
+            std::fill(depthRow + tileX0, depthRow + tileX1, 1.0f);
+        }
+        for (uint32_t index : bins[tile]) {
+            rasterizeInTile(triangles[index], tileX0, tileY0, tileX1, tileY1);
+        }
+    }
+
+    // 领取分块直到全部完成（主线程和工作线程共用）
+    void rasterizeTiles() {
+        int tileCount = tilesX * tilesY;
+        while (true) {
+            int tile = nextTile.fetch_add(1);
+            if (tile >= tileCount) break;
+            rasterizeTile(tile);
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCondition.wait(lock, [&] { return stopRequested || generation != seen; });
+                if (stopRequested) return;
+                seen = generation;
+            }
+            rasterizeTiles();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finishedWorkers++;
+            }
+            doneCondition.notify_one();
+        }
+    }
+
+public:
+    explicit SoftwareRenderBackend(int workerCount = -1) : nextTile(0) {
+        if (workerCount < 0) {
+            int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+            workerCount = std::max(0, std::min(RASTER_MAX_WORKERS, hardwareThreads - 1));
+        }
+        for (int i = 0; i < workerCount; i++) {
+            workers.push_back(std::thread(&SoftwareRenderBackend::workerLoop, this));
+        }
+        updateTransform();
+    }
+
+    ~SoftwareRenderBackend() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        startCondition.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    SoftwareRenderBackend(const SoftwareRenderBackend&) = delete;
+    SoftwareRenderBackend& operator=(const SoftwareRenderBackend&) = delete;
+
+    const char* GetName() const override { return "Software"; }
+
+    void SetFrameBuffer(uint32_t* pixels, int newWidth, int newHeight) override {
+        target = pixels;
+        Resize(newWidth, newHeight);
+    }
+
+    bool WritesFrameBuffer() const override { return true; }
+
+    void Resize(int newWidth, int newHeight) override {
+        width = std::max(0, newWidth);
+        height = std::max(0, newHeight);
+        depthStride = (width + 3) & ~3;
+        depthBuffer.assign(static_cast<size_t>(depthStride) * height, 1.0f);
+        tilesX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        tilesY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+        bins.assign(static_cast<size_t>(tilesX) * tilesY, std::vector<uint32_t>());
+        triangles.clear();
+    }
+
+    bool BeginScene(const Color& color) override {
+        clearColor = 0xFF000000 | (static_cast<uint32_t>(color.r) << 16) | (static_cast<uint32_t>(color.g) << 8) | color.b;
+        triangles.clear();
+        for (auto& bin : bins) {
+            bin.clear();
+        }
+        trianglesRendered = 0;
+        drawCalls = 0;
+        worldMatrix = Mat4();
+        worldIsIdentity = true;
+        updateTransform();
+        return target != nullptr;
+    }
+
+    // 并行光栅化所有分块，结果写入帧缓冲
+    void EndScene() override {
+        if (!target || tilesX == 0 || tilesY == 0) return;
+        nextTile.store(0);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishedWorkers = 0;
+            generation++;
+        }
+        startCondition.notify_all();
+        rasterizeTiles();
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return finishedWorkers == static_cast<int>(workers.size()); });
+    }
+
+    void SetTransform(const Mat4& view, const Mat4& projection) override {
+        viewMatrix = view;
+        projectionMatrix = projection;
+        updateTransform();
+    }
+
+    void SetWorldMatrix(const Mat4& world) override {
+        worldMatrix = world;
+        worldIsIdentity = false;
+        updateTransform();
+    }
+
+    void DrawBlockFace(const Vec3& position, int face, const Color& color) override {
+        if (face < 0 || face >= 6) return;
+        resetWorldMatrix();
+        // 与GPURenderer::DrawBlockFace的顶点顺序和亮度一致
+        static const float corners[6][4][3] = {
+            {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}},
+            {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}},
+            {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}},
+            {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}},
+            {{0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0}},
+            {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}
+        };
+        static const float shade[6] = { 0.8f, 0.8f, 0.7f, 0.7f, 1.0f, 0.6f };
+        float x[4], y[4], z[4];
+        for (int i = 0; i < 4; i++) {
+            x[i] = position.x + corners[face][i][0];
+            y[i] = position.y + corners[face][i][1];
+            z[i] = position.z + corners[face][i][2];
+        }
+        uint32_t shaded = packVertexColor(static_cast<uint32_t>(color.r * shade[face]), static_cast<uint32_t>(color.g * shade[face]),
+                                          static_cast<uint32_t>(color.b * shade[face]), color.a);
+        uint8_t flags = RASTER_DEPTH_TEST | RASTER_DEPTH_WRITE | (color.a < 255 ? RASTER_BLEND : 0);
+        submitWorldQuad(x, y, z, shaded, flags);
+        drawCalls++;
+    }
+
+    void DrawQuadMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices [[maybe_unused]],
+                      int maxQuadsPerBatch, bool alphaBlend) override {
+        if (quadCount <= 0) return;
+        resetWorldMatrix();
+        uint8_t flags = RASTER_DEPTH_TEST | RASTER_DEPTH_WRITE | (alphaBlend ? RASTER_BLEND : 0);
+        for (int quad = 0; quad < quadCount; quad++) {
+            const VertexPositionColor* v = vertices + static_cast<size_t>(quad) * 4;
+            float x[4] = { v[0].x, v[1].x, v[2].x, v[3].x };
+            float y[4] = { v[0].y, v[1].y, v[2].y, v[3].y };
+            float z[4] = { v[0].z, v[1].z, v[2].z, v[3].z };
+            submitWorldQuad(x, y, z, v[0].color, flags);
+        }
+        drawCalls += (quadCount + maxQuadsPerBatch - 1) / maxQuadsPerBatch;
+    }
+
+    void DrawCloudMesh(const VertexPositionColor* vertices, int quadCount, const uint16_t* quadIndices [[maybe_unused]],
+                       int maxQuadsPerBatch) override {
+        if (quadCount <= 0) return;
+        resetWorldMatrix();
+        // 云：混合、测试深度但不写入
+        for (int quad = 0; quad < quadCount; quad++) {
+            const VertexPositionColor* v = vertices + static_cast<size_t>(quad) * 4;
+            float x[4] = { v[0].x, v[1].x, v[2].x, v[3].x };
+            float y[4] = { v[0].y, v[1].y, v[2].y, v[3].y };
+            float z[4] = { v[0].z, v[1].z, v[2].z, v[3].z };
+            submitWorldQuad(x, y, z, v[0].color, RASTER_DEPTH_TEST | RASTER_BLEND);
+        }
+        drawCalls += (quadCount + maxQuadsPerBatch - 1) / maxQuadsPerBatch;
+    }
+
+    void DrawSun(Vec3 vertices[4], const Color& color) override {
+        float x[4], y[4], z[4];
+        for (int i = 0; i < 4; i++) {
+            x[i] = vertices[i].x;
+            y[i] = vertices[i].y;
+            z[i] = vertices[i].z;
+        }
+        submitWorldQuad(x, y, z, packVertexColor(color.r, color.g, color.b, color.a),
+                        RASTER_DEPTH_TEST | RASTER_DEPTH_WRITE | RASTER_BLEND);
+        drawCalls++;
+    }
+
+    void DrawLine(int x1, int y1, int x2, int y2, const Color& color) override {
+        // 沿线段方向的1像素宽四边形
+        float dx = static_cast<float>(x2 - x1);
+        float dy = static_cast<float>(y2 - y1);
+        float length = std::sqrt(dx * dx + dy * dy);
+        uint32_t packed = packVertexColor(color.r, color.g, color.b, color.a);
+        if (length < 0.5f) {
+            submitScreenRect(static_cast<float>(x1), static_cast<float>(y1), x1 + 1.0f, y1 + 1.0f, packed);
+        } else {
+            float nx = -dy / length * 0.5f;
+            float ny = dx / length * 0.5f;
+            float ax = x1 + 0.5f, ay = y1 + 0.5f, bx = x2 + 0.5f, by = y2 + 0.5f;
+            float z[3] = { 0.0f, 0.0f, 0.0f };
+            float t1x[3] = { ax + nx, bx + nx, bx - nx }, t1y[3] = { ay + ny, by + ny, by - ny };
+            float t2x[3] = { ax + nx, bx - nx, ax - nx }, t2y[3] = { ay + ny, by - ny, ay - ny };
+            if ((packed >> 24) >= RASTER_ALPHA_REF) {
+                uint8_t flags = (packed >> 24) < 255 ? RASTER_BLEND : 0;
+                submitScreenTriangle(t1x, t1y, z, packed, flags);
+                submitScreenTriangle(t2x, t2y, z, packed, flags);
+            }
+        }
+        drawCalls++;
+    }
+
+    void DrawRect(int x, int y, int w, int h, const Color& color) override {
+        submitScreenRect(static_cast<float>(x), static_cast<float>(y), static_cast<float>(x + w), static_cast<float>(y + h),
+                         packVertexColor(color.r, color.g, color.b, color.a));
+        drawCalls++;
+    }
+
+    void DrawRectOutline(int x, int y, int w, int h, const Color& color) override {
+        uint32_t packed = packVertexColor(color.r, color.g, color.b, color.a);
+        float left = static_cast<float>(x), top = static_cast<float>(y);
+        float right = static_cast<float>(x + w), bottom = static_cast<float>(y + h);
+        submitScreenRect(left, top, right, top + 1.0f, packed);
+        submitScreenRect(left, bottom - 1.0f, right, bottom, packed);
+        submitScreenRect(left, top + 1.0f, left + 1.0f, bottom - 1.0f, packed);
+        submitScreenRect(right - 1.0f, top + 1.0f, right, bottom - 1.0f, packed);
+        drawCalls++;
+    }
+
+    void DrawText(int x [[maybe_unused]], int y [[maybe_unused]], const std::string& text [[maybe_unused]],
+                  const Color& color [[maybe_unused]]) override {
+        drawCalls++;
+    }
+
+    int GetTrianglesRendered() const override { return trianglesRendered; }
+    int GetDrawCalls() const override { return drawCalls; }
+
+    // 本帧经过裁剪、进入分块的三角形数
+    int getBinnedTriangles() const {
+        return static_cast<int>(triangles.size());
+    }
+    
+    int getWorkerCount() const {
+        return static_cast<int>(workers.size());
+    }
+
+    // 某个像素的深度（测试用，EndScene之后有效）
+    float getDepth(int x, int y) const {
+        return depthBuffer[static_cast<size_t>(y) * depthStride + x];
+    }
+};
+
+#endif // RENDER_SOFTWARE_H
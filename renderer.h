@@ -4,10 +4,19 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <memory>
 #include <windows.h>
 #include "math3d.h"
 #include "camera.h"
+#include "frustum.h"
+#include "chunk_view_cache.h"
+#include "occlusion_buffer.h"
+#include "chunk_draw_order.h"
+#include "horizon.h"      // 地平线远景
+#include "cloud_layer.h"  // 云层
 #include "render_gpu.h"  // 添加GPU渲染器头文件
+#include "render_software.h" // 软件光栅化后端
+#include "trace.h"           // 跟踪日志
 
 // 前向声明
 class World;
@@ -72,17 +81,18 @@ class Block {
 public:
     BlockType type;
     bool isVisible;
+    uint8_t faceMask; // 暴露面掩码（第i位对应Face枚举的第i个面），由World的可见性计算维护
     Color customColors[FACE_COUNT]; // 添加自定义颜色数组，为六个面各存储一种颜色
     bool hasCustomColors; // 标记是否使用自定义颜色
     
-    Block() : type(BLOCK_AIR), isVisible(false), hasCustomColors(false) {
+    Block() : type(BLOCK_AIR), isVisible(false), faceMask(0), hasCustomColors(false) {
         // 初始化自定义颜色为默认值（例如灰色）
         for (int i = 0; i < FACE_COUNT; i++) {
             customColors[i] = Color(127, 127, 127);
         }
     }
     
-    Block(BlockType type) : type(type), isVisible(type != BLOCK_AIR), hasCustomColors(false) {
+    Block(BlockType type) : type(type), isVisible(type != BLOCK_AIR), faceMask(type != BLOCK_AIR ? 0x3F : 0), hasCustomColors(false) {
         // 初始化自定义颜色为默认值
         for (int i = 0; i < FACE_COUNT; i++) {
             customColors[i] = Color(127, 127, 127);
@@ -421,14 +431,6 @@ public:
     }
 };
 
-// 云朵结构体
-struct Cloud {
-    Vec3 position;    // 云的位置
-    float width;      // 云的宽度
-    float depth;      // 云的深度
-    float opacity;    // 云的不透明度
-};
-
 // Renderer class
 class Renderer {
 private:
@@ -436,8 +438,9 @@ private:
     int height;
     uint32_t* frameBuffer;
     
-    // 使用GPU渲染器替代CPU渲染
-    GPURenderer gpuRenderer;
+    // 渲染后端：默认是GPU渲染器（Direct3D 9），没有窗口时可用setBackend换成空后端或录制后端
+    std::unique_ptr<RenderBackend> backend;
+    GPURenderer* gpuRenderer; // backend是GPURenderer时指向它，否则为空
     HWND hwnd; // 窗口句柄，用于初始化GPU渲染器
     
     // Whether to enable underground rendering optimization
@@ -446,15 +449,49 @@ private:
     // 渲染距离（方块数）
     int renderDistance = 96;  // 从64增加到96
     
-    // 区块缓存系统 - 保存最近加载的区块信息
-    struct ChunkInfo {
-        int x, y, z;          // 区块坐标
-        float lastSeenTime;   // 最后一次被看到的时间
-        bool inViewFrustum;   // 当前是否在视锥体内
+    // 本帧的视锥体（renderWorld开始时从相机的视图投影矩阵提取一次）
+    Frustum viewFrustum;
+    
+    // 本帧区块级视锥体剔除统计（每遍分别统计，取第一遍）
+    struct FrustumCullStats {
+        int outside = 0;    // 整块跳过的区块
+        int intersect = 0;  // 与边界相交、其中方块仍需检测的区块
+        int inside = 0;     // 完全在视锥体内的区块
+    };
+    FrustumCullStats frustumStats;
+    
+    // 分段可见性图：从相机所在分段沿面连通性广度优先搜索，只绘制能走到的分段
+    bool caveCullingEnabled = true;
+    std::vector<uint8_t> sectionReachable; // 本帧搜索范围内每个分段是否能走到（按x、y、z展开）
+    int reachMinX = 0, reachMinY = 0, reachMinZ = 0;
+    int reachSizeX = 0, reachSizeY = 0, reachSizeZ = 0;
+    bool reachAll = true;                  // 没有做搜索（关闭、X-ray或相机在范围外）时所有分段都算可见
+    
+    // 本帧可见性图统计
+    struct VisibilityGraphStats {
+        int reached = 0; // 搜索走到的分段
+        int culled = 0;  // 在视锥体内但走不到、没有绘制的分段
     };
+    VisibilityGraphStats visibilityStats;
+    
+    // 本帧通过剔除的区块，按到相机的距离排序（复用缓冲，避免每帧分配）
+    std::vector<ChunkDrawItem> visibleChunks;
+    std::vector<ChunkDrawItem> visibleChunksScratch;
+    
+    // 层次Z遮挡剔除：近处分段的实心遮挡盒光栅化到低分辨率深度图，被挡住的区块不提交绘制
+    bool occlusionCullingEnabled = true;
+    OcclusionBuffer occlusionBuffer;
+    OcclusionStats occlusionStats;
+    
+    // 整段背面剔除：相机在区块包围盒某一侧之外时，背向相机的方向整组不提交
+    bool backfaceCullingEnabled = true;
     
-    // 已加载区块的缓存，使用队列管理
-    std::vector<ChunkInfo> loadedChunks;
+    // 远处分段使用降采样的低细节网格
+    bool lodEnabled = true;
+    
+    // 渲染距离之外的地平线远景
+    bool horizonEnabled = true;
+    HorizonRing horizon;
     
     // 区块缓存的最大大小
     const int MAX_CACHED_CHUNKS = 256;
@@ -462,6 +499,9 @@ private:
     // 区块缓存的过期时间（秒）
     const float CHUNK_CACHE_LIFETIME = 3.0f; // 3秒缓存时间
     
+    // 区块缓存系统 - 最近看到的区块在离开渲染距离后继续绘制一段时间（哈希表查找，LRU淘汰）
+    ChunkViewCache chunkCache{MAX_CACHED_CHUNKS};
+    
     // 当前游戏时间
     float gameTime = 0.0f;
     
@@ -480,7 +520,7 @@ private:
     UIManager* uiManager;
     
     // 云和太阳相关成员
-    std::vector<Cloud> clouds;       // 云朵列表
+    CloudLayer cloudLayer;           // 平铺的云层
     Vec3 sunPosition;                // 太阳位置
     float cloudMovementSpeed;        // 云移动速度
     float cloudHeight;               // 云层高度
@@ -489,32 +529,14 @@ private:
 
     // 初始化云
     void initClouds() {
-        // 清空现有云
-        clouds.clear();
-        
         // 设置云层高度
         cloudHeight = 60.0f;
         
         // 设置云移动速度
         cloudMovementSpeed = 0.5f;
         
-        // 生成随机云朵
-        std::mt19937 rng(42); // 使用固定种子以确保云的生成一致
-        std::uniform_real_distribution<float> widthDist(5.0f, 15.0f);
-        std::uniform_real_distribution<float> depthDist(5.0f, 15.0f);
-        std::uniform_real_distribution<float> opacityDist(0.5f, 0.8f);
-        std::uniform_real_distribution<float> xDist(-100.0f, 100.0f);
-        std::uniform_real_distribution<float> zDist(-100.0f, 100.0f);
-        
-        // 生成足够多的云
-        for (int i = 0; i < 100; i++) {
-            Cloud cloud;
-            cloud.position = Vec3(xDist(rng), cloudHeight, zDist(rng));
-            cloud.width = widthDist(rng);
-            cloud.depth = depthDist(rng);
-            cloud.opacity = opacityDist(rng);
-            clouds.push_back(cloud);
-        }
+        // 由固定种子生成平铺的云层占用网格，确保云的形状一致
+        cloudLayer.generate(42u, cloudHeight);
         
         // 初始化太阳位置（放在远处的高空）
         sunPosition = Vec3(500.0f, 200.0f, 500.0f);
@@ -527,52 +549,8 @@ private:
         gameTime = 0.0f;
     }
     
-    // 渲染云
-    void renderClouds(const Camera& camera) {
-        if (!cloudsEnabled) return;
-        
-        // 遍历所有云朵
-        for (const auto& cloud : clouds) {
-            // 计算云朵的边界
-            float halfWidth = cloud.width / 2.0f;
-            float halfDepth = cloud.depth / 2.0f;
-            
-            // 创建云朵的顶部面
-            Vec3 cloudTopVerts[4] = {
-                Vec3(cloud.position.x - halfWidth, cloud.position.y, cloud.position.z - halfDepth),
-                Vec3(cloud.position.x + halfWidth, cloud.position.y, cloud.position.z - halfDepth),
-                Vec3(cloud.position.x + halfWidth, cloud.position.y, cloud.position.z + halfDepth),
-                Vec3(cloud.position.x - halfWidth, cloud.position.y, cloud.position.z + halfDepth)
-            };
-            
-            // 创建云朵的底部面（稍微低一些）
-            Vec3 cloudBottomVerts[4] = {
-                Vec3(cloud.position.x - halfWidth, cloud.position.y - 1.0f, cloud.position.z - halfDepth),
-                Vec3(cloud.position.x + halfWidth, cloud.position.y - 1.0f, cloud.position.z - halfDepth),
-                Vec3(cloud.position.x + halfWidth, cloud.position.y - 1.0f, cloud.position.z + halfDepth),
-                Vec3(cloud.position.x - halfWidth, cloud.position.y - 1.0f, cloud.position.z + halfDepth)
-            };
-            
-            // 创建云的颜色（白色半透明）
-            Color cloudColor(255, 255, 255, static_cast<uint8_t>(cloud.opacity * 255));
-            
-            // 渲染云的顶部和底部面
-            gpuRenderer.DrawCloudFace(cloudTopVerts, cloudColor);
-            gpuRenderer.DrawCloudFace(cloudBottomVerts, cloudColor);
-            
-            // 渲染云的侧面
-            for (int i = 0; i < 4; i++) {
-                int nextI = (i + 1) % 4;
-                Vec3 sideVerts[4] = {
-                    cloudTopVerts[i],
-                    cloudTopVerts[nextI],
-                    cloudBottomVerts[nextI],
-                    cloudBottomVerts[i]
-                };
-                gpuRenderer.DrawCloudFace(sideVerts, cloudColor);
-            }
-        }
-    }
+    // 渲染云：视锥体内的云层合并成一次绘制（在world.h中实现）
+    void renderClouds(const Camera& camera);
     
     // 更新云的位置
     void updateClouds(float deltaTime) {
@@ -581,16 +559,8 @@ private:
         // 更新游戏时间
         gameTime += deltaTime;
         
-        // 移动所有云朵
-        for (auto& cloud : clouds) {
-            // 沿X轴移动云（可以根据需要调整方向）
-            cloud.position.x += cloudMovementSpeed * deltaTime;
-            
-            // 如果云移出了视野范围，将其移到另一侧
-            if (cloud.position.x > 150.0f) {
-                cloud.position.x = -150.0f;
-            }
-        }
+        // 整个云层沿X轴平移（越过一格时下次绘制重新生成网格）
+        cloudLayer.scroll(cloudMovementSpeed * deltaTime);
     }
     
     // 渲染太阳
@@ -619,11 +589,23 @@ private:
         Color sunColor(255, 255, 220, 220);
         
         // 渲染太阳
-        gpuRenderer.DrawSun(sunVerts, sunColor);
+        backend->DrawSun(sunVerts, sunColor);
     }
     
 public:
-    Renderer() : width(0), height(0), frameBuffer(nullptr), hwnd(NULL), uiManager(nullptr) {}
+    Renderer() : width(0), height(0), frameBuffer(nullptr), backend(new GPURenderer()), hwnd(NULL), uiManager(nullptr) {
+        gpuRenderer = static_cast<GPURenderer*>(backend.get());
+    }
+    
+    // 替换渲染后端（需要在初始化前调用）；用于无GPU运行（软件光栅化）或无窗口运行（空后端/录制后端）
+    void setBackend(std::unique_ptr<RenderBackend> newBackend) {
+        backend = std::move(newBackend);
+        gpuRenderer = dynamic_cast<GPURenderer*>(backend.get());
+    }
+    
+    RenderBackend& getBackend() {
+        return *backend;
+    }
     
     // 设置窗口句柄（需要在初始化前调用）
     void setHWND(HWND hwnd) {
@@ -632,7 +614,7 @@ public:
     
     // 绘制线段
     void drawLine(int x1, int y1, int x2, int y2, const Color& color) {
-        gpuRenderer.DrawLine(x1, y1, x2, y2, color);
+        backend->DrawLine(x1, y1, x2, y2, color);
     }
     
     // 初始化渲染器
@@ -640,13 +622,17 @@ public:
         this->width = width;
         this->height = height;
         this->frameBuffer = frameBuffer;
+        backend->SetFrameBuffer(frameBuffer, width, height);
         
-        // 初始化GPU渲染器
-        if (hwnd != NULL) {
-            gpuRenderer.Initialize(hwnd, width, height);
-        }
-        else {
-            MessageBox(NULL, "Window handle not set! GPU rendering will not work.", "Error", MB_OK);
+        // 初始化GPU渲染器（其他后端不需要窗口）
+        if (gpuRenderer) {
+            if (hwnd != NULL) {
+                gpuRenderer->Initialize(hwnd, width, height);
+                traceAdapterInfo();
+            }
+            else {
+                MessageBox(NULL, "Window handle not set! GPU rendering will not work.", "Error", MB_OK);
+            }
         }
         
         // 初始化云和太阳
@@ -659,10 +645,96 @@ public:
         this->height = newHeight;
         this->frameBuffer = newFrameBuffer;
         
-        // 调整GPU渲染器大小
-        gpuRenderer.Resize(newWidth, newHeight);
+        // 调整渲染后端大小
+        backend->Resize(newWidth, newHeight);
+        backend->SetFrameBuffer(newFrameBuffer, newWidth, newHeight);
+    }
+    
+    // 开关分段可见性图剔除
+    void setCaveCullingEnabled(bool enabled) {
+        caveCullingEnabled = enabled;
+    }
+    
+    bool getCaveCullingEnabled() const {
+        return caveCullingEnabled;
+    }
+    
+    const VisibilityGraphStats& getVisibilityStats() const {
+        return visibilityStats;
+    }
+    
+    // 开关层次Z遮挡剔除
+    void setOcclusionCullingEnabled(bool enabled) {
+        occlusionCullingEnabled = enabled;
     }
     
+    bool getOcclusionCullingEnabled() const {
+        return occlusionCullingEnabled;
+    }
+    
+    const OcclusionStats& getOcclusionStats() const {
+        return occlusionStats;
+    }
+    
+    // 开关按朝向分组的背面剔除
+    void setBackfaceCullingEnabled(bool enabled) {
+        backfaceCullingEnabled = enabled;
+    }
+    
+    bool getBackfaceCullingEnabled() const {
+        return backfaceCullingEnabled;
+    }
+    
+    // 开关按距离选择的低细节网格
+    void setLodEnabled(bool enabled) {
+        lodEnabled = enabled;
+    }
+    
+    bool getLodEnabled() const {
+        return lodEnabled;
+    }
+    
+    // 开关地平线远景（关闭时丢弃已生成的地砖）
+    void setHorizonEnabled(bool enabled) {
+        if (horizonEnabled && !enabled) {
+            horizon.clear();
+        }
+        horizonEnabled = enabled;
+    }
+    
+    bool getHorizonEnabled() const {
+        return horizonEnabled;
+    }
+    
+    const HorizonStats& getHorizonStats() const {
+        return horizon.getStats();
+    }
+    
+    const CloudStats& getCloudStats() const {
+        return cloudLayer.getStats();
+    }
+    
+    // 生成并绘制渲染距离之外的地平线远景（在world.h中实现）
+    void renderHorizon(const World& world, const Camera& camera);
+    
+    // 收集本帧的遮挡盒并生成深度金字塔（在world.h中实现）
+    void prepareOcclusion(const World& world, const Camera& camera,
+                          int minChunkX, int maxChunkX, int minChunkY, int maxChunkY, int minChunkZ, int maxChunkZ);
+    
+    // 分段在本帧的可见性图搜索中是否能走到
+    bool isSectionReachable(int chunkX, int sectionY, int chunkZ) const {
+        if (reachAll) return true;
+        int x = chunkX - reachMinX;
+        int y = sectionY - reachMinY;
+        int z = chunkZ - reachMinZ;
+        if (x < 0 || y < 0 || z < 0 || x >= reachSizeX || y >= reachSizeY || z >= reachSizeZ) return false;
+        return sectionReachable[(static_cast<size_t>(z) * reachSizeY + y) * reachSizeX + x] != 0;
+    }
+    
+    // 从相机所在分段出发遍历可见性图，结果由isSectionReachable查询（在world.h中实现）
+    void traverseVisibilityGraph(const World& world, const Camera& camera,
+                                 int minChunkX, int maxChunkX, int minChunkY, int maxChunkY, int minChunkZ, int maxChunkZ);
+    
     // Set underground rendering optimization
     void setOptimizeUndergroundRendering(bool optimize) {
         optimizeUndergroundRendering = optimize;
@@ -677,7 +749,7 @@ public:
     void setRenderDistance(int distance) {
         // 限制渲染距离在合理范围内
         const int MIN_RENDER_DISTANCE = 3;
-        const int MAX_RENDER_DISTANCE = 128;  // 将最大渲染距离从64增大到128
+        const int MAX_RENDER_DISTANCE = 256;  // 远处分段使用低细节网格后，最大渲染距离从128增大到256
         renderDistance = std::max(MIN_RENDER_DISTANCE, std::min(distance, MAX_RENDER_DISTANCE));
     }
     
@@ -735,80 +807,77 @@ public:
     
     // 绘制矩形边框
     void drawRectOutline(int x, int y, int width, int height, const Color& color) {
-        gpuRenderer.DrawRectOutline(x, y, width, height, color);
+        backend->DrawRectOutline(x, y, width, height, color);
     }
     
     // 绘制矩形
     void drawRect(int x, int y, int width, int height, const Color& color) {
-        gpuRenderer.DrawRect(x, y, width, height, color);
+        backend->DrawRect(x, y, width, height, color);
     }
     
     // 绘制文本 - 使用GPU渲染
     void drawText(int x, int y, const std::string& text, const Color& color) {
-        gpuRenderer.DrawText(x, y, text, color);
+        backend->DrawText(x, y, text, color);
     }
     
     // Clear screen
     void clear(const Color& color = Color(135, 206, 235)) { // 默认天空蓝色
         // 开始场景渲染，传入背景颜色
-        gpuRenderer.BeginScene(color);
+        backend->BeginScene(color);
     }
     
     // 渲染世界 - GPU渲染版本
     void renderWorld(const World& world, const Camera& camera);
     
-    // 渲染结束
-    void endFrame() {
-        // 在GPU渲染器上显示统计信息
-        const AdapterInfo& adapterInfo = gpuRenderer.GetAdapterInfo();
-        
-        // 显示GPU信息
-        std::string gpuInfo = "===== GPU Information =====\n";
-        gpuInfo += "Selected GPU: " + std::string(adapterInfo.identifier.Description) + "\n";
-        gpuInfo += "Vendor ID: 0x" + std::to_string(adapterInfo.identifier.VendorId) + "\n";
-        gpuInfo += "Device ID: 0x" + std::to_string(adapterInfo.identifier.DeviceId) + "\n";
-        gpuInfo += "VRAM: " + std::to_string(adapterInfo.vramMB) + " MB\n";
-        gpuInfo += "GPU Type: " + std::string(adapterInfo.isDiscrete ? "Discrete" : "Integrated") + "\n";
-        
-        std::string vendorName = "Unknown";
+    // 初始化后输出一次选中的GPU信息（以前每帧都拼接并输出一遍）
+    void traceAdapterInfo() const {
+        const AdapterInfo& adapterInfo = getGPUAdapterInfo();
+        const char* vendorName = "Unknown";
         if (adapterInfo.isNVIDIA) vendorName = "NVIDIA";
         else if (adapterInfo.isAMD) vendorName = "AMD";
         else if (adapterInfo.isIntel) vendorName = "Intel";
         
-        gpuInfo += "Vendor: " + vendorName + "\n";
-        gpuInfo += "Driver Version: " + std::to_string(adapterInfo.identifier.DriverVersion.QuadPart) + "\n";
-        gpuInfo += "==========================\n";
-        
-        // 在调试输出中打印GPU信息
-        OutputDebugStringA(gpuInfo.c_str());
-        
-        // 获取渲染统计信息并计算帧率
-        static DWORD lastFrameTime = GetTickCount();
-        DWORD currentTime = GetTickCount();
-        static int frameCount = 0;
-        
-        frameCount++;
-        if (currentTime - lastFrameTime >= 1000) {
-            float fps = static_cast<float>(frameCount) * 1000.0f / static_cast<float>(currentTime - lastFrameTime);
-            
-            // 打印帧率和统计信息
-            std::string stats = "FPS: " + std::to_string(static_cast<int>(fps)) + 
-                              " | Triangles: " + std::to_string(gpuRenderer.GetTrianglesRendered()) + 
-                              " | Draw Calls: " + std::to_string(gpuRenderer.GetDrawCalls());
-            
-            OutputDebugStringA(stats.c_str());
+        TRACE(TRACE_GPU, TRACE_LEVEL_INFO, "Selected GPU: %s (%s, %s), Vendor ID: 0x%x, Device ID: 0x%x, VRAM: %u MB, Driver Version: %llu",
+              adapterInfo.identifier.Description, vendorName, adapterInfo.isDiscrete ? "Discrete" : "Integrated",
+              static_cast<unsigned>(adapterInfo.identifier.VendorId), static_cast<unsigned>(adapterInfo.identifier.DeviceId),
+              static_cast<unsigned>(adapterInfo.vramMB), static_cast<unsigned long long>(adapterInfo.identifier.DriverVersion.QuadPart));
+    }
+    
+    // 渲染结束
+    void endFrame() {
+        // 每秒输出一次帧率和绘制统计（跟踪关闭时整段不编译）
+        if (TRACE_ENABLED(TRACE_RENDER, TRACE_LEVEL_INFO)) {
+            static DWORD lastFrameTime = GetTickCount();
+            DWORD currentTime = GetTickCount();
+            static int frameCount = 0;
             
-            lastFrameTime = currentTime;
-            frameCount = 0;
+            frameCount++;
+            if (currentTime - lastFrameTime >= 1000) {
+                float fps = static_cast<float>(frameCount) * 1000.0f / static_cast<float>(currentTime - lastFrameTime);
+                TRACE(TRACE_RENDER, TRACE_LEVEL_INFO, "FPS: %d | Triangles: %d | Draw Calls: %d", static_cast<int>(fps),
+                      backend->GetTrianglesRendered(), backend->GetDrawCalls());
+                
+                // 状态缓存与合批：请求数 -> 实际提交数
+                RenderBatchStats batchStats = backend->GetBatchStats();
+                if (batchStats.drawRequests > 0) {
+                    TRACE(TRACE_RENDER, TRACE_LEVEL_INFO, "Batched draws: %d -> %d | State changes: %d -> %d",
+                          batchStats.drawRequests, batchStats.drawSubmits, batchStats.stateRequests, batchStats.stateChanges);
+                }
+                
+                lastFrameTime = currentTime;
+                frameCount = 0;
+            }
         }
         
+
         // 结束场景渲染
-        gpuRenderer.EndScene();
+        backend->EndScene();
     }
     
-    // 获取GPU适配器信息
+    // 获取GPU适配器信息（非GPU后端返回空信息）
     const AdapterInfo& getGPUAdapterInfo() const {
-        return gpuRenderer.GetAdapterInfo();
+        static const AdapterInfo noAdapter;
+        return gpuRenderer ? gpuRenderer->GetAdapterInfo() : noAdapter;
     }
     
     // 检查方块是否在视锥体内
@@ -861,6 +930,47 @@ public:
         return angleCos > adjustedCos;
     }
     
+    // 检查包围球是否可能在视野内（保守判断：用包含整个视锥体的圆锥，半角取屏幕对角线方向）
+    bool isSphereInViewCone(const Vec3& center, float radius, const Camera& camera) const {
+        Vec3 toCenter = center - camera.position;
+        float distance = toCenter.length();
+        if (distance <= radius) return true;
+        
+        float tanHalfDiagonal = tanf(camera.fov * 0.5f) * sqrtf(1.0f + camera.aspectRatio * camera.aspectRatio);
+        float coneHalfAngle = atanf(tanHalfDiagonal) + asinf(std::min(1.0f, radius / distance));
+        if (coneHalfAngle >= 3.14159f) return true;
+        
+        return toCenter.dot(camera.front) / distance >= cosf(coneHalfAngle);
+    }
+    
+    // 从相机的视图投影矩阵提取本帧的视锥体
+    void updateFrustum(const Camera& camera) {
+        viewFrustum.extract(camera.getViewProjectionMatrix());
+    }
+    
+    const Frustum& getFrustum() const {
+        return viewFrustum;
+    }
+    
+    const FrustumCullStats& getFrustumStats() const {
+        return frustumStats;
+    }
+    
+    // 视锥体剔除基准测试结果
+    struct FrustumBenchmarkResult {
+        int chunks = 0;          // 测试的区块数
+        int coneVisible = 0;     // 旧的圆锥检测保留的区块
+        int planeOutside = 0;    // 平面检测剔除的区块
+        int planeIntersect = 0;  // 平面检测判定为相交的区块
+        int planeInside = 0;     // 平面检测判定为完全在内的区块
+        int planeOnly = 0;       // 平面检测保留而圆锥检测剔除的区块（AABB在视锥体棱角附近偏保守）
+        double coneMs = 0.0;     // 圆锥检测耗时（所有重复）
+        double planeMs = 0.0;    // 提取平面加AABB分类耗时（所有重复）
+    };
+    
+    // 比较旧的包围球圆锥检测与六平面AABB检测：相机周围radiusChunks内的所有区块（在world.h中实现）
+    FrustumBenchmarkResult benchmarkFrustum(const World& world, const Camera& camera, int radiusChunks) const;
+    
     // 更新时间，添加云的更新
     void updateTime(float deltaTime) {
         // 更新游戏时间
@@ -870,59 +980,24 @@ public:
         updateClouds(deltaTime);
     }
     
-    // 清理过期的区块缓存
+    // 清理过期的区块缓存（每帧开始时调用，同时发布上一帧的缓存命中统计）
     void cleanupChunkCache() {
-        // 删除过期的区块
-        loadedChunks.erase(
-            std::remove_if(loadedChunks.begin(), loadedChunks.end(),
-                [this](const ChunkInfo& chunk) {
-                    return gameTime - chunk.lastSeenTime > CHUNK_CACHE_LIFETIME;
-                }
-            ),
-            loadedChunks.end()
-        );
+        chunkCache.beginFrame();
+        chunkCache.expire(gameTime, CHUNK_CACHE_LIFETIME);
     }
     
     // 检查区块是否在缓存中
-    bool isChunkLoaded(int chunkX, int chunkY, int chunkZ) const {
-        for (const auto& chunk : loadedChunks) {
-            if (chunk.x == chunkX && chunk.y == chunkY && chunk.z == chunkZ) {
-                return true;
-            }
-        }
-        return false;
+    bool isChunkLoaded(int chunkX, int chunkY, int chunkZ) {
+        return chunkCache.contains(chunkX, chunkY, chunkZ);
     }
     
-    // 更新区块缓存
+    // 更新区块缓存（缓存满时替换最久没看到的、优先不在视野中的区块）
     void updateChunkCache(int chunkX, int chunkY, int chunkZ, bool inView) {
-        // 尝试更新现有的区块记录
-        for (auto& chunk : loadedChunks) {
-            if (chunk.x == chunkX && chunk.y == chunkY && chunk.z == chunkZ) {
-                chunk.lastSeenTime = gameTime;
-                chunk.inViewFrustum = inView;
-                return;
-            }
-        }
-        
-        // 如果不存在，添加新记录
-        if (loadedChunks.size() < MAX_CACHED_CHUNKS) {
-            loadedChunks.push_back({chunkX, chunkY, chunkZ, gameTime, inView});
-        }
-        else {
-            // 找到最旧的且不在视野中的区块替换
-            auto oldestIt = std::min_element(loadedChunks.begin(), loadedChunks.end(),
-                [this](const ChunkInfo& a, const ChunkInfo& b) {
-                    // 优先考虑不在视野中的区块
-                    if (a.inViewFrustum != b.inViewFrustum) {
-                        return !a.inViewFrustum;
-                    }
-                    return a.lastSeenTime < b.lastSeenTime;
-                });
-                
-            if (oldestIt != loadedChunks.end()) {
-                *oldestIt = {chunkX, chunkY, chunkZ, gameTime, inView};
-            }
-        }
+        chunkCache.touch(chunkX, chunkY, chunkZ, inView, gameTime);
+    }
+    
+    ChunkViewCacheStats getChunkCacheStats() const {
+        return chunkCache.getStats();
     }
     
     // 设置UI管理器
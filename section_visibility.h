@@ -0,0 +1,199 @@
+#ifndef SECTION_VISIBILITY_H
+#define SECTION_VISIBILITY_H
+
+#include <cstdint>
+#include "chunk.h"
+#include "face_mask.h"
+
+// 分段面连通性（洞穴感知的可见性剔除）与实心遮挡盒
+//
+// 生成网格时对分段内的透明格（空气、水、树叶等，与面掩码的透明判断一致）做一次洪水填充：
+// 同一个连通区域碰到的分段边界面两两连通。渲染时从相机所在分段出发广度优先搜索，
+// 只有从进入面到离开面之间有透明通路才继续走到相邻分段，
+// 被石头完全封住的分段和墙后的洞穴不会被访问，也就不会被绘制。
+
+struct SectionVisibility {
+    // links[a]的第b位：从a面进入的视线可以从b面离开（面的编号与Face枚举一致）
+    uint8_t links[FACE_COUNT];
+
+    // 完全连通（空分段，或还没有计算过连通性时的保守假设）
+    static SectionVisibility open() {
+        SectionVisibility visibility;
+        for (int face = 0; face < FACE_COUNT; face++) {
+            visibility.links[face] = FACE_MASK_ALL;
+        }
+        return visibility;
+    }
+
+    // 完全封闭（实心分段）
+    static SectionVisibility closed() {
+        SectionVisibility visibility;
+        for (int face = 0; face < FACE_COUNT; face++) {
+            visibility.links[face] = 0;
+        }
+        return visibility;
+    }
+
+    bool connects(int from, int to) const {
+        return (links[from] >> to) & 1;
+    }
+
+    // 连通的面对数（0~15，F3统计用）
+    int pairCount() const {
+        int count = 0;
+        for (int a = 0; a < FACE_COUNT; a++) {
+            for (int b = a + 1; b < FACE_COUNT; b++) {
+                count += connects(a, b) ? 1 : 0;
+            }
+        }
+        return count;
+    }
+};
+
+// 相对的面（FRONT/BACK、LEFT/RIGHT、TOP/BOTTOM两两相邻编号）
+inline int oppositeFace(int face) {
+    return face ^ 1;
+}
+
+// 面的法线方向（区块坐标的偏移）
+const int FACE_DIRECTIONS[FACE_COUNT][3] = {
+    {  0,  0,  1 }, // FACE_FRONT (z+)
+    {  0,  0, -1 }, // FACE_BACK (z-)
+    { -1,  0,  0 }, // FACE_LEFT (x-)
+    {  1,  0,  0 }, // FACE_RIGHT (x+)
+    {  0,  1,  0 }, // FACE_TOP (y+)
+    {  0, -1,  0 }  // FACE_BOTTOM (y-)
+};
+
+// 局部坐标所在的分段边界面
+inline uint8_t sectionBoundaryFaces(int lx, int ly, int lz) {
+    uint8_t faces = 0;
+    if (lz == CHUNK_SIZE - 1) faces |= faceBit(FACE_FRONT);
+    if (lz == 0) faces |= faceBit(FACE_BACK);
+    if (lx == 0) faces |= faceBit(FACE_LEFT);
+    if (lx == CHUNK_SIZE - 1) faces |= faceBit(FACE_RIGHT);
+    if (ly == CHUNK_SIZE - 1) faces |= faceBit(FACE_TOP);
+    if (ly == 0) faces |= faceBit(FACE_BOTTOM);
+    return faces;
+}
+
+// 洪水填充计算分段的面连通性（只从边界上的透明格出发，不碰边界的封闭空腔不影响结果）
+inline SectionVisibility computeSectionVisibility(const ChunkSection& section) {
+    bool seeThrough[CHUNK_VOLUME];
+    int seeThroughCount = 0;
+    for (int i = 0; i < CHUNK_VOLUME; i++) {
+        seeThrough[i] = isTransparentLookup(section.blocks[i].type);
+        seeThroughCount += seeThrough[i] ? 1 : 0;
+    }
+    if (seeThroughCount == CHUNK_VOLUME) return SectionVisibility::open();
+    if (seeThroughCount == 0) return SectionVisibility::closed();
+
+    SectionVisibility visibility = SectionVisibility::closed();
+    bool visited[CHUNK_VOLUME] = {};
+    uint16_t stack[CHUNK_VOLUME];
+    for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+        for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                int start = ChunkSection::localIndex(lx, ly, lz);
+                if (!seeThrough[start] || visited[start] || sectionBoundaryFaces(lx, ly, lz) == 0) continue;
+
+                // 填充一个连通区域，记录它碰到的边界面
+                uint8_t faces = 0;
+                int top = 0;
+                stack[top++] = static_cast<uint16_t>(start);
+                visited[start] = true;
+                while (top > 0) {
+                    int index = stack[--top];
+                    int cx = index & CHUNK_MASK;
+                    int cy = (index >> CHUNK_SHIFT) & CHUNK_MASK;
+                    int cz = index >> (CHUNK_SHIFT * 2);
+                    faces |= sectionBoundaryFaces(cx, cy, cz);
+                    for (int face = 0; face < FACE_COUNT; face++) {
+                        int nx = cx + FACE_DIRECTIONS[face][0];
+                        int ny = cy + FACE_DIRECTIONS[face][1];
+                        int nz = cz + FACE_DIRECTIONS[face][2];
+                        if (nx < 0 || ny < 0 || nz < 0 || nx >= CHUNK_SIZE || ny >= CHUNK_SIZE || nz >= CHUNK_SIZE) continue;
+                        int neighbor = ChunkSection::localIndex(nx, ny, nz);
+                        if (!seeThrough[neighbor] || visited[neighbor]) continue;
+                        visited[neighbor] = true;
+                        stack[top++] = static_cast<uint16_t>(neighbor);
+                    }
+                }
+
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    if (faces & (1 << face)) {
+                        visibility.links[face] |= faces;
+                    }
+                }
+            }
+        }
+    }
+    return visibility;
+}
+
+// 分段内保守的实心遮挡盒（局部坐标，max不含）：遮挡剔除时光栅化到低分辨率深度缓冲
+// 取从六个面各自向内连续的完整实心层中最厚的一块，盒内每一格都不透光
+struct SectionOccluder {
+    uint8_t min[3] = { 0, 0, 0 };
+    uint8_t max[3] = { 0, 0, 0 };
+
+    bool isEmpty() const {
+        return max[0] <= min[0] || max[1] <= min[1] || max[2] <= min[2];
+    }
+
+    int volume() const {
+        return isEmpty() ? 0 : (max[0] - min[0]) * (max[1] - min[1]) * (max[2] - min[2]);
+    }
+};
+
+// 能挡住视线的方块：与连通性一致按类型判断，另外带半透明自定义颜色的可变方块也不算
+inline bool isOccludingBlock(const Block& block) {
+    if (isTransparentLookup(block.type)) return false;
+    if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
+        for (int face = 0; face < FACE_COUNT; face++) {
+            if (block.customColors[face].a < 255) return false;
+        }
+    }
+    return true;
+}
+
+inline SectionOccluder computeSectionOccluder(const ChunkSection& section) {
+    // 每个轴上每一层的实心格数，等于CHUNK_SIZE^2的层是完整的
+    int layerSolid[3][CHUNK_SIZE] = {};
+    for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+        for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                if (!isOccludingBlock(section.blocks[ChunkSection::localIndex(lx, ly, lz)])) continue;
+                layerSolid[0][lx]++;
+                layerSolid[1][ly]++;
+                layerSolid[2][lz]++;
+            }
+        }
+    }
+
+    SectionOccluder best;
+    const int fullLayer = CHUNK_SIZE * CHUNK_SIZE;
+    for (int axis = 0; axis < 3; axis++) {
+        int low = 0;
+        while (low < CHUNK_SIZE && layerSolid[axis][low] == fullLayer) low++;
+        int high = 0;
+        while (high < CHUNK_SIZE && layerSolid[axis][CHUNK_SIZE - 1 - high] == fullLayer) high++;
+
+        for (int side = 0; side < 2; side++) {
+            int thickness = side == 0 ? low : high;
+            if (thickness * fullLayer <= best.volume()) continue;
+            for (int i = 0; i < 3; i++) {
+                best.min[i] = 0;
+                best.max[i] = CHUNK_SIZE;
+            }
+            if (side == 0) {
+                best.max[axis] = static_cast<uint8_t>(thickness);
+            } else {
+                best.min[axis] = static_cast<uint8_t>(CHUNK_SIZE - thickness);
+            }
+        }
+    }
+    return best;
+}
+
+#endif // SECTION_VISIBILITY_H
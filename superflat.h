@@ -0,0 +1,112 @@
+#ifndef SUPERFLAT_H
+#define SUPERFLAT_H
+
+#include <vector>
+#include "chunk.h"
+
+// 超平坦世界的层列表
+//
+// 超平坦世界的每个方块只取决于它的高度（以及有限世界中是否位于水平边界），
+// 因此不需要为整个世界分配方块：未编辑的区块列直接由层列表解析得出，
+// 只有玩家编辑过的区块列才会真正分配分段存储。
+
+// 侧面（前/后/左/右）在Face枚举中是低4位
+const uint8_t FLAT_SIDE_FACES = 0x0F;
+const int FLAT_EDGE_VARIANTS = 16;
+
+// 一层方块：从下往上依次堆叠
+struct FlatLayer {
+    BlockType type;
+    int thickness;
+
+    FlatLayer(BlockType t = BLOCK_AIR, int n = 1) : type(t), thickness(n) {}
+};
+
+class SuperFlatLayers {
+private:
+    std::vector<FlatLayer> layers;
+    // 按高度预先计算好的方块：每个高度16种变体，对应有限世界水平边界外的四个侧面
+    // （侧面在Face枚举中正好是低4位，变体下标就是边界侧面的掩码）
+    std::vector<Block> blocks;
+    int worldHeight = 0;
+    Block airBlock;
+
+public:
+    SuperFlatLayers() : airBlock(BLOCK_AIR) {}
+
+    // 设置层列表并按世界高度预计算每一层的方块和可见性
+    void build(const std::vector<FlatLayer>& newLayers, int newWorldHeight) {
+        layers = newLayers;
+
+        std::vector<BlockType> types(newWorldHeight, BLOCK_AIR);
+        int y = 0;
+        for (const FlatLayer& layer : layers) {
+            for (int i = 0; i < layer.thickness && y < newWorldHeight; i++, y++) {
+                types[y] = layer.type;
+            }
+        }
+
+        worldHeight = newWorldHeight;
+        blocks.assign(static_cast<size_t>(worldHeight) * FLAT_EDGE_VARIANTS, Block(BLOCK_AIR));
+        for (y = 0; y < worldHeight; y++) {
+            BlockType type = types[y];
+            if (type == BLOCK_AIR) {
+                continue;
+            }
+
+            // 与World::updateBlockVisibilityAt的规则一致：顶部/底部、上下相邻透明时暴露；
+            // 水平相邻是同种方块，自身透明时四个侧面都暴露
+            uint8_t mask = 0;
+            if (y == worldHeight - 1 || isTransparentBlockType(types[y + 1])) mask |= 1u << FACE_TOP;
+            if (y == 0 || isTransparentBlockType(types[y - 1])) mask |= 1u << FACE_BOTTOM;
+            if (isTransparentBlockType(type)) mask |= FLAT_SIDE_FACES;
+            bool alwaysVisible = type == BLOCK_WATER || type == BLOCK_LEAVES || type == BLOCK_LAVA;
+
+            for (int edge = 0; edge < FLAT_EDGE_VARIANTS; edge++) {
+                Block& block = blocks[static_cast<size_t>(y) * FLAT_EDGE_VARIANTS + edge];
+                block = Block(type);
+                block.faceMask = static_cast<uint8_t>(mask | edge);
+                block.isVisible = block.faceMask != 0 || alwaysVisible;
+            }
+        }
+    }
+
+    // 单层超平坦（原来的超平坦世界：Y=0处一层方块）
+    void buildSingleLayer(BlockType type, int worldHeight) {
+        build(std::vector<FlatLayer>(1, FlatLayer(type, 1)), worldHeight);
+    }
+
+    void clear() {
+        layers.clear();
+        blocks.clear();
+        worldHeight = 0;
+    }
+
+    bool isEmpty() const {
+        return blocks.empty();
+    }
+
+    // 解析某一高度的方块；edgeFaces为位于世界边界外的侧面掩码（无限世界为0）
+    const Block& blockAt(int y, uint8_t edgeFaces) const {
+        if (y < 0 || y >= worldHeight) {
+            return airBlock;
+        }
+        return blocks[static_cast<size_t>(y) * FLAT_EDGE_VARIANTS + (edgeFaces & FLAT_SIDE_FACES)];
+    }
+
+    // 最高的非空气层（没有方块时返回-1）
+    int getTopY() const {
+        for (int y = worldHeight - 1; y >= 0; y--) {
+            if (blocks[static_cast<size_t>(y) * FLAT_EDGE_VARIANTS].type != BLOCK_AIR) {
+                return y;
+            }
+        }
+        return -1;
+    }
+
+    const std::vector<FlatLayer>& getLayers() const {
+        return layers;
+    }
+};
+
+#endif // SUPERFLAT_H
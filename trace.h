@@ -0,0 +1,227 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <cstdint>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 编译期开关的跟踪日志
+//
+// TRACE(分类, 级别, printf格式, ...)：分类不在TRACE_CATEGORIES中、或级别高于TRACE_MAX_LEVEL的跟踪，
+// 条件在编译期就是false，整条语句连同参数的求值都被编译器删掉，发布版的渲染热路径上没有任何开销。
+// 打开的跟踪直接格式化进当前线程自己的环形缓冲区（单生产者单消费者，写入不加锁、不分配内存），
+// 由后台线程定期取出写到调试输出和标准输出；缓冲区满时丢弃新记录并计数，不阻塞调用方。
+// 线程第一次写跟踪时登记自己的缓冲区（只有这一次加锁），缓冲区在程序结束前一直保留。
+//
+// 编译时用 /DTRACE_CATEGORIES=... /DTRACE_MAX_LEVEL=... 覆盖默认值：
+// 调试版默认打开所有分类的INFO及以下级别，发布版（NDEBUG）默认全部关闭。
+
+// 分类（位掩码）
+#define TRACE_RENDER 0x01 // 每秒的帧率、绘制统计
+#define TRACE_WORLD  0x02 // 世界渲染、剔除统计
+#define TRACE_MESH   0x04 // 后台网格生成
+#define TRACE_GPU    0x08 // 适配器检测、设备信息
+#define TRACE_ALL    0xFF
+
+// 级别（数字越大越详细）
+#define TRACE_LEVEL_ERROR 1
+#define TRACE_LEVEL_WARN  2
+#define TRACE_LEVEL_INFO  3
+#define TRACE_LEVEL_DEBUG 4
+
+#ifndef TRACE_CATEGORIES
+#ifdef NDEBUG
+#define TRACE_CATEGORIES 0
+#else
+#define TRACE_CATEGORIES TRACE_ALL
+#endif
+#endif
+
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL TRACE_LEVEL_INFO
+#endif
+
+// 编译期常量：这个分类和级别的跟踪是否编译进程序
+#define TRACE_ENABLED(category, level) (((TRACE_CATEGORIES) & (category)) != 0 && (level) <= (TRACE_MAX_LEVEL))
+
+#define TRACE(category, level, ...) \
+    do { \
+        if (TRACE_ENABLED(category, level)) traceWrite((category), (level), __VA_ARGS__); \
+    } while (0)
+
+enum {
+    TRACE_MESSAGE_SIZE = 240,   // 单条消息的最大长度（超出截断）
+    TRACE_RING_CAPACITY = 1024, // 每个线程的缓冲区记录数（2的幂）
+    TRACE_DRAIN_INTERVAL_MS = 20
+};
+
+struct TraceRecord {
+    uint64_t timeMicros = 0; // 从第一条跟踪开始的微秒数
+    uint32_t threadIndex = 0;
+    uint8_t category = 0;
+    uint8_t level = 0;
+    char message[TRACE_MESSAGE_SIZE];
+};
+
+// 一个线程的环形缓冲区：只有所属线程写head，只有后台线程写tail
+class TraceRing {
+private:
+    TraceRecord records[TRACE_RING_CAPACITY];
+    std::atomic<uint32_t> head{ 0 };
+    std::atomic<uint32_t> tail{ 0 };
+    std::atomic<uint32_t> dropped{ 0 };
+
+public:
+    const uint32_t threadIndex;
+
+    explicit TraceRing(uint32_t index) : threadIndex(index) {}
+
+    // 缓冲区满时返回空（调用方丢弃这条记录）
+    TraceRecord* beginWrite() {
+        uint32_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) >= TRACE_RING_CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &records[writeIndex & (TRACE_RING_CAPACITY - 1)];
+    }
+
+    void endWrite() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 后台线程：取出所有已写完的记录
+    template <typename Sink>
+    void drain(Sink& sink) {
+        uint32_t readIndex = tail.load(std::memory_order_relaxed);
+        uint32_t writeIndex = head.load(std::memory_order_acquire);
+        for (; readIndex != writeIndex; readIndex++) {
+            sink(records[readIndex & (TRACE_RING_CAPACITY - 1)]);
+        }
+        tail.store(readIndex, std::memory_order_release);
+    }
+
+    uint32_t takeDropped() {
+        return dropped.exchange(0, std::memory_order_relaxed);
+    }
+};
+
+// 缓冲区登记表和后台输出线程
+class TraceSystem {
+private:
+    std::mutex mutex;                              // 保护rings（登记新线程、后台线程遍历）
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    std::thread sinkThread;
+    std::atomic<bool> running{ false };
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    static const char* levelName(uint8_t level) {
+        switch (level) {
+            case TRACE_LEVEL_ERROR: return "ERROR";
+            case TRACE_LEVEL_WARN: return "WARN";
+            case TRACE_LEVEL_INFO: return "INFO";
+            default: return "DEBUG";
+        }
+    }
+
+    static void emit(const char* line) {
+#ifdef _WIN32
+        OutputDebugStringA(line);
+#endif
+        std::fputs(line, stdout);
+    }
+
+    void drainAll() {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto sink = [](const TraceRecord& record) {
+            char line[TRACE_MESSAGE_SIZE + 48];
+            std::snprintf(line, sizeof(line), "[%8.3f] [T%u] %s: %s\n", record.timeMicros / 1000000.0,
+                          record.threadIndex, levelName(record.level), record.message);
+            emit(line);
+        };
+        for (auto& ring : rings) {
+            ring->drain(sink);
+            uint32_t dropped = ring->takeDropped();
+            if (dropped > 0) {
+                char line[64];
+                std::snprintf(line, sizeof(line), "[trace] T%u dropped %u records\n", ring->threadIndex, dropped);
+                emit(line);
+            }
+        }
+        std::fflush(stdout);
+    }
+
+    void run() {
+        while (running.load(std::memory_order_acquire)) {
+            drainAll();
+            std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_DRAIN_INTERVAL_MS));
+        }
+        drainAll();
+    }
+
+public:
+    static TraceSystem& instance() {
+        static TraceSystem system;
+        return system;
+    }
+
+    ~TraceSystem() {
+        shutdown();
+    }
+
+    // 当前线程的缓冲区（第一次调用时登记，并在需要时启动后台线程）
+    TraceRing& threadRing() {
+        thread_local TraceRing* ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(std::unique_ptr<TraceRing>(new TraceRing(static_cast<uint32_t>(rings.size()))));
+            ring = rings.back().get();
+            if (!running.exchange(true)) {
+                sinkThread = std::thread(&TraceSystem::run, this);
+            }
+        }
+        return *ring;
+    }
+
+    uint64_t elapsedMicros() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+    }
+
+    // 停止后台线程并输出剩余的记录（程序退出前调用；没有打开任何跟踪时什么也不做）
+    void shutdown() {
+        if (running.exchange(false) && sinkThread.joinable()) {
+            sinkThread.join();
+        }
+    }
+};
+
+inline void traceWrite(int category, int level, const char* format, ...) {
+    TraceRing& ring = TraceSystem::instance().threadRing();
+    TraceRecord* record = ring.beginWrite();
+    if (!record) return;
+    record->timeMicros = TraceSystem::instance().elapsedMicros();
+    record->threadIndex = ring.threadIndex;
+    record->category = static_cast<uint8_t>(category);
+    record->level = static_cast<uint8_t>(level);
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record->message, sizeof(record->message), format, args);
+    va_end(args);
+    ring.endWrite();
+}
+
+inline void traceShutdown() {
+    if (TRACE_CATEGORIES != 0) TraceSystem::instance().shutdown();
+}
+
+#endif // TRACE_H
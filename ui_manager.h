@@ -273,6 +273,27 @@ private:
     int worldDepth = 0;
     unsigned int worldSeedValue = 0;
     
+    // 区块驻留统计（由外部每帧设置）
+    ChunkResidencyStats residencyStats;
+    
+    // 分段网格统计（由外部每帧设置）
+    ChunkMeshStats meshStats;
+    ChunkViewCacheStats chunkCacheStats;
+    
+    // 层次Z遮挡剔除统计（由外部每帧设置）
+    OcclusionStats occlusionStats;
+    
+    // 地平线远景统计（由外部每帧设置）
+    HorizonStats horizonStats;
+    
+    // 云层统计（由外部每帧设置）
+    CloudStats cloudStats;
+    
+    // 无限世界流式加载统计（由外部每帧设置）
+    int streamLoadedColumns = 0;
+    int streamPendingColumns = 0;
+    int streamUnloadedColumns = 0;
+    
     // 保存提示相关
     bool showSavePrompt = false; // 是否显示保存提示
     std::string savePromptText = ""; // 保存提示文本
@@ -1210,7 +1231,7 @@ public:
     // 获取实际渲染距离（方块数）
     int getActualRenderDistance() const {
         const int MIN_RENDER_DISTANCE = 16;
-        const int MAX_RENDER_DISTANCE = 128;  // 将最大渲染距离从16增加到128
+        const int MAX_RENDER_DISTANCE = 256;  // 远处分段使用低细节网格后，最大渲染距离从128增加到256
         return MIN_RENDER_DISTANCE + static_cast<int>((MAX_RENDER_DISTANCE - MIN_RENDER_DISTANCE) * renderDistanceValue);
     }
     
@@ -1249,9 +1270,34 @@ public:
         return debugInfoEnabled;
     }
     
-    // 获取多线程渲染状态
+    // 获取多线程网格生成状态
     bool getMultiThreadingEnabled() const {
-        return false;
+        return multiThreadingEnabled;
+    }
+    
+    // 获取分段可见性图剔除状态
+    bool getCaveCullingEnabled() const {
+        return caveCullingEnabled;
+    }
+    
+    // 获取层次Z遮挡剔除状态
+    bool getOcclusionCullingEnabled() const {
+        return occlusionCullingEnabled;
+    }
+    
+    // 获取按朝向分组的背面剔除状态
+    bool getBackfaceCullingEnabled() const {
+        return backfaceCullingEnabled;
+    }
+    
+    // 获取远处分段低细节网格的开关状态
+    bool getLodEnabled() const {
+        return lodEnabled;
+    }
+    
+    // 获取地平线远景的开关状态
+    bool getHorizonEnabled() const {
+        return horizonEnabled;
     }
     
     // 绘制完整物品栏（显示所有方块）
@@ -1759,6 +1805,24 @@ public:
     // 调试信息显示
     bool debugInfoEnabled = false;
     
+    // 是否在后台线程生成分段网格（/multithreading命令切换）
+    bool multiThreadingEnabled = true;
+    
+    // 是否按分段连通性剔除被岩石挡住的分段（/caveculling命令切换）
+    bool caveCullingEnabled = true;
+    
+    // 是否用低分辨率深度图剔除被近处地形挡住的区块（/occlusion命令切换）
+    bool occlusionCullingEnabled = true;
+    
+    // 是否跳过整组背向相机的方块面（/backface命令切换）
+    bool backfaceCullingEnabled = true;
+    
+    // 是否对远处的分段使用降采样的低细节网格（/lod命令切换）
+    bool lodEnabled = true;
+    
+    // 是否在渲染距离之外绘制地平线远景（/horizon命令切换）
+    bool horizonEnabled = true;
+    
     // 初始化选项菜单 - 动态适应窗口大小
     void initOptionsMenu() {
         // 清除旧的滑块
@@ -2069,6 +2133,14 @@ public:
                 renderer.drawText(labelX, labelY, volumeText, Color(220, 220, 220));
                 renderer.drawText(labelX + volumeText.length() * 8 + 10, labelY, percentText, Color(180, 180, 180));
             }
+            
+            // 世界大小滑块显示实际尺寸，拉到最大时为无限世界
+            if (slider.text == "World Size") {
+                std::string sizeText = getInfiniteWorld() ? "Infinite" : std::to_string(getActualWorldSize());
+                int labelX = slider.x + slider.width + 15;
+                int labelY = slider.y + (slider.height - 15) / 2;
+                renderer.drawText(labelX, labelY, sizeText, Color(220, 220, 220));
+            }
         }
         
         // 种子输入框相关元素
@@ -2625,14 +2697,122 @@ public:
                 std::string worldText = "World Size: " + std::to_string(worldWidth) + "x" + 
                                       std::to_string(worldHeight) + "x" + 
                                       std::to_string(worldDepth);
+                if (worldWidth == 0 && worldDepth == 0) {
+                    // 无限世界没有水平边界
+                    worldText = "World Size: Infinite (Height " + std::to_string(worldHeight) + ")";
+                }
                 drawText(renderer, worldText, 10, currentY, Color(255, 255, 255));
                 currentY += lineHeight;
                 
+                // 无限世界的流式加载信息
+                if (worldWidth == 0 && worldDepth == 0) {
+                    std::string streamText = "Streaming: Loaded " + std::to_string(streamLoadedColumns) +
+                                           " Pending " + std::to_string(streamPendingColumns) +
+                                           " Unloaded(edited) " + std::to_string(streamUnloadedColumns);
+                    drawText(renderer, streamText, 10, currentY, Color(255, 255, 255));
+                    currentY += lineHeight;
+                }
+                
                 // 添加世界种子信息
                 std::string seedText = "World Seed: " + std::to_string(worldSeedValue);
                 drawText(renderer, seedText, 10, currentY, Color(255, 255, 255));
                 currentY += lineHeight;
                 
+                // 区块驻留信息：常驻/冷分段数量与内存占用
+                std::string residencyText = "Chunks: Resident " + std::to_string(residencyStats.residentSections) +
+                                          " (" + std::to_string(residencyStats.residentBytes / (1024 * 1024)) + "/" +
+                                          std::to_string(residencyStats.budgetBytes / (1024 * 1024)) + " MB)" +
+                                          " Cold " + std::to_string(residencyStats.coldSections) +
+                                          " (" + std::to_string(residencyStats.coldBytes / 1024) + " KB)";
+                drawText(renderer, residencyText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 分段去重：实际存在的缓冲区数与去重比例（引用数/缓冲区数）
+                int dedupeRatio100 = residencyStats.uniqueSections > 0 ?
+                    residencyStats.residentSections * 100 / residencyStats.uniqueSections : 100;
+                std::string dedupeFraction = std::to_string(dedupeRatio100 % 100);
+                if (dedupeFraction.size() < 2) dedupeFraction = "0" + dedupeFraction;
+                std::string dedupeText = "Dedupe: Unique " + std::to_string(residencyStats.uniqueSections) +
+                                       " (" + std::to_string(residencyStats.uniqueBytes / (1024 * 1024)) + " MB)" +
+                                       " Ratio " + std::to_string(dedupeRatio100 / 100) + "." + dedupeFraction + ":1" +
+                                       " Shared " + std::to_string(residencyStats.internShared);
+                drawText(renderer, dedupeText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                std::string residencyCountText = "Residency: Hit " + std::to_string(residencyStats.hits) +
+                                               " Miss " + std::to_string(residencyStats.misses) +
+                                               " Decompress " + std::to_string(residencyStats.decompressions) +
+                                               " Compress " + std::to_string(residencyStats.compressions);
+                drawText(renderer, residencyCountText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 分段网格：缓存的网格数、上一帧重建数与绘制量
+                std::string meshText = "Meshes: Cached " + std::to_string(meshStats.cachedMeshes) +
+                                     " (" + std::to_string(meshStats.cachedQuads) + " quads / " +
+                                     std::to_string(meshStats.cachedFaces) + " faces" +
+                                     (meshStats.greedy ? ", greedy)" : ")") +
+                                     " Rebuilt " + std::to_string(meshStats.rebuilds) +
+                                     (meshStats.threaded ? " (threads, " + std::to_string(meshStats.pendingJobs) + " pending)" : "") +
+                                     " Drawn " + std::to_string(meshStats.drawnMeshes) +
+                                     " (" + std::to_string(meshStats.drawnQuads) + " quads)" +
+                                     " Sorted " + std::to_string(meshStats.transparentSorts);
+                drawText(renderer, meshText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 渲染器区块缓存：大小与上一帧的命中率
+                int cacheHitRate = chunkCacheStats.frameLookups > 0 ?
+                    chunkCacheStats.frameHits * 100 / chunkCacheStats.frameLookups : 0;
+                std::string chunkCacheText = "Chunk cache: " + std::to_string(chunkCacheStats.size) + "/" +
+                                           std::to_string(chunkCacheStats.capacity) +
+                                           " Hit " + std::to_string(cacheHitRate) + "% (" +
+                                           std::to_string(chunkCacheStats.frameHits) + "/" +
+                                           std::to_string(chunkCacheStats.frameLookups) + ")" +
+                                           " Evicted " + std::to_string(chunkCacheStats.evictions) +
+                                           " Expired " + std::to_string(chunkCacheStats.expirations);
+                drawText(renderer, chunkCacheText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 层次Z遮挡剔除：本帧被挡住的区块数
+                std::string occlusionText = "Occlusion: culled " + std::to_string(occlusionStats.culled) + "/" +
+                                          std::to_string(occlusionStats.tested) + " chunks, " +
+                                          std::to_string(occlusionStats.occluders) + " occluders";
+                drawText(renderer, occlusionText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 背面剔除：跳过的不透明四边形数，绘制的四边形按朝向（+Z -Z -X +X +Y -Y）的分布
+                std::string backfaceText = "Backface: skipped " + std::to_string(meshStats.backfaceCulledQuads) + " quads, drawn";
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    backfaceText += " " + std::to_string(meshStats.drawnQuadsByFace[face]);
+                }
+                drawText(renderer, backfaceText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 细节级别：上一帧绘制的四边形按级别（1x 2x 4x 8x）的分布
+                std::string lodText = "LOD: drawn";
+                for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                    lodText += " " + std::to_string(meshStats.drawnQuadsByLod[lod]);
+                }
+                lodText += lodEnabled ? " quads" : " quads (off)";
+                drawText(renderer, lodText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 地平线远景：缓存的地砖、本帧绘制的地砖和四边形、本帧重新生成的地砖
+                std::string horizonText = "Horizon: " + std::to_string(horizonStats.drawnTiles) + "/" +
+                                          std::to_string(horizonStats.tiles) + " tiles, " +
+                                          std::to_string(horizonStats.drawnQuads) + " quads, " +
+                                          std::to_string(horizonStats.builds) + " rebuilt";
+                drawText(renderer, horizonText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+
+                // 云层：本帧绘制的块和四边形、网格的四边形数、网格累计重新生成的次数
+                std::string cloudText = "Clouds: " + std::to_string(cloudStats.drawnBlocks) + "/" +
+                                        std::to_string(cloudStats.blocks) + " blocks, " +
+                                        std::to_string(cloudStats.drawnQuads) + "/" +
+                                        std::to_string(cloudStats.quads) + " quads, " +
+                                        std::to_string(cloudStats.rebuilds) + " rebuilds";
+                drawText(renderer, cloudText, 10, currentY, Color(255, 255, 255));
+                currentY += lineHeight;
+                
                 // 添加当前方块类型信息
                 std::string blockText;
                 // 正确转换BlockType到ItemType
@@ -2785,6 +2965,11 @@ public:
         return worldSizeValue;
     }
     
+    // 世界大小滑块拉到最大时创建无限世界
+    bool getInfiniteWorld() const {
+        return worldSizeValue >= 0.99f;
+    }
+    
     // 获取实际世界大小
     int getActualWorldSize() const {
         // 根据世界大小滑块值计算实际世界大小
@@ -3144,6 +3329,43 @@ public:
         worldSeedValue = seed;
     }
     
+    // 设置无限世界流式加载统计（由外部每帧调用）
+    void setStreamingStats(int loadedColumns, int pendingColumns, int unloadedColumns) {
+        streamLoadedColumns = loadedColumns;
+        streamPendingColumns = pendingColumns;
+        streamUnloadedColumns = unloadedColumns;
+    }
+    
+    // 设置区块驻留统计（由外部每帧调用）
+    void setResidencyStats(const ChunkResidencyStats& stats) {
+        residencyStats = stats;
+    }
+    
+    // 设置分段网格统计（由外部每帧调用）
+    void setMeshStats(const ChunkMeshStats& stats) {
+        meshStats = stats;
+    }
+    
+    // 设置渲染器区块缓存统计（由外部每帧调用）
+    void setChunkCacheStats(const ChunkViewCacheStats& stats) {
+        chunkCacheStats = stats;
+    }
+    
+    // 设置层次Z遮挡剔除统计（由外部每帧调用）
+    void setOcclusionStats(const OcclusionStats& stats) {
+        occlusionStats = stats;
+    }
+    
+    // 设置地平线远景统计（由外部每帧调用）
+    void setHorizonStats(const HorizonStats& stats) {
+        horizonStats = stats;
+    }
+    
+    // 设置云层统计（由外部每帧调用）
+    void setCloudStats(const CloudStats& stats) {
+        cloudStats = stats;
+    }
+    
     // 绘制方块编辑器UI
     void drawBlockEditor(Renderer& renderer) {
         // 计算编辑器窗口尺寸和位置
@@ -3878,12 +4100,71 @@ public:
             executeHelpCommand();
         } else if (cmd == "fill") {
             executeFillCommand(iss);
+        } else if (cmd == "benchmark") {
+            executeBenchmarkCommand(iss);
+        } else if (cmd == "multithreading") {
+            executeMultiThreadingCommand(iss);
+        } else if (cmd == "caveculling") {
+            executeCaveCullingCommand(iss);
+        } else if (cmd == "occlusion") {
+            executeOcclusionCommand(iss);
+        } else if (cmd == "backface") {
+            executeBackfaceCommand(iss);
+        } else if (cmd == "lod") {
+            executeLodCommand(iss);
+        } else if (cmd == "horizon") {
+            executeHorizonCommand(iss);
+        } else if (cmd == "locate") {
+            executeLocateCommand(iss);
         } else {
             // 未知命令
             addSystemMessage("Unknown command: /" + cmd);
         }
     }
     
+    // 按名称匹配方块类型（名称需为小写），setblock、fill、locate命令共用
+    static bool parseBlockName(const std::string& name, BlockType& type) {
+        bool found = false;
+        if (name == "dirt") type = BLOCK_DIRT, found = true;
+        else if (name == "grass") type = BLOCK_GRASS, found = true;
+        else if (name == "stone") type = BLOCK_STONE, found = true;
+        else if (name == "sand") type = BLOCK_SAND, found = true;
+        else if (name == "wood") type = BLOCK_WOOD, found = true;
+        else if (name == "leaves") type = BLOCK_LEAVES, found = true;
+        else if (name == "coal" || name == "coal_ore") type = BLOCK_COAL_ORE, found = true;
+        else if (name == "iron" || name == "iron_ore") type = BLOCK_IRON_ORE, found = true;
+        else if (name == "gold" || name == "gold_ore") type = BLOCK_GOLD_ORE, found = true;
+        else if (name == "diamond" || name == "diamond_ore") type = BLOCK_DIAMOND_ORE, found = true;
+        else if (name == "bedrock") type = BLOCK_BEDROCK, found = true;
+        else if (name == "obsidian") type = BLOCK_OBSIDIAN, found = true;
+        else if (name == "lava") type = BLOCK_LAVA, found = true;
+        else if (name == "redstone" || name == "redstone_ore") type = BLOCK_REDSTONE_ORE, found = true;
+        else if (name == "emerald" || name == "emerald_ore") type = BLOCK_EMERALD_ORE, found = true;
+        else if (name == "mossy_stone") type = BLOCK_MOSSY_STONE, found = true;
+        else if (name == "gravel") type = BLOCK_GRAVEL, found = true;
+        else if (name == "clay") type = BLOCK_CLAY, found = true;
+        else if (name == "ice") type = BLOCK_ICE, found = true;
+        else if (name == "snow") type = BLOCK_SNOW, found = true;
+        else if (name == "water") type = BLOCK_WATER, found = true;
+        else if (name == "sandstone") type = BLOCK_SANDSTONE, found = true;
+        else if (name == "cactus") type = BLOCK_CACTUS, found = true;
+        else if (name == "pumpkin") type = BLOCK_PUMPKIN, found = true;
+        else if (name == "netherrack") type = BLOCK_NETHERRACK, found = true;
+        else if (name == "soul_sand") type = BLOCK_SOUL_SAND, found = true;
+        else if (name == "quartz") type = BLOCK_QUARTZ, found = true;
+        else if (name == "glowstone") type = BLOCK_GLOWSTONE, found = true;
+        else if (name == "mycelium") type = BLOCK_MYCELIUM, found = true;
+        else if (name == "end_stone") type = BLOCK_END_STONE, found = true;
+        else if (name == "prismarine") type = BLOCK_PRISMARINE, found = true;
+        else if (name == "magma") type = BLOCK_MAGMA, found = true;
+        else if (name == "nether_wart") type = BLOCK_NETHER_WART, found = true;
+        else if (name == "slime") type = BLOCK_SLIME, found = true;
+        else if (name == "brick") type = BLOCK_BRICK, found = true;
+        else if (name == "bookshelf") type = BLOCK_BOOKSHELF, found = true;
+        else if (name == "air") type = BLOCK_AIR, found = true;
+        return found;
+    }
+    
     // 执行help命令，显示所有可用命令及其用法
     void executeHelpCommand() {
         addSystemMessage("===== Available Commands =====");
@@ -3892,9 +4173,198 @@ public:
         addSystemMessage("/tp <x> <y> <z> - Teleport to specified coordinates");
         addSystemMessage("/music <Music name|stop> - Play or stop background music");
         addSystemMessage("/fill <x1> <y1> <z1> <x2> <y2> <z2> <Block typs> - Fill blocks in the specified area");
+        addSystemMessage("/benchmark apron [radius] - Compare neighbour access paths on nearby chunks");
+        addSystemMessage("/benchmark mesh [radius] - Build chunk meshes nearby and compare greedy quad counts");
+        addSystemMessage("/benchmark frustum [radius] - Compare plane frustum culling with the old view cone test");
+        addSystemMessage("/benchmark lod [radius] - Build every detail level nearby and compare quad counts");
+        addSystemMessage("/multithreading <on|off> - Build chunk meshes on background threads");
+        addSystemMessage("/caveculling <on|off> - Skip chunk sections hidden behind solid rock");
+        addSystemMessage("/occlusion <on|off> - Skip chunks hidden behind nearby terrain (depth pyramid)");
+        addSystemMessage("/backface <on|off> - Skip chunk faces that all point away from the camera");
+        addSystemMessage("/lod <on|off> - Draw distant chunks with simplified meshes");
+        addSystemMessage("/horizon <on|off> - Draw coarse terrain beyond the render distance");
+        addSystemMessage("/locate <Block type> [radius] - Find the nearest block of a type in loaded chunks");
         addSystemMessage("===========================");
     }
     
+    // 执行benchmark命令，在主循环中对玩家附近的区块运行基准测试
+    void executeBenchmarkCommand(std::istringstream& args) {
+        std::string name;
+        if (!(args >> name)) {
+            addSystemMessage("Usage: /benchmark <apron|mesh|frustum|lod> [radius]");
+            return;
+        }
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        if (name != "apron" && name != "mesh" && name != "frustum" && name != "lod") {
+            addSystemMessage("Unknown benchmark: " + name);
+            return;
+        }
+        
+        int radius = 4;
+        std::string radiusStr;
+        if (args >> radiusStr) {
+            try {
+                radius = std::stoi(radiusStr);
+            } catch (...) {
+                addSystemMessage("Invalid radius: " + radiusStr);
+                return;
+            }
+        }
+        // 限制半径，避免一次测试卡住太久
+        radius = std::max(0, std::min(radius, 16));
+        
+        cmdBenchmarkName = name;
+        cmdBenchmarkRadius = radius;
+        hasPendingBenchmarkCommand = true;
+        addSystemMessage("Running " + name + " benchmark (radius " + std::to_string(radius) + " chunks)...");
+    }
+    
+    // 执行multithreading命令，开关后台网格生成（主循环每帧读取该状态）
+    void executeMultiThreadingCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Multithreading is ") + (multiThreadingEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            multiThreadingEnabled = true;
+        } else if (state == "off") {
+            multiThreadingEnabled = false;
+        } else {
+            addSystemMessage("Usage: /multithreading <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Multithreaded meshing ") + (multiThreadingEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行caveculling命令，开关分段可见性图剔除（主循环每帧读取该状态）
+    void executeCaveCullingCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Cave culling is ") + (caveCullingEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            caveCullingEnabled = true;
+        } else if (state == "off") {
+            caveCullingEnabled = false;
+        } else {
+            addSystemMessage("Usage: /caveculling <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Cave culling ") + (caveCullingEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行occlusion命令，开关层次Z遮挡剔除（主循环每帧读取该状态）
+    void executeOcclusionCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Occlusion culling is ") + (occlusionCullingEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            occlusionCullingEnabled = true;
+        } else if (state == "off") {
+            occlusionCullingEnabled = false;
+        } else {
+            addSystemMessage("Usage: /occlusion <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Occlusion culling ") + (occlusionCullingEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行backface命令，开关按朝向分组的背面剔除（主循环每帧读取该状态）
+    void executeBackfaceCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Backface culling is ") + (backfaceCullingEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            backfaceCullingEnabled = true;
+        } else if (state == "off") {
+            backfaceCullingEnabled = false;
+        } else {
+            addSystemMessage("Usage: /backface <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Backface culling ") + (backfaceCullingEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行lod命令，开关远处分段的低细节网格（主循环每帧读取该状态）
+    void executeLodCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Distant chunk LOD is ") + (lodEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            lodEnabled = true;
+        } else if (state == "off") {
+            lodEnabled = false;
+        } else {
+            addSystemMessage("Usage: /lod <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Distant chunk LOD ") + (lodEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行horizon命令，开关渲染距离之外的地平线远景（主循环每帧读取该状态）
+    void executeHorizonCommand(std::istringstream& args) {
+        std::string state;
+        if (!(args >> state)) {
+            addSystemMessage(std::string("Horizon terrain is ") + (horizonEnabled ? "on" : "off"));
+            return;
+        }
+        std::transform(state.begin(), state.end(), state.begin(), ::tolower);
+        if (state == "on") {
+            horizonEnabled = true;
+        } else if (state == "off") {
+            horizonEnabled = false;
+        } else {
+            addSystemMessage("Usage: /horizon <on|off>");
+            return;
+        }
+        addSystemMessage(std::string("Horizon terrain ") + (horizonEnabled ? "enabled" : "disabled"));
+    }
+    
+    // 执行locate命令，在主循环中从玩家位置向外查找最近的指定方块
+    void executeLocateCommand(std::istringstream& args) {
+        std::string blockName;
+        if (!(args >> blockName)) {
+            addSystemMessage("Usage: /locate <Block type> [radius]");
+            return;
+        }
+        std::transform(blockName.begin(), blockName.end(), blockName.begin(), ::tolower);
+        BlockType blockType = BLOCK_AIR;
+        if (!parseBlockName(blockName, blockType) || blockType == BLOCK_AIR) {
+            addSystemMessage("Unknown block type: " + blockName);
+            return;
+        }
+        
+        int radius = LOCATE_DEFAULT_RADIUS_CHUNKS;
+        std::string radiusStr;
+        if (args >> radiusStr) {
+            try {
+                radius = std::stoi(radiusStr);
+            } catch (...) {
+                addSystemMessage("Invalid radius: " + radiusStr);
+                return;
+            }
+        }
+        radius = std::max(0, std::min(radius, static_cast<int>(LOCATE_MAX_RADIUS_CHUNKS)));
+        
+        cmdLocateType = blockType;
+        cmdLocateName = blockName;
+        cmdLocateRadius = radius;
+        hasPendingLocateCommand = true;
+    }
+    
     // 执行fill命令，填充指定区域的方块
     void executeFillCommand(std::istringstream& args) {
         std::string x1Str, y1Str, z1Str, x2Str, y2Str, z2Str;
@@ -3938,43 +4408,7 @@ public:
         std::transform(blockName.begin(), blockName.end(), blockName.begin(), ::tolower);
         
         // 匹配方块类型（复用setblock命令的逻辑）
-        if (blockName == "dirt") blockType = BLOCK_DIRT, found = true;
-        else if (blockName == "grass") blockType = BLOCK_GRASS, found = true;
-        else if (blockName == "stone") blockType = BLOCK_STONE, found = true;
-        else if (blockName == "sand") blockType = BLOCK_SAND, found = true;
-        else if (blockName == "wood") blockType = BLOCK_WOOD, found = true;
-        else if (blockName == "leaves") blockType = BLOCK_LEAVES, found = true;
-        else if (blockName == "coal" || blockName == "coal_ore") blockType = BLOCK_COAL_ORE, found = true;
-        else if (blockName == "iron" || blockName == "iron_ore") blockType = BLOCK_IRON_ORE, found = true;
-        else if (blockName == "gold" || blockName == "gold_ore") blockType = BLOCK_GOLD_ORE, found = true;
-        else if (blockName == "diamond" || blockName == "diamond_ore") blockType = BLOCK_DIAMOND_ORE, found = true;
-        else if (blockName == "bedrock") blockType = BLOCK_BEDROCK, found = true;
-        else if (blockName == "obsidian") blockType = BLOCK_OBSIDIAN, found = true;
-        else if (blockName == "lava") blockType = BLOCK_LAVA, found = true;
-        else if (blockName == "redstone" || blockName == "redstone_ore") blockType = BLOCK_REDSTONE_ORE, found = true;
-        else if (blockName == "emerald" || blockName == "emerald_ore") blockType = BLOCK_EMERALD_ORE, found = true;
-        else if (blockName == "mossy_stone") blockType = BLOCK_MOSSY_STONE, found = true;
-        else if (blockName == "gravel") blockType = BLOCK_GRAVEL, found = true;
-        else if (blockName == "clay") blockType = BLOCK_CLAY, found = true;
-        else if (blockName == "ice") blockType = BLOCK_ICE, found = true;
-        else if (blockName == "snow") blockType = BLOCK_SNOW, found = true;
-        else if (blockName == "water") blockType = BLOCK_WATER, found = true;
-        else if (blockName == "sandstone") blockType = BLOCK_SANDSTONE, found = true;
-        else if (blockName == "cactus") blockType = BLOCK_CACTUS, found = true;
-        else if (blockName == "pumpkin") blockType = BLOCK_PUMPKIN, found = true;
-        else if (blockName == "netherrack") blockType = BLOCK_NETHERRACK, found = true;
-        else if (blockName == "soul_sand") blockType = BLOCK_SOUL_SAND, found = true;
-        else if (blockName == "quartz") blockType = BLOCK_QUARTZ, found = true;
-        else if (blockName == "glowstone") blockType = BLOCK_GLOWSTONE, found = true;
-        else if (blockName == "mycelium") blockType = BLOCK_MYCELIUM, found = true;
-        else if (blockName == "end_stone") blockType = BLOCK_END_STONE, found = true;
-        else if (blockName == "prismarine") blockType = BLOCK_PRISMARINE, found = true;
-        else if (blockName == "magma") blockType = BLOCK_MAGMA, found = true;
-        else if (blockName == "nether_wart") blockType = BLOCK_NETHER_WART, found = true;
-        else if (blockName == "slime") blockType = BLOCK_SLIME, found = true;
-        else if (blockName == "brick") blockType = BLOCK_BRICK, found = true;
-        else if (blockName == "bookshelf") blockType = BLOCK_BOOKSHELF, found = true;
-        else if (blockName == "air") blockType = BLOCK_AIR, found = true;
+        found = parseBlockName(blockName, blockType);
         
         if (!found) {
             addSystemMessage("Unknown block type: " + blockName);
@@ -4126,43 +4560,7 @@ public:
         std::transform(blockName.begin(), blockName.end(), blockName.begin(), ::tolower);
         
         // 匹配方块类型
-        if (blockName == "dirt") blockType = BLOCK_DIRT, found = true;
-        else if (blockName == "grass") blockType = BLOCK_GRASS, found = true;
-        else if (blockName == "stone") blockType = BLOCK_STONE, found = true;
-        else if (blockName == "sand") blockType = BLOCK_SAND, found = true;
-        else if (blockName == "wood") blockType = BLOCK_WOOD, found = true;
-        else if (blockName == "leaves") blockType = BLOCK_LEAVES, found = true;
-        else if (blockName == "coal" || blockName == "coal_ore") blockType = BLOCK_COAL_ORE, found = true;
-        else if (blockName == "iron" || blockName == "iron_ore") blockType = BLOCK_IRON_ORE, found = true;
-        else if (blockName == "gold" || blockName == "gold_ore") blockType = BLOCK_GOLD_ORE, found = true;
-        else if (blockName == "diamond" || blockName == "diamond_ore") blockType = BLOCK_DIAMOND_ORE, found = true;
-        else if (blockName == "bedrock") blockType = BLOCK_BEDROCK, found = true;
-        else if (blockName == "obsidian") blockType = BLOCK_OBSIDIAN, found = true;
-        else if (blockName == "lava") blockType = BLOCK_LAVA, found = true;
-        else if (blockName == "redstone" || blockName == "redstone_ore") blockType = BLOCK_REDSTONE_ORE, found = true;
-        else if (blockName == "emerald" || blockName == "emerald_ore") blockType = BLOCK_EMERALD_ORE, found = true;
-        else if (blockName == "mossy_stone") blockType = BLOCK_MOSSY_STONE, found = true;
-        else if (blockName == "gravel") blockType = BLOCK_GRAVEL, found = true;
-        else if (blockName == "clay") blockType = BLOCK_CLAY, found = true;
-        else if (blockName == "ice") blockType = BLOCK_ICE, found = true;
-        else if (blockName == "snow") blockType = BLOCK_SNOW, found = true;
-        else if (blockName == "water") blockType = BLOCK_WATER, found = true;
-        else if (blockName == "sandstone") blockType = BLOCK_SANDSTONE, found = true;
-        else if (blockName == "cactus") blockType = BLOCK_CACTUS, found = true;
-        else if (blockName == "pumpkin") blockType = BLOCK_PUMPKIN, found = true;
-        else if (blockName == "netherrack") blockType = BLOCK_NETHERRACK, found = true;
-        else if (blockName == "soul_sand") blockType = BLOCK_SOUL_SAND, found = true;
-        else if (blockName == "quartz") blockType = BLOCK_QUARTZ, found = true;
-        else if (blockName == "glowstone") blockType = BLOCK_GLOWSTONE, found = true;
-        else if (blockName == "mycelium") blockType = BLOCK_MYCELIUM, found = true;
-        else if (blockName == "end_stone") blockType = BLOCK_END_STONE, found = true;
-        else if (blockName == "prismarine") blockType = BLOCK_PRISMARINE, found = true;
-        else if (blockName == "magma") blockType = BLOCK_MAGMA, found = true;
-        else if (blockName == "nether_wart") blockType = BLOCK_NETHER_WART, found = true;
-        else if (blockName == "slime") blockType = BLOCK_SLIME, found = true;
-        else if (blockName == "brick") blockType = BLOCK_BRICK, found = true;
-        else if (blockName == "bookshelf") blockType = BLOCK_BOOKSHELF, found = true;
-        else if (blockName == "air") blockType = BLOCK_AIR, found = true;
+        found = parseBlockName(blockName, blockType);
         
         if (!found) {
             addSystemMessage("Unknown block type: " + blockName);
@@ -4371,6 +4769,17 @@ public:
     int cmdFillX2 = 0, cmdFillY2 = 0, cmdFillZ2 = 0;
     BlockType cmdFillBlockType = BLOCK_AIR;
     
+    // benchmark命令相关变量
+    bool hasPendingBenchmarkCommand = false;
+    std::string cmdBenchmarkName = "";
+    int cmdBenchmarkRadius = 4;
+    
+    // locate命令相关变量
+    bool hasPendingLocateCommand = false;
+    BlockType cmdLocateType = BLOCK_AIR;
+    std::string cmdLocateName = "";
+    int cmdLocateRadius = LOCATE_DEFAULT_RADIUS_CHUNKS;
+    
     // 聊天系统公开接口
     bool isChatBoxOpen() const {
         return showChatBox;
@@ -4401,6 +4810,8 @@ public:
         hasPendingTeleportCommand = false;
         hasPendingMusicCommand = false;
         hasPendingFillCommand = false;
+        hasPendingBenchmarkCommand = false;
+        hasPendingLocateCommand = false;
     }
     
     // 添加播放自定义音乐的公共方法
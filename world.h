@@ -6,10 +6,29 @@
 #include <cmath>
 #include <map>
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <thread>
 #include <Windows.h>
 #include "math3d.h"
 #include "camera.h"
 #include "renderer.h"
+#include "chunk.h"      // 区块分段存储
+#include "chunk_residency.h" // 区块驻留管理（冷分段压缩）
+#include "chunk_intern.h"   // 相同分段去重
+#include <unordered_set>
+#include "world_stream.h"   // 无限世界的区块流式加载
+#include "superflat.h"      // 超平坦世界的层列表
+#include "face_mask.h"      // 方块面暴露掩码
+#include "chunk_apron.h"    // 带边框的分段副本
+#include "chunk_mesh.h"     // 分段网格
+#include "chunk_lod.h"      // 远处分段的低细节网格
+#include "block_index.h"    // 分段方块类型索引（X-ray、/locate）
+#include "chunk_mesh_workers.h" // 后台网格生成
+#include <chrono>
+#include <atomic>
+#include <cfloat>
+#include <thread>
 #include "ui_manager.h" // 添加UI管理器头文件
 
 // 前向声明
@@ -21,10 +40,45 @@ private:
     int width;  // X轴方向的大小
     int height; // Y轴方向的大小
     int depth;  // Z轴方向的大小
-    std::vector<Block> blocks; // 方块数组
+    // 方块按16x16x16分段存储，分段可被快照共享（写时复制）
+    // 区块列以64位区块坐标为键存放在哈希表中；冷分段在const访问时也会按需解压，因此声明为mutable
+    mutable std::unordered_map<uint64_t, ChunkColumn> columns;
+    mutable uint64_t cachedColumnKey = 0;           // 最近访问的区块列（相邻方块访问通常落在同一列）
+    mutable ChunkColumn* cachedColumn = nullptr;
+    mutable ChunkResidencyStats residencyStats;
+    mutable SectionInterner sectionInterner; // 相同内容的分段共享同一块内存
+    size_t residencyBudgetBytes = DEFAULT_RESIDENCY_BUDGET_BYTES;
+    int residencyUpdateCount = 0;
+    int chunksY; // Y轴方向的区块数
+    
+    // 无限世界：水平方向不设边界，区块列在相机周围由后台线程生成
+    bool infiniteWorld = false;
+    std::unique_ptr<ChunkStreamer> streamer;
+    // 编辑过且已卸载的区块列（压缩保存，回到范围内时恢复）
+    std::unordered_map<uint64_t, std::vector<CompressedSectionPtr>> unloadedColumns;
     unsigned int worldSeed; // 存储世界种子
     bool isSuperFlat; // 是否为超平坦世界
     BlockType superFlatBlockType; // 超平坦世界的方块类型
+    // 超平坦世界由层列表解析，只有编辑过的区块列才分配存储（非超平坦世界时为空）
+    SuperFlatLayers flatLayers;
+    
+    // 分段修订号计数器：分段内容每次变化都取一个新值，网格缓存据此判断是否过期
+    uint64_t sectionRevisionCounter = 0;
+    // 超平坦世界中未分配存储的分段共用的修订号（层列表重建时更新）
+    uint64_t flatRevision = 0;
+    // 已生成的分段网格（渲染时按修订号惰性重建）
+    mutable ChunkMeshCache meshCache;
+    // 是否把相邻的同色面贪心合并成大矩形
+    bool greedyMeshing = false;
+    // 后台网格生成线程池（关闭多线程时为空，网格在渲染时同步生成）
+    mutable std::unique_ptr<ChunkMeshWorkers> meshWorkers;
+    // 本帧需要重新生成网格的分段（渲染时收集，帧末按优先级提交）
+    mutable std::vector<MeshJob> meshRequests;
+    mutable std::unordered_set<uint64_t> meshRequestKeys;
+    // 分段方块类型索引（查询时按修订号惰性重建，键与网格缓存相同）
+    mutable std::unordered_map<uint64_t, SectionBlockIndex> blockIndices;
+    // 超平坦世界中还没有生成的区块列：分段内容只取决于层号，每层共用一个索引
+    mutable std::vector<SectionBlockIndex> flatBlockIndices;
     
     // 出生点坐标
     int spawnX;
@@ -37,14 +91,289 @@ private:
     // 噪声生成器（用于地形生成）
     std::mt19937 rng;
     
-    // 获取方块索引
-    int getIndex(int x, int y, int z) const {
-        return (z * width * height) + (y * width) + x;
+    // 查找方块所在的区块列（未加载时返回空指针）
+    ChunkColumn* findColumn(int chunkX, int chunkZ) const {
+        uint64_t key = chunkColumnKey(chunkX, chunkZ);
+        if (cachedColumn && cachedColumnKey == key) {
+            return cachedColumn;
+        }
+        auto it = columns.find(key);
+        if (it == columns.end()) {
+            return nullptr;
+        }
+        cachedColumnKey = key;
+        cachedColumn = &it->second;
+        return cachedColumn;
+    }
+    
+    // 将冷分段解压回内存
+    void wakeSection(ChunkColumn& column, int sectionY) const {
+        const CompressedSectionPtr& compressed = column.coldSections[sectionY];
+        ChunkSectionPtr section = decompressSection(*compressed);
+        if (!section) {
+            // 冷数据损坏时退化为空气分段，避免访问空指针
+            std::cout << "Failed to decompress chunk section (" << column.chunkX << ", " << sectionY << ", " << column.chunkZ << ")" << std::endl;
+            section = std::make_shared<ChunkSection>();
+        }
+        
+        residencyStats.decompressions++;
+        residencyStats.coldSections--;
+        residencyStats.coldBytes -= compressed->size();
+        residencyStats.residentSections++;
+        residencyStats.residentBytes += sizeof(ChunkSection);
+        
+        // 解压出的分段若与已有分段相同则直接共享
+        ChunkSectionPtr canonical = sectionInterner.intern(section);
+        if (canonical == section) {
+            residencyStats.uniqueSections++;
+            residencyStats.uniqueBytes += sizeof(ChunkSection);
+        }
+        section = canonical;
+        
+        column.sections[sectionY] = section;
+        column.coldSections[sectionY].reset();
+        column.wakeUpdate[sectionY] = residencyUpdateCount;
+    }
+    
+    // 获取常驻分段（冷分段会先被解压）
+    ChunkSection& residentSection(ChunkColumn& column, int sectionY) const {
+        if (!column.sections[sectionY]) {
+            residencyStats.misses++;
+            wakeSection(column, sectionY);
+        } else {
+            residencyStats.hits++;
+        }
+        return *column.sections[sectionY];
+    }
+    
+    // 超平坦世界中未分配存储的方块（按层列表解析）
+    const Block& flatBlockAt(int x, int y, int z) const {
+        uint8_t edgeFaces = 0;
+        if (!infiniteWorld) {
+            if (z == depth - 1) edgeFaces |= faceBit(FACE_FRONT);
+            if (z == 0) edgeFaces |= faceBit(FACE_BACK);
+            if (x == 0) edgeFaces |= faceBit(FACE_LEFT);
+            if (x == width - 1) edgeFaces |= faceBit(FACE_RIGHT);
+        }
+        return flatLayers.blockAt(y, edgeFaces);
+    }
+    
+    // 读取方块（调用方保证y在范围内；未加载的区块列视为空气，超平坦世界按层列表解析）
+    const Block& blockAtConst(int x, int y, int z) const {
+        ChunkColumn* column = findColumn(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+        if (!column) {
+            if (!flatLayers.isEmpty()) {
+                return flatBlockAt(x, y, z);
+            }
+            static Block airBlock(BLOCK_AIR);
+            return airBlock;
+        }
+        return residentSection(*column, y >> CHUNK_SHIFT).blocks[ChunkSection::localIndex(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+    }
+    
+    // 获取可写方块（调用方保证y在范围内；写入未加载的区块列会被丢弃，超平坦世界会先分配该区块列）
+    // 如果分段仍被快照引用，先复制一份再写入，保证快照内容不变
+    Block& blockAt(int x, int y, int z) {
+        return writableBlockAt(x, y, z, true);
+    }
+    
+    // markModified为false时不标记区块列已编辑（用于可由方块内容推导的数据，如面掩码）
+    Block& writableBlockAt(int x, int y, int z, bool markModified) {
+        ChunkColumn* column = findColumn(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+        if (!column && !flatLayers.isEmpty()) {
+            column = materializeFlatColumn(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+        }
+        if (!column) {
+            static Block discardedBlock;
+            discardedBlock = Block(BLOCK_AIR);
+            return discardedBlock;
+        }
+        int sectionY = y >> CHUNK_SHIFT;
+        residentSection(*column, sectionY);
+        if (markModified) {
+            column->modified = true;
+        }
+        column->revisions[sectionY] = ++sectionRevisionCounter;
+        ChunkSectionPtr& section = column->sections[sectionY];
+        if (section.use_count() > 1) {
+            section = std::make_shared<ChunkSection>(*section);
+            residencyStats.uniqueSections++;
+            residencyStats.uniqueBytes += sizeof(ChunkSection);
+        }
+        return section->blocks[ChunkSection::localIndex(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)];
+    }
+    
+    // 清空所有区块列
+    void clearColumns() {
+        columns.clear();
+        unloadedColumns.clear();
+        cachedColumn = nullptr;
+        sectionInterner.clear();
+        residencyStats = ChunkResidencyStats();
+        meshCache.clear();
+        blockIndices.clear();
+        flatBlockIndices.clear();
+    }
+    
+    // 对所有常驻分段去重（世界生成完成后调用）
+    void internAllSections() {
+        for (auto& entry : columns) {
+            for (auto& section : entry.second.sections) {
+                if (section) {
+                    section = sectionInterner.intern(section);
+                }
+            }
+        }
+        refreshMemoryReport();
+        
+        std::cout << "Section dedupe: " << residencyStats.residentSections << " sections -> "
+                  << residencyStats.uniqueSections << " unique buffers" << std::endl;
+    }
+    
+    // 重新统计去重后实际存在的分段缓冲区
+    void refreshMemoryReport() const {
+        std::unordered_set<const ChunkSection*> unique;
+        unique.reserve(static_cast<size_t>(residencyStats.residentSections));
+        for (const auto& entry : columns) {
+            for (const auto& section : entry.second.sections) {
+                if (section) {
+                    unique.insert(section.get());
+                }
+            }
+        }
+        residencyStats.uniqueSections = static_cast<int>(unique.size());
+        residencyStats.uniqueBytes = unique.size() * sizeof(ChunkSection);
+        residencyStats.internShared = sectionInterner.getInternShared();
+    }
+    
+    // 并入一个区块列并更新驻留统计
+    void insertColumn(ChunkColumn&& column) {
+        // 新并入的分段取新的修订号（同一位置之前的网格随之失效）
+        column.revisions.resize(column.sections.size());
+        for (size_t i = 0; i < column.sections.size(); i++) {
+            column.revisions[i] = ++sectionRevisionCounter;
+            if (column.sections[i]) {
+                residencyStats.residentSections++;
+                residencyStats.residentBytes += sizeof(ChunkSection);
+                
+                // 新生成的分段先去重
+                ChunkSectionPtr canonical = sectionInterner.intern(column.sections[i]);
+                if (canonical == column.sections[i]) {
+                    residencyStats.uniqueSections++;
+                    residencyStats.uniqueBytes += sizeof(ChunkSection);
+                }
+                column.sections[i] = canonical;
+            } else {
+                residencyStats.coldSections++;
+                residencyStats.coldBytes += column.coldSections[i]->size();
+            }
+        }
+        uint64_t key = chunkColumnKey(column.chunkX, column.chunkZ);
+        columns[key] = std::move(column);
+    }
+    
+    // 恢复一个已卸载的编辑过的区块列（恢复为冷分段，访问时再解压）
+    void restoreUnloadedColumn(std::unordered_map<uint64_t, std::vector<CompressedSectionPtr>>::iterator saved,
+                               int chunkX, int chunkZ) {
+        ChunkColumn column;
+        column.chunkX = chunkX;
+        column.chunkZ = chunkZ;
+        column.sections.resize(saved->second.size());
+        column.wakeUpdate.assign(saved->second.size(), 0);
+        column.coldSections = std::move(saved->second);
+        column.modified = true;
+        unloadedColumns.erase(saved);
+        insertColumn(std::move(column));
+    }
+    
+    // 为超平坦世界中第一次被写入的区块列分配存储
+    // 分段按层列表填充后会被去重，未编辑的分段与其他区块列共享同一块内存
+    ChunkColumn* materializeFlatColumn(int chunkX, int chunkZ) {
+        uint64_t key = chunkColumnKey(chunkX, chunkZ);
+        auto saved = unloadedColumns.find(key);
+        if (saved != unloadedColumns.end()) {
+            restoreUnloadedColumn(saved, chunkX, chunkZ);
+            return findColumn(chunkX, chunkZ);
+        }
+        
+        ChunkColumn column;
+        column.allocate(chunkX, chunkZ, chunksY);
+        int baseX = chunkX * CHUNK_SIZE;
+        int baseZ = chunkZ * CHUNK_SIZE;
+        for (int y = 0; y < height; y++) {
+            for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+                for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                    // 有限世界边缘的区块列只有一部分在世界内，世界外的格保持空气（与getBlockConst一致）
+                    if (!isInBounds(baseX + lx, y, baseZ + lz)) continue;
+                    column.localBlock(lx, y, lz) = flatBlockAt(baseX + lx, y, baseZ + lz);
+                }
+            }
+        }
+        insertColumn(std::move(column));
+        return findColumn(chunkX, chunkZ);
+    }
+    
+    // 移除一个区块列；编辑过的区块列压缩后保留，以便回到范围内时恢复
+    // 不在这里减去去重后的缓冲区数：网格任务或自动保存快照可能还持有分段引用，use_count()判断不出
+    // 缓冲区是否真的释放，由updateStreaming卸载完后调用refreshMemoryReport()重新统计
+    void unloadColumn(std::unordered_map<uint64_t, ChunkColumn>::iterator it) {
+        ChunkColumn& column = it->second;
+        std::vector<CompressedSectionPtr> saved;
+        if (column.modified) {
+            saved.resize(column.sections.size());
+        }
+        for (size_t i = 0; i < column.sections.size(); i++) {
+            if (column.sections[i]) {
+                residencyStats.residentSections--;
+                residencyStats.residentBytes -= sizeof(ChunkSection);
+                if (column.modified) {
+                    saved[i] = compressSection(*column.sections[i]);
+                    residencyStats.compressions++;
+                }
+                column.sections[i].reset();
+            } else {
+                residencyStats.coldSections--;
+                residencyStats.coldBytes -= column.coldSections[i]->size();
+                if (column.modified) {
+                    saved[i] = column.coldSections[i];
+                }
+            }
+        }
+        if (column.modified) {
+            unloadedColumns[it->first] = std::move(saved);
+        }
+        for (size_t i = 0; i < column.sections.size(); i++) {
+            blockIndices.erase(ChunkMeshCache::key(column.chunkX, static_cast<int>(i), column.chunkZ));
+        }
+        if (cachedColumn == &column) {
+            cachedColumn = nullptr;
+        }
+        columns.erase(it);
+    }
+    
+    // 按世界尺寸分配全部区块列（初始为空气）
+    void allocateSections() {
+        int chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        int chunksZ = (depth + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        
+        clearColumns();
+        columns.reserve(static_cast<size_t>(chunksX) * chunksZ);
+        for (int chunkZ = 0; chunkZ < chunksZ; chunkZ++) {
+            for (int chunkX = 0; chunkX < chunksX; chunkX++) {
+                ChunkColumn column;
+                column.allocate(chunkX, chunkZ, chunksY);
+                insertColumn(std::move(column));
+            }
+        }
     }
     
     // 检查坐标是否在世界范围内
     public:
     bool isInBounds(int x, int y, int z) const {
+        if (infiniteWorld) {
+            return y >= 0 && y < height;
+        }
         return x >= 0 && x < width && y >= 0 && y < height && z >= 0 && z < depth;
     }
     
@@ -59,7 +388,7 @@ private:
     // 获取方块（常量引用版本，用于渲染）
     const Block& getBlockConst(int x, int y, int z) const {
         if (isInBounds(x, y, z)) {
-            return blocks[getIndex(x, y, z)];
+            return blockAtConst(x, y, z);
         }
         static Block airBlock(BLOCK_AIR);
         return airBlock;
@@ -234,7 +563,7 @@ private:
                 // 查找地表高度
                 for (int y = height - 1; y >= 0; y--) {
                     if (isInBounds(x, y, z)) {
-                        BlockType blockType = blocks[getIndex(x, y, z)].type;
+                        BlockType blockType = blockAtConst(x, y, z).type;
                         if (blockType != BLOCK_AIR) {
                             surfaceHeightMap[z * width + x] = y;
                             
@@ -597,9 +926,9 @@ private:
                     // 如果在球体内部，挖掉方块（设置为空气）
                     if (distSq <= radius * radius) {
                         // 不要挖掉基岩
-                        if (y > 0 && blocks[getIndex(x, y, z)].type != BLOCK_BEDROCK) {
+                        if (y > 0 && blockAtConst(x, y, z).type != BLOCK_BEDROCK) {
                             // 标记此位置为矿洞
-                            blocks[getIndex(x, y, z)] = Block(BLOCK_AIR);
+                            blockAt(x, y, z) = Block(BLOCK_AIR);
                         }
                     }
                 }
@@ -619,7 +948,7 @@ private:
                 
                 // 从上往下找到水面
                 for (int y = height - 1; y >= 0; y--) {
-                    if (isInBounds(x, y, z) && blocks[getIndex(x, y, z)].type == BLOCK_WATER) {
+                    if (isInBounds(x, y, z) && blockAtConst(x, y, z).type == BLOCK_WATER) {
                         isWaterSurface = true;
                         waterSurfaceY = y;
                         break;
@@ -631,13 +960,13 @@ private:
                     // 从水面向下检查
                     for (int y = waterSurfaceY; y >= 0; y--) {
                         // 如果遇到实体方块，停止检查
-                        if (blocks[getIndex(x, y, z)].type != BLOCK_AIR && blocks[getIndex(x, y, z)].type != BLOCK_WATER) {
+                        if (blockAtConst(x, y, z).type != BLOCK_AIR && blockAtConst(x, y, z).type != BLOCK_WATER) {
                             break;
                         }
                         
                         // 如果是空气，填充水
-                        if (blocks[getIndex(x, y, z)].type == BLOCK_AIR) {
-                            blocks[getIndex(x, y, z)] = Block(BLOCK_WATER);
+                        if (blockAtConst(x, y, z).type == BLOCK_AIR) {
+                            blockAt(x, y, z) = Block(BLOCK_WATER);
                         }
                     }
                 }
@@ -659,7 +988,7 @@ private:
                 
                 // 从上往下找到沙滩表面
                 for (int y = height - 1; y >= 0; y--) {
-                    if (isInBounds(x, y, z) && blocks[getIndex(x, y, z)].type == BLOCK_SAND) {
+                    if (isInBounds(x, y, z) && blockAtConst(x, y, z).type == BLOCK_SAND) {
                         isSandSurface = true;
                         sandSurfaceY = y;
                         break;
@@ -674,7 +1003,7 @@ private:
                     
                     // 从沙滩表面向下检查
                     for (int y = sandSurfaceY - 1; y >= std::max(0, sandSurfaceY - 5); y--) {
-                        if (isInBounds(x, y, z) && blocks[getIndex(x, y, z)].type == BLOCK_AIR) {
+                        if (isInBounds(x, y, z) && blockAtConst(x, y, z).type == BLOCK_AIR) {
                             hasAirGap = true;
                             airGapY = y;
                             break;
@@ -684,8 +1013,8 @@ private:
                     // 如果发现空气间隙，填充沙子
                     if (hasAirGap) {
                         for (int y = sandSurfaceY - 1; y >= airGapY; y--) {
-                            if (blocks[getIndex(x, y, z)].type == BLOCK_AIR) {
-                                blocks[getIndex(x, y, z)] = Block(BLOCK_SAND);
+                            if (blockAtConst(x, y, z).type == BLOCK_AIR) {
+                                blockAt(x, y, z) = Block(BLOCK_SAND);
                             }
                         }
                     }
@@ -785,7 +1114,7 @@ private:
                             for (int dx = -searchRadius; dx <= searchRadius && !nearCave; dx++) {
                                 for (int dz = -searchRadius; dz <= searchRadius && !nearCave; dz++) {
                                     if (isInBounds(testX + dx, testY + dy, testZ + dz) && 
-                                        blocks[getIndex(testX + dx, testY + dy, testZ + dz)].type == BLOCK_AIR) {
+                                        blockAtConst(testX + dx, testY + dy, testZ + dz).type == BLOCK_AIR) {
                                         nearCave = true;
                                         startX = testX;
                                         startY = testY;
@@ -855,14 +1184,14 @@ private:
             for (int y = 0; y < height; y += checkInterval) {
                 for (int x = 0; x < width; x += checkInterval) {
                     // 只在石头方块中生成
-                    if (isInBounds(x, y, z) && blocks[getIndex(x, y, z)].type == BLOCK_STONE) {
+                    if (isInBounds(x, y, z) && blockAtConst(x, y, z).type == BLOCK_STONE) {
                         // 检查是否靠近洞穴
                         bool nearCave = false;
                         for (int dy = -3; dy <= 3 && !nearCave; dy++) {
                             for (int dx = -3; dx <= 3 && !nearCave; dx++) {
                                 for (int dz = -3; dz <= 3 && !nearCave; dz++) {
                                     if (isInBounds(x + dx, y + dy, z + dz) && 
-                                        blocks[getIndex(x + dx, y + dy, z + dz)].type == BLOCK_AIR) {
+                                        blockAtConst(x + dx, y + dy, z + dz).type == BLOCK_AIR) {
                                         nearCave = true;
                                         break;
                                     }
@@ -885,7 +1214,7 @@ private:
                                 // 随机决定是否生成
                                 if (dist(oreRng) < chance) {
                                     // 在当前位置生成矿物
-                                    blocks[getIndex(x, y, z)] = Block(ore.oreType);
+                                    blockAt(x, y, z) = Block(ore.oreType);
                                     totalScattered++;
                                     
                                     // 有小概率在周围也生成同类矿物
@@ -899,8 +1228,8 @@ private:
                                                     // 随机选择是否在此位置放置矿石
                                                     if (dist(oreRng) < 0.15f && 
                                                         isInBounds(x + dx2, y + dy2, z + dz2) && 
-                                                        blocks[getIndex(x + dx2, y + dy2, z + dz2)].type == BLOCK_STONE) {
-                                                        blocks[getIndex(x + dx2, y + dy2, z + dz2)] = Block(ore.oreType);
+                                                        blockAtConst(x + dx2, y + dy2, z + dz2).type == BLOCK_STONE) {
+                                                        blockAt(x + dx2, y + dy2, z + dz2) = Block(ore.oreType);
                                                         totalScattered++;
                                                     }
                                                 }
@@ -932,8 +1261,8 @@ private:
         int z = startZ;
         
         // 放置第一个矿石方块
-        if (isInBounds(x, y, z) && blocks[getIndex(x, y, z)].type == BLOCK_STONE) {
-            blocks[getIndex(x, y, z)] = Block(oreType);
+        if (isInBounds(x, y, z) && blockAtConst(x, y, z).type == BLOCK_STONE) {
+            blockAt(x, y, z) = Block(oreType);
         }
         
         // 创建更自然的矿脉形状
@@ -990,8 +1319,8 @@ private:
                 }
                 
                 // 只替换石头方块
-                if (blocks[getIndex(newX, newY, newZ)].type == BLOCK_STONE) {
-                    blocks[getIndex(newX, newY, newZ)] = Block(oreType);
+                if (blockAtConst(newX, newY, newZ).type == BLOCK_STONE) {
+                    blockAt(newX, newY, newZ) = Block(oreType);
                     placedOres++;
                     
                     // 将新位置添加到路径栈中，以便继续扩展
@@ -1009,8 +1338,8 @@ private:
                                     // 随机选择是否在此位置放置矿石
                                     if (dist(oreRng) < 0.25f - rarity * 0.1f && 
                                         isInBounds(newX + cx, newY + cy, newZ + cz) && 
-                                        blocks[getIndex(newX + cx, newY + cy, newZ + cz)].type == BLOCK_STONE) {
-                                        blocks[getIndex(newX + cx, newY + cy, newZ + cz)] = Block(oreType);
+                                        blockAtConst(newX + cx, newY + cy, newZ + cz).type == BLOCK_STONE) {
+                                        blockAt(newX + cx, newY + cy, newZ + cz) = Block(oreType);
                                         placedOres++;
                                         
                                         // 检查是否已达到目标大小
@@ -1036,8 +1365,8 @@ private:
                         int branchZ = newZ + dirDist(oreRng);
                         
                         if (isInBounds(branchX, branchY, branchZ) && 
-                            blocks[getIndex(branchX, branchY, branchZ)].type == BLOCK_STONE) {
-                            blocks[getIndex(branchX, branchY, branchZ)] = Block(oreType);
+                            blockAtConst(branchX, branchY, branchZ).type == BLOCK_STONE) {
+                            blockAt(branchX, branchY, branchZ) = Block(oreType);
                             placedOres++;
                             
                             // 将分支位置添加到路径栈中
@@ -1069,41 +1398,24 @@ private:
         std::cout << "World size: " << width << "x" << height << "x" << depth << std::endl;
         std::cout << "Total blocks: " << totalBlocks << std::endl;
         
-        // 初始化所有方块为空气
-        blocks.resize(width * height * depth, Block(BLOCK_AIR));
-        processedBlocks = totalBlocks; // 初始化完成
-        
-        // 显示进度
-        std::cout << "Initialized air blocks: 100%" << std::endl;
-        
         if (isSuperFlat) {
-            // 生成超平坦世界 - 只有一层方块
+            // 超平坦世界：只记录层列表，不分配方块；玩家编辑时才分配对应的区块列
             std::cout << "Generating superflat world..." << std::endl;
-            
-            long long flatBlocks = 0;
-            long long totalFlatBlocks = static_cast<long long>(width) * depth;
-            
-            for (int z = 0; z < depth; z++) {
-                for (int x = 0; x < width; x++) {
-                    // 在Y=0处放置超平坦世界的方块
-                    blocks[getIndex(x, 0, z)] = Block(superFlatBlockType);
-                    
-                    // 更新进度
-                    flatBlocks++;
-                    if (flatBlocks % 10000 == 0 || flatBlocks == totalFlatBlocks) {
-                        int percent = static_cast<int>((flatBlocks * 100) / totalFlatBlocks);
-                        std::cout << "Generating superflat surface: " << percent << "% (" 
-                                  << flatBlocks << "/" << totalFlatBlocks << " blocks)" << std::endl;
-                    }
-                }
-            }
-            
-            std::cout << "Updating block visibility..." << std::endl;
-            // 更新所有方块的可见性
-            updateBlockVisibility();
+            chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            clearColumns();
+            flatLayers.buildSingleLayer(superFlatBlockType, height);
+            flatRevision = ++sectionRevisionCounter;
             std::cout << "World generation complete!" << std::endl;
             return;
         }
+        flatLayers.clear();
+        
+        // 初始化所有方块为空气
+        allocateSections();
+        processedBlocks = totalBlocks; // 初始化完成
+        
+        // 显示进度
+        std::cout << "Initialized air blocks: 100%" << std::endl;
         
         // 以下是普通世界生成逻辑
         std::cout << "Generating terrain heightmap..." << std::endl;
@@ -1136,14 +1448,14 @@ private:
                 int terrainHeight = heightMap[z * width + x];
                 
                 // 生成基岩层
-                blocks[getIndex(x, 0, z)] = Block(BLOCK_BEDROCK);
+                blockAt(x, 0, z) = Block(BLOCK_BEDROCK);
                 terrainBlocks++;
                 
                 // 生成矿石和石头层
                 for (int y = 1; y < terrainHeight - 3; y++) {
                     // 默认为石头
                     BlockType blockType = BLOCK_STONE;
-                    blocks[getIndex(x, y, z)] = Block(blockType);
+                    blockAt(x, y, z) = Block(blockType);
                     terrainBlocks++;
                 }
                 
@@ -1164,7 +1476,7 @@ private:
                     }
                     
                     // 设置方块
-                    blocks[getIndex(x, y, z)] = Block(blockType);
+                    blockAt(x, y, z) = Block(blockType);
                     terrainBlocks++;
                 }
                 
@@ -1188,7 +1500,7 @@ private:
                         }
                     }
                     
-                    blocks[getIndex(x, terrainHeight - 1, z)] = Block(surfaceType);
+                    blockAt(x, terrainHeight - 1, z) = Block(surfaceType);
                     terrainBlocks++;
                 }
                 
@@ -1197,7 +1509,7 @@ private:
                 if (terrainHeight < waterLevel) {
                     for (int y = terrainHeight; y <= waterLevel; y++) {
                         // 水面下是水方块
-                        blocks[getIndex(x, y, z)] = Block(BLOCK_WATER);
+                        blockAt(x, y, z) = Block(BLOCK_WATER);
                         terrainBlocks++;
                         waterBlocks++;
                     }
@@ -1228,6 +1540,9 @@ private:
         // 统计矿物数量
         countOres();
         
+        // 相同内容的分段（整块石头、空气等）共享内存
+        internAllSections();
+        
         std::cout << "World generation complete!" << std::endl;
     }
     
@@ -1240,7 +1555,7 @@ private:
         
         // 生成树干
         for (int treeY = y; treeY < y + 4; treeY++) {
-            blocks[getIndex(x, treeY, z)] = Block(BLOCK_WOOD);
+            blockAt(x, treeY, z) = Block(BLOCK_WOOD);
         }
         
         // 生成树叶
@@ -1248,8 +1563,8 @@ private:
             for (int leafX = x - 1; leafX <= x + 1; leafX++) {
                 for (int leafZ = z - 1; leafZ <= z + 1; leafZ++) {
                     if (isInBounds(leafX, leafY, leafZ) && 
-                        blocks[getIndex(leafX, leafY, leafZ)].type == BLOCK_AIR) {
-                        blocks[getIndex(leafX, leafY, leafZ)] = Block(BLOCK_LEAVES);
+                        blockAtConst(leafX, leafY, leafZ).type == BLOCK_AIR) {
+                        blockAt(leafX, leafY, leafZ) = Block(BLOCK_LEAVES);
                     }
                 }
             }
@@ -1258,27 +1573,58 @@ private:
     
     // 检查方块是否为透明或半透明
     bool isTransparent(BlockType type) const {
-        // 首先检查基础透明方块类型
-        bool baseTransparent = type == BLOCK_AIR || 
-               type == BLOCK_WATER || 
-               type == BLOCK_LEAVES || 
-               type == BLOCK_ICE ||
-               type == BLOCK_LAVA ||
-               type == BLOCK_SLIME;
-               
-        // 如果是基本透明类型，直接返回true
-        if (baseTransparent) {
-            return true;
+        return isTransparentBlockType(type);
+    }
+    
+    // 计算方块六个面的暴露掩码（相邻方块透明或在世界范围外时该面暴露）
+    uint8_t computeBlockFaceMask(int x, int y, int z) const {
+        if (blockAtConst(x, y, z).type == BLOCK_AIR) {
+            return 0;
         }
         
-        // 对于CHANGE_BLOCK，需要检查其透明度设置
-        if (type == BLOCK_CHANGE_BLOCK) {
-            // 由于这里不能直接访问方块实例，我们返回true
-            // 实际透明度将在渲染时根据具体方块实例进行处理
-            return true;
+        uint8_t mask = 0;
+        // 前面 (z+1)
+        if (!isInBounds(x, y, z + 1) || isTransparent(blockAtConst(x, y, z + 1).type)) {
+            mask |= faceBit(FACE_FRONT);
+        }
+        // 后面 (z-1)
+        if (!isInBounds(x, y, z - 1) || isTransparent(blockAtConst(x, y, z - 1).type)) {
+            mask |= faceBit(FACE_BACK);
+        }
+        // 左面 (x-1)
+        if (!isInBounds(x - 1, y, z) || isTransparent(blockAtConst(x - 1, y, z).type)) {
+            mask |= faceBit(FACE_LEFT);
+        }
+        // 右面 (x+1)
+        if (!isInBounds(x + 1, y, z) || isTransparent(blockAtConst(x + 1, y, z).type)) {
+            mask |= faceBit(FACE_RIGHT);
+        }
+        // 上面 (y+1)
+        if (y == height - 1 || isTransparent(blockAtConst(x, y + 1, z).type)) {
+            mask |= faceBit(FACE_TOP);
+        }
+        // 下面 (y-1)
+        if (y == 0 || isTransparent(blockAtConst(x, y - 1, z).type)) {
+            mask |= faceBit(FACE_BOTTOM);
+        }
+        return mask;
+    }
+    
+    // 写入方块的面掩码和可见性
+    // 没有变化时不取可写引用，避免不必要的写时复制和超平坦区块列分配；
+    // 面掩码可以由方块内容推导，因此不把区块列标记为已编辑
+    void storeBlockFaceMask(int x, int y, int z) {
+        uint8_t mask = computeBlockFaceMask(x, y, z);
+        const Block& current = blockAtConst(x, y, z);
+        // 半透明方块始终渲染
+        bool visible = current.type != BLOCK_AIR && (mask != 0 || isAlwaysVisibleBlockType(current.type));
+        if (current.faceMask == mask && current.isVisible == visible) {
+            return;
         }
         
-        return false;
+        Block& block = writableBlockAt(x, y, z, false);
+        block.faceMask = mask;
+        block.isVisible = visible;
     }
     
     // 更新特定方块及其周围方块的可见性
@@ -1288,77 +1634,27 @@ private:
             return;
         }
         
-        // 获取当前方块
-        int index = getIndex(x, y, z);
-        Block& block = blocks[index];
-        
-        // 如果是空气方块，它本身不可见，但需要更新周围方块的可见性
-        if (block.type == BLOCK_AIR) {
-            block.isVisible = false;
-        } else {
-            // 检查六个面是否有相邻的透明方块
-            bool hasTransparentNeighbor = false;
-            
-            // 检查前面 (z+1)
-            if (z == depth - 1 || isTransparent(blocks[getIndex(x, y, z + 1)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 检查后面 (z-1)
-            if (z == 0 || isTransparent(blocks[getIndex(x, y, z - 1)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 检查左面 (x-1)
-            if (x == 0 || isTransparent(blocks[getIndex(x - 1, y, z)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 检查右面 (x+1)
-            if (x == width - 1 || isTransparent(blocks[getIndex(x + 1, y, z)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 检查上面 (y+1)
-            if (y == height - 1 || isTransparent(blocks[getIndex(x, y + 1, z)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 检查下面 (y-1)
-            if (y == 0 || isTransparent(blocks[getIndex(x, y - 1, z)].type)) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 如果方块是半透明的，始终渲染它
-            if (block.type == BLOCK_WATER || block.type == BLOCK_LEAVES || block.type == BLOCK_LAVA) {
-                hasTransparentNeighbor = true;
-            }
-            
-            // 修复剔除过度问题：如果方块在玩家视野范围内，强制设置为可见
-            // 这将在渲染时进一步判断，这里只是确保方块不会被错误地剔除
-            
-            // 设置方块可见性
-            block.isVisible = hasTransparentNeighbor;
-        }
+        // 空气方块的掩码为0，但仍需要更新周围方块的可见性
+        storeBlockFaceMask(x, y, z);
         
         // 更新周围六个方块的可见性
         // 前面 (z+1)
-        if (z < depth - 1) {
+        if (isInBounds(x, y, z + 1)) {
             updateSingleBlockVisibility(x, y, z + 1);
         }
         
         // 后面 (z-1)
-        if (z > 0) {
+        if (isInBounds(x, y, z - 1)) {
             updateSingleBlockVisibility(x, y, z - 1);
         }
         
         // 左面 (x-1)
-        if (x > 0) {
+        if (isInBounds(x - 1, y, z)) {
             updateSingleBlockVisibility(x - 1, y, z);
         }
         
         // 右面 (x+1)
-        if (x < width - 1) {
+        if (isInBounds(x + 1, y, z)) {
             updateSingleBlockVisibility(x + 1, y, z);
         }
         
@@ -1380,217 +1676,741 @@ private:
             return;
         }
         
-        // 获取当前方块
-        int index = getIndex(x, y, z);
-        Block& block = blocks[index];
+        storeBlockFaceMask(x, y, z);
+    }
+    
+    // 更新特定坐标方块的可见性
+    void updateBlockVisibility(int x, int y, int z) {
+        updateBlockVisibilityAt(x, y, z);
         
-        // 空气方块始终不可见
-        if (block.type == BLOCK_AIR) {
-            block.isVisible = false;
-            return;
+        // 确保更新下方方块的可见性（修复挖掉方块后下方方块不可见的问题）
+        if (y > 0) {
+            updateBlockVisibilityAt(x, y-1, z);
         }
-        
-        // 检查六个面是否有相邻的透明方块
-        bool hasTransparentNeighbor = false;
-        
-        // 检查前面 (z+1)
-        if (z == depth - 1 || isTransparent(blocks[getIndex(x, y, z + 1)].type)) {
-            hasTransparentNeighbor = true;
+    }
+    
+    // 在多个线程上执行fn(0..count-1)，按下标动态分配任务
+    template <typename Fn>
+    static void runParallel(size_t count, Fn fn) {
+        size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min(threadCount, count);
+        if (threadCount <= 1) {
+            for (size_t i = 0; i < count; i++) {
+                fn(i);
+            }
+            return;
         }
         
-        // 检查后面 (z-1)
-        if (z == 0 || isTransparent(blocks[getIndex(x, y, z - 1)].type)) {
-            hasTransparentNeighbor = true;
+        std::atomic<size_t> next(0);
+        auto worker = [&next, count, &fn]() {
+            for (size_t i = next++; i < count; i = next++) {
+                fn(i);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < threadCount; t++) {
+            threads.emplace_back(worker);
         }
-        
-        // 检查左面 (x-1)
-        if (x == 0 || isTransparent(blocks[getIndex(x - 1, y, z)].type)) {
-            hasTransparentNeighbor = true;
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
         }
-        
-        // 检查右面 (x+1)
-        if (x == width - 1 || isTransparent(blocks[getIndex(x + 1, y, z)].type)) {
-            hasTransparentNeighbor = true;
+    }
+    
+    // 区块列未加载时相邻分段的透明位集：超平坦世界按层列表逐个方块解析，否则视为空气
+    void buildMissingSectionBits(int chunkX, int sectionY, int chunkZ, SectionBits& transparent) const {
+        if (flatLayers.isEmpty()) {
+            transparent.fill(true);
+            return;
         }
-        
-        // 检查上面 (y+1)
-        if (y == height - 1 || isTransparent(blocks[getIndex(x, y + 1, z)].type)) {
-            hasTransparentNeighbor = true;
+        SectionBits solid;
+        ChunkSection section;
+        for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+            for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+                for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                    section.blocks[ChunkSection::localIndex(lx, ly, lz)] =
+                        getBlockConst(chunkX * CHUNK_SIZE + lx, sectionY * CHUNK_SIZE + ly, chunkZ * CHUNK_SIZE + lz);
+                }
+            }
         }
-        
-        // 检查下面 (y-1)
-        if (y == 0 || isTransparent(blocks[getIndex(x, y - 1, z)].type)) {
-            hasTransparentNeighbor = true;
+        buildSectionBits(section, transparent, solid);
+    }
+    
+    // 用位集并行计算所有常驻方块的面掩码
+    // 第一步：每个分段生成透明/实心位集（每个字64个方块）
+    // 第二步：结合六个相邻分段的位集，用移位和与运算得出每个面是否暴露
+    void updateBlockVisibility() {
+        // 先在主线程解压冷分段并确保分段独占，后台线程只写独占的分段
+        std::vector<ChunkColumn*> columnList;
+        std::unordered_map<uint64_t, size_t> columnIndex;
+        columnList.reserve(columns.size());
+        for (auto& entry : columns) {
+            ChunkColumn& column = entry.second;
+            for (int sectionY = 0; sectionY < static_cast<int>(column.sections.size()); sectionY++) {
+                residentSection(column, sectionY);
+                ChunkSectionPtr& section = column.sections[sectionY];
+                if (section.use_count() > 1) {
+                    section = std::make_shared<ChunkSection>(*section);
+                    residencyStats.uniqueSections++;
+                    residencyStats.uniqueBytes += sizeof(ChunkSection);
+                }
+            }
+            columnIndex[entry.first] = columnList.size();
+            columnList.push_back(&column);
         }
         
-        // 如果方块是半透明的，始终渲染它
-        if (block.type == BLOCK_WATER || block.type == BLOCK_LEAVES || block.type == BLOCK_LAVA) {
-            hasTransparentNeighbor = true;
+        size_t sectionCount = columnList.size() * chunksY;
+        std::vector<SectionBits> transparentBits(sectionCount);
+        std::vector<SectionBits> solidBits(sectionCount);
+        runParallel(columnList.size(), [&](size_t i) {
+            for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                size_t index = i * chunksY + sectionY;
+                buildSectionBits(*columnList[i]->sections[sectionY], transparentBits[index], solidBits[index]);
+            }
+        });
+        
+        // 未加载的相邻区块列（世界边界外或超平坦世界中未分配的区块列）
+        std::unordered_map<uint64_t, std::vector<SectionBits>> missingBits;
+        static const int sideOffsets[4][2] = { {0, 1}, {0, -1}, {-1, 0}, {1, 0} }; // 前/后/左/右
+        for (ChunkColumn* column : columnList) {
+            for (int side = 0; side < 4; side++) {
+                int neighbourX = column->chunkX + sideOffsets[side][0];
+                int neighbourZ = column->chunkZ + sideOffsets[side][1];
+                uint64_t key = chunkColumnKey(neighbourX, neighbourZ);
+                if (columnIndex.count(key) || missingBits.count(key)) continue;
+                std::vector<SectionBits>& bits = missingBits[key];
+                bits.resize(chunksY);
+                for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                    buildMissingSectionBits(neighbourX, sectionY, neighbourZ, bits[sectionY]);
+                }
+            }
         }
         
-        // 设置方块可见性
-        block.isVisible = hasTransparentNeighbor;
-    }
-    
-    // 更新特定坐标方块的可见性
-    void updateBlockVisibility(int x, int y, int z) {
-        updateBlockVisibilityAt(x, y, z);
+        SectionBits openBits; // 世界上下边界外视为透明
+        openBits.fill(true);
+        
+        runParallel(columnList.size(), [&](size_t i) {
+            ChunkColumn& column = *columnList[i];
+            const SectionBits* sideColumns[4];
+            for (int side = 0; side < 4; side++) {
+                uint64_t key = chunkColumnKey(column.chunkX + sideOffsets[side][0], column.chunkZ + sideOffsets[side][1]);
+                auto found = columnIndex.find(key);
+                sideColumns[side] = found != columnIndex.end() ? &transparentBits[found->second * chunksY]
+                                                               : missingBits.find(key)->second.data();
+            }
+            
+            uint8_t masks[CHUNK_VOLUME];
+            for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                size_t index = i * chunksY + sectionY;
+                const SectionBits* neighbours[FACE_COUNT];
+                neighbours[FACE_FRONT] = sideColumns[0] + sectionY;
+                neighbours[FACE_BACK] = sideColumns[1] + sectionY;
+                neighbours[FACE_LEFT] = sideColumns[2] + sectionY;
+                neighbours[FACE_RIGHT] = sideColumns[3] + sectionY;
+                neighbours[FACE_TOP] = sectionY + 1 < chunksY ? &transparentBits[index + 1] : &openBits;
+                neighbours[FACE_BOTTOM] = sectionY > 0 ? &transparentBits[index - 1] : &openBits;
+                
+                computeSectionFaceMasks(transparentBits[index], solidBits[index], neighbours, masks);
+                applySectionFaceMasks(*column.sections[sectionY], masks);
+            }
+        });
         
-        // 确保更新下方方块的可见性（修复挖掉方块后下方方块不可见的问题）
-        if (y > 0) {
-            updateBlockVisibilityAt(x, y-1, z);
+        // 面掩码整体重算后所有网格都需要重新生成
+        for (ChunkColumn* column : columnList) {
+            for (uint64_t& revision : column->revisions) {
+                revision = ++sectionRevisionCounter;
+            }
         }
     }
     
-    // 更新所有方块可见性（只渲染可见的方块面）
-    void updateBlockVisibility() {
-        // 获取地表高度图（用于地下渲染优化）
-        std::vector<int> surfaceHeightMap(width * depth, 0);
-        for (int z = 0; z < depth; z++) {
-            for (int x = 0; x < width; x++) {
-                for (int y = height - 1; y >= 0; y--) {
-                    BlockType blockType = blocks[getIndex(x, y, z)].type;
-                    if (blockType != BLOCK_AIR && blockType != BLOCK_WATER) {
-                        surfaceHeightMap[z * width + x] = y;
-                        break;
-                    }
-                }
+    // 修正新并入区块列与相邻区块列接缝处的面掩码
+    // 后台生成时看不到相邻区块列，接缝处的方块被保守地标记为暴露
+    void updateColumnSeamVisibility(int chunkX, int chunkZ) {
+        int baseX = chunkX * CHUNK_SIZE;
+        int baseZ = chunkZ * CHUNK_SIZE;
+        for (int y = 0; y < height; y++) {
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                // 新区块列的四条边
+                storeBlockFaceMask(baseX + i, y, baseZ);
+                storeBlockFaceMask(baseX + i, y, baseZ + CHUNK_SIZE - 1);
+                storeBlockFaceMask(baseX, y, baseZ + i);
+                storeBlockFaceMask(baseX + CHUNK_SIZE - 1, y, baseZ + i);
+                
+                // 相邻区块列朝向新区块列的边（未加载的相邻区块列跳过）
+                if (findColumn(chunkX, chunkZ - 1)) storeBlockFaceMask(baseX + i, y, baseZ - 1);
+                if (findColumn(chunkX, chunkZ + 1)) storeBlockFaceMask(baseX + i, y, baseZ + CHUNK_SIZE);
+                if (findColumn(chunkX - 1, chunkZ)) storeBlockFaceMask(baseX - 1, y, baseZ + i);
+                if (findColumn(chunkX + 1, chunkZ)) storeBlockFaceMask(baseX + CHUNK_SIZE, y, baseZ + i);
             }
         }
-        
-        for (int z = 0; z < depth; z++) {
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int index = getIndex(x, y, z);
-                    Block& block = blocks[index];
-                    
-                    // 空气方块始终不可见
-                    if (block.type == BLOCK_AIR) {
-                        block.isVisible = false;
-                        continue;
-                    }
-                    
-                    // 地下渲染优化：如果方块完全被其他方块包围且在地表以下，则不渲染
-                    int surfaceHeight = surfaceHeightMap[z * width + x];
-                    bool isUnderground = y < surfaceHeight - 1; // 在地表以下至少2个方块
-                    
-                    if (isUnderground) {
-                        // 检查是否完全被不透明方块包围
-                        bool completelyHidden = true;
-                        
-                        // 检查六个面是否有相邻的透明方块
-                        // 前面 (z+1)
-                        if (z == depth - 1 || isTransparent(blocks[getIndex(x, y, z + 1)].type)) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 后面 (z-1)
-                        if (completelyHidden && (z == 0 || isTransparent(blocks[getIndex(x, y, z - 1)].type))) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 左面 (x-1)
-                        if (completelyHidden && (x == 0 || isTransparent(blocks[getIndex(x - 1, y, z)].type))) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 右面 (x+1)
-                        if (completelyHidden && (x == width - 1 || isTransparent(blocks[getIndex(x + 1, y, z)].type))) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 上面 (y+1)
-                        if (completelyHidden && (y == height - 1 || isTransparent(blocks[getIndex(x, y + 1, z)].type))) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 下面 (y-1)
-                        if (completelyHidden && (y == 0 || isTransparent(blocks[getIndex(x, y - 1, z)].type))) {
-                            completelyHidden = false;
-                        }
-                        
-                        // 如果完全被包围，则不可见
-                        if (completelyHidden) {
-                            block.isVisible = false;
-                            continue;
+    }
+    
+    // 把分段及周围1格复制到apron中（世界范围外和未加载的区块列为空气，超平坦世界按层列表解析）
+    // 按3x3x3个相邻分段整块复制，每个分段只查找一次
+    void fillApron(int chunkX, int sectionY, int chunkZ, ChunkApron& apron) const {
+        // 每个轴上的三段：边框-1、分段内0..15、边框16
+        static const int rangeStart[3] = { -1, 0, CHUNK_SIZE };
+        static const int rangeEnd[3] = { 0, CHUNK_SIZE, CHUNK_SIZE + 1 };
+        
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int neighbourSectionY = sectionY + dy;
+                    const ChunkSection* section = nullptr;
+                    ChunkColumn* column = nullptr;
+                    if (neighbourSectionY >= 0 && neighbourSectionY < chunksY) {
+                        column = findColumn(chunkX + dx, chunkZ + dz);
+                        if (column) {
+                            section = &residentSection(*column, neighbourSectionY);
                         }
                     }
+                    bool useFlatLayers = !column && !flatLayers.isEmpty() &&
+                                         neighbourSectionY >= 0 && neighbourSectionY < chunksY;
                     
-                    // 检查六个面是否有相邻的透明方块
-                    bool hasTransparentNeighbor = false;
-                    
-                    // 检查前面 (z+1)
-                    if (z == depth - 1 || isTransparent(blocks[getIndex(x, y, z + 1)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 检查后面 (z-1)
-                    if (z == 0 || isTransparent(blocks[getIndex(x, y, z - 1)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 检查左面 (x-1)
-                    if (x == 0 || isTransparent(blocks[getIndex(x - 1, y, z)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 检查右面 (x+1)
-                    if (x == width - 1 || isTransparent(blocks[getIndex(x + 1, y, z)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 检查上面 (y+1)
-                    if (y == height - 1 || isTransparent(blocks[getIndex(x, y + 1, z)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 检查下面 (y-1)
-                    if (y == 0 || isTransparent(blocks[getIndex(x, y - 1, z)].type)) {
-                        hasTransparentNeighbor = true;
-                    }
-                    
-                    // 如果方块是半透明的，始终渲染它
-                    if (block.type == BLOCK_WATER || block.type == BLOCK_LEAVES || block.type == BLOCK_LAVA) {
-                        hasTransparentNeighbor = true;
+                    for (int lz = rangeStart[dz + 1]; lz < rangeEnd[dz + 1]; lz++) {
+                        for (int ly = rangeStart[dy + 1]; ly < rangeEnd[dy + 1]; ly++) {
+                            uint8_t* out = apron.types + ChunkApron::index(0, ly, lz);
+                            for (int lx = rangeStart[dx + 1]; lx < rangeEnd[dx + 1]; lx++) {
+                                BlockType type = BLOCK_AIR;
+                                if (section) {
+                                    type = section->blocks[ChunkSection::localIndex(lx & CHUNK_MASK, ly & CHUNK_MASK, lz & CHUNK_MASK)].type;
+                                } else if (useFlatLayers) {
+                                    type = getBlockConst(chunkX * CHUNK_SIZE + lx, sectionY * CHUNK_SIZE + ly, chunkZ * CHUNK_SIZE + lz).type;
+                                }
+                                out[lx] = static_cast<uint8_t>(type);
+                            }
+                        }
                     }
-                    
-                    // 设置方块可见性
-                    block.isVisible = hasTransparentNeighbor;
                 }
             }
         }
     }
     
-    // 统计矿物数量
-    void countOres() {
-        std::cout << "========== Ore Statistics ==========" << std::endl;
-        
-        // 用于存储每种矿物的计数
-        std::map<BlockType, int> oreCount;
-        std::map<BlockType, std::string> oreNames = {
-            {BLOCK_COAL_ORE, "Coal Ore"},
-            {BLOCK_IRON_ORE, "Iron Ore"},
-            {BLOCK_GOLD_ORE, "Gold Ore"},
-            {BLOCK_DIAMOND_ORE, "Diamond Ore"},
-            {BLOCK_REDSTONE_ORE, "Redstone Ore"},
-            {BLOCK_EMERALD_ORE, "Emerald Ore"},
-            {BLOCK_LAVA, "Lava Source"}
-        };
-        
-        // 遍历所有方块
-        for (int z = 0; z < depth; z++) {
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    BlockType type = blocks[getIndex(x, y, z)].type;
-                    
-                    // 检查是否是矿物
-                    if (oreNames.find(type) != oreNames.end()) {
-                        oreCount[type]++;
-                    }
+    // apron基准测试结果
+    struct ApronBenchmarkResult {
+        int sections = 0;          // 测试的分段数
+        double accessorMs = 0.0;   // 逐方块通过访问器计算面掩码的耗时
+        double apronMs = 0.0;      // 复制apron并运行无分支内核的耗时（含复制）
+        double copyMs = 0.0;       // 其中复制apron的耗时
+        bool matched = true;       // 两种路径的结果是否一致
+    };
+    
+    // 比较两种面掩码计算路径的吞吐量：相机周围radiusChunks内的所有已加载分段
+    ApronBenchmarkResult benchmarkApron(const Vec3& center, int radiusChunks) const {
+        ApronBenchmarkResult result;
+        int centerX = static_cast<int>(std::floor(center.x)) >> CHUNK_SHIFT;
+        int centerZ = static_cast<int>(std::floor(center.z)) >> CHUNK_SHIFT;
+        
+        std::vector<std::pair<int, int>> targets;
+        for (int chunkZ = centerZ - radiusChunks; chunkZ <= centerZ + radiusChunks; chunkZ++) {
+            for (int chunkX = centerX - radiusChunks; chunkX <= centerX + radiusChunks; chunkX++) {
+                if (findColumn(chunkX, chunkZ)) {
+                    targets.push_back(std::make_pair(chunkX, chunkZ));
                 }
             }
         }
-        
+        result.sections = static_cast<int>(targets.size()) * chunksY;
+        
+        uint8_t masks[CHUNK_VOLUME];
+        uint64_t accessorChecksum = 1469598103934665603ULL;
+        uint64_t apronChecksum = 1469598103934665603ULL;
+        
+        // 访问器路径
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& target : targets) {
+            for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+                    for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+                        for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                            int x = target.first * CHUNK_SIZE + lx;
+                            int y = sectionY * CHUNK_SIZE + ly;
+                            int z = target.second * CHUNK_SIZE + lz;
+                            masks[ChunkSection::localIndex(lx, ly, lz)] = isInBounds(x, y, z) ? computeBlockFaceMask(x, y, z) : 0;
+                        }
+                    }
+                }
+                accessorChecksum = faceMaskChecksum(masks, accessorChecksum);
+            }
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        
+        // apron路径
+        ChunkApron apron;
+        double copySeconds = 0.0;
+        for (const auto& target : targets) {
+            for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                auto copyStart = std::chrono::high_resolution_clock::now();
+                fillApron(target.first, sectionY, target.second, apron);
+                copySeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - copyStart).count();
+                computeApronFaceMasks(apron, masks);
+                apronChecksum = faceMaskChecksum(masks, apronChecksum);
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        
+        result.accessorMs = std::chrono::duration<double, std::milli>(middle - start).count();
+        result.apronMs = std::chrono::duration<double, std::milli>(end - middle).count();
+        result.copyMs = copySeconds * 1000.0;
+        result.matched = accessorChecksum == apronChecksum;
+        
+        std::cout << "Apron benchmark: " << result.sections << " sections, accessor " << result.accessorMs
+                  << " ms, apron " << result.apronMs << " ms (copy " << result.copyMs << " ms), "
+                  << (result.matched ? "results match" : "RESULTS DIFFER") << std::endl;
+        return result;
+    }
+    
+    // 分段的当前修订号（没有内容的分段返回0）
+    uint64_t getSectionRevision(int chunkX, int sectionY, int chunkZ) const {
+        if (sectionY < 0 || sectionY >= chunksY) {
+            return 0;
+        }
+        ChunkColumn* column = findColumn(chunkX, chunkZ);
+        if (column) {
+            return column->revisions[sectionY];
+        }
+        if (!flatLayers.isEmpty() && (infiniteWorld || isInBounds(chunkX * CHUNK_SIZE, 0, chunkZ * CHUNK_SIZE))) {
+            return flatRevision;
+        }
+        return 0;
+    }
+    
+    // 分段当前内容的只读引用（超平坦世界中未分配的分段按层列表解析到临时分段）
+    // 之后对分段的编辑会先复制一份再写入，引用看到的内容保持不变
+    ConstChunkSectionPtr snapshotSection(int chunkX, int sectionY, int chunkZ) const {
+        ChunkColumn* column = findColumn(chunkX, chunkZ);
+        if (column) {
+            residentSection(*column, sectionY);
+            return column->sections[sectionY];
+        }
+        
+        int originX = chunkX * CHUNK_SIZE;
+        int originY = sectionY * CHUNK_SIZE;
+        int originZ = chunkZ * CHUNK_SIZE;
+        auto section = std::make_shared<ChunkSection>();
+        for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+            for (int ly = 0; ly < CHUNK_SIZE; ly++) {
+                for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                    section->blocks[ChunkSection::localIndex(lx, ly, lz)] =
+                        getBlockConst(originX + lx, originY + ly, originZ + lz);
+                }
+            }
+        }
+        return section;
+    }
+    
+    // 由分段当前内容生成网格（lod大于0时生成降采样网格）
+    void buildSectionMeshAt(int chunkX, int sectionY, int chunkZ, ChunkMesh& mesh, bool greedy, int lod = 0) const {
+        ConstChunkSectionPtr section = snapshotSection(chunkX, sectionY, chunkZ);
+        int originX = chunkX * CHUNK_SIZE;
+        int originY = sectionY * CHUNK_SIZE;
+        int originZ = chunkZ * CHUNK_SIZE;
+        if (lod > 0) {
+            buildSectionLodMesh(*section, originX, originY, originZ, lod, mesh);
+        } else if (greedy) {
+            buildSectionMeshGreedy(*section, originX, originY, originZ, mesh);
+        } else {
+            buildSectionMesh(*section, originX, originY, originZ, mesh);
+        }
+    }
+    
+    // 取得分段第lod级的网格，分段内容变化后才重新生成；没有内容的分段返回空指针
+    // 启用后台生成时不会阻塞：过期的分段加入本帧的请求（priority越小越先生成），
+    // 结果回来之前返回旧网格；这一级还没有网格时借用已缓存的相邻级别（都没有时返回空指针），
+    // 返回的网格的级别见ChunkMesh::lod
+    const ChunkMesh* getSectionMesh(int chunkX, int sectionY, int chunkZ, float priority = 0.0f, int lod = 0) const {
+        uint64_t revision = getSectionRevision(chunkX, sectionY, chunkZ);
+        if (revision == 0) {
+            return nullptr;
+        }
+        if (!meshWorkers) {
+            return &meshCache.get(chunkX, sectionY, chunkZ, lod, revision, [&](ChunkMesh& mesh) {
+                buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, greedyMeshing, lod);
+            });
+        }
+        
+        const ChunkMesh* mesh = meshCache.find(chunkX, sectionY, chunkZ, lod);
+        if (!mesh || mesh->revision != revision) {
+            uint64_t key = ChunkMeshCache::key(chunkX, sectionY, chunkZ, lod);
+            if (meshRequestKeys.insert(key).second) {
+                MeshJob request;
+                request.chunkX = chunkX;
+                request.sectionY = sectionY;
+                request.chunkZ = chunkZ;
+                request.revision = revision;
+                request.epoch = meshCache.getEpoch();
+                request.greedy = greedyMeshing;
+                request.lod = lod;
+                request.priority = priority;
+                meshRequests.push_back(request);
+            }
+        }
+        for (int step = 1; !mesh && step < MESH_LOD_LEVELS; step++) {
+            if (lod - step >= 0) mesh = meshCache.find(chunkX, sectionY, chunkZ, lod - step);
+            if (!mesh && lod + step < MESH_LOD_LEVELS) mesh = meshCache.find(chunkX, sectionY, chunkZ, lod + step);
+        }
+        return mesh;
+    }
+    
+    // 取得已缓存且与分段内容一致的网格（任一细节级别），不会请求生成（遮挡剔除收集遮挡盒用）
+    const ChunkMesh* findCurrentSectionMesh(int chunkX, int sectionY, int chunkZ) const {
+        uint64_t revision = getSectionRevision(chunkX, sectionY, chunkZ);
+        if (revision == 0) {
+            return nullptr;
+        }
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            const ChunkMesh* mesh = meshCache.find(chunkX, sectionY, chunkZ, lod);
+            if (mesh && mesh->revision == revision) return mesh;
+        }
+        return nullptr;
+    }
+    
+    // 按分段中心到相机的距离选择细节级别（带回差，见selectMeshLod）
+    int selectSectionLod(int chunkX, int sectionY, int chunkZ, float distance) const {
+        return meshCache.selectLod(chunkX, sectionY, chunkZ, distance);
+    }
+    
+    // 开关后台网格生成（状态不变时不做任何事）
+    void setMeshThreadsEnabled(bool enabled) {
+        if (enabled == (meshWorkers != nullptr)) {
+            return;
+        }
+        meshRequests.clear();
+        meshRequestKeys.clear();
+        if (enabled) {
+            int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+            int workerCount = std::max(1, std::min(4, hardwareThreads - 1));
+            meshWorkers.reset(new ChunkMeshWorkers(workerCount));
+            std::cout << "Mesh workers: " << workerCount << " threads" << std::endl;
+        } else {
+            // 等待工作线程退出，未取回的结果随线程池一起丢弃
+            meshWorkers.reset();
+            std::cout << "Mesh workers: disabled" << std::endl;
+        }
+    }
+    
+    // 把本帧收集的网格请求按优先级提交给工作线程（每帧渲染结束时调用）
+    void submitMeshJobs() const {
+        if (!meshWorkers) {
+            return;
+        }
+        std::sort(meshRequests.begin(), meshRequests.end(), [](const MeshJob& a, const MeshJob& b) {
+            return a.priority < b.priority;
+        });
+        meshWorkers->submit(meshRequests, [this](const MeshJob& job) {
+            return snapshotSection(job.chunkX, job.sectionY, job.chunkZ);
+        });
+        meshRequests.clear();
+        meshRequestKeys.clear();
+    }
+    
+    // 在时间预算内取回后台生成的网格放入缓存（每帧渲染开始时调用）
+    // 清空缓存或切换合并方式之前提交的结果直接丢弃
+    int collectMeshResults(double budgetMs) const {
+        if (!meshWorkers) {
+            return 0;
+        }
+        auto start = std::chrono::high_resolution_clock::now();
+        int installed = 0;
+        MeshJobResult result;
+        while (meshWorkers->tryCollect(result)) {
+            if (result.epoch == meshCache.getEpoch() && result.greedy == greedyMeshing &&
+                meshCache.install(result.chunkX, result.sectionY, result.chunkZ, result.lod, result.revision, std::move(result.mesh))) {
+                installed++;
+            }
+            result.mesh.clear();
+            result.section.reset();
+            double elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+            if (elapsedMs >= budgetMs) {
+                break;
+            }
+        }
+        return installed;
+    }
+    
+    // 获取网格统计
+    ChunkMeshStats getMeshStats() const {
+        ChunkMeshStats stats = meshCache.getStats();
+        stats.greedy = greedyMeshing;
+        stats.threaded = meshWorkers != nullptr;
+        stats.pendingJobs = meshWorkers ? meshWorkers->getPendingCount() : 0;
+        return stats;
+    }
+    
+    // 切换贪心合并（已缓存的网格全部作废）
+    void toggleGreedyMeshing() {
+        greedyMeshing = !greedyMeshing;
+        meshCache.clear();
+        std::cout << "Greedy meshing: " << (greedyMeshing ? "enabled" : "disabled") << std::endl;
+    }
+    
+    bool isGreedyMeshing() const {
+        return greedyMeshing;
+    }
+    
+    // 网格基准测试结果
+    struct MeshBenchmarkResult {
+        int sections = 0;          // 生成网格的分段数
+        int quads = 0;             // 生成的四边形总数
+        int exposedFaces = 0;      // 面掩码中置位的面总数（应与四边形数相同）
+        double meshMs = 0.0;       // 生成网格的总耗时
+        uint64_t checksum = 0;     // 所有网格顶点的校验和（两次生成应一致）
+        int greedyQuads = 0;       // 贪心合并后的四边形总数
+        int maxQuadReduction = 0;  // 单个分段合并减少的最多四边形数
+        double greedyMs = 0.0;     // 贪心合并生成网格的总耗时
+        double maxGreedySectionMs = 0.0; // 单个分段贪心合并的最长耗时
+        bool matched = true;       // 四边形数与暴露面数一致、重复生成的校验和相同，且贪心网格覆盖的面数不变
+    };
+    
+    // 对相机周围radiusChunks内的已加载分段生成网格，统计四边形数并校验结果（不需要图形设备）
+    MeshBenchmarkResult benchmarkMesh(const Vec3& center, int radiusChunks) const {
+        MeshBenchmarkResult result;
+        int centerX = static_cast<int>(std::floor(center.x)) >> CHUNK_SHIFT;
+        int centerZ = static_cast<int>(std::floor(center.z)) >> CHUNK_SHIFT;
+        
+        ChunkMesh mesh;
+        uint64_t checksum = 1469598103934665603ULL;
+        uint64_t repeatChecksum = 1469598103934665603ULL;
+        double seconds = 0.0;
+        double greedySecondsTotal = 0.0;
+        int greedyFaces = 0;
+        for (int chunkZ = centerZ - radiusChunks; chunkZ <= centerZ + radiusChunks; chunkZ++) {
+            for (int chunkX = centerX - radiusChunks; chunkX <= centerX + radiusChunks; chunkX++) {
+                ChunkColumn* column = findColumn(chunkX, chunkZ);
+                if (!column) continue;
+                for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                    const ChunkSection& section = residentSection(*column, sectionY);
+                    for (int i = 0; i < CHUNK_VOLUME; i++) {
+                        if (section.blocks[i].type == BLOCK_AIR) continue;
+                        for (int face = 0; face < FACE_COUNT; face++) {
+                            if (section.blocks[i].faceMask & (1 << face)) result.exposedFaces++;
+                        }
+                    }
+                    
+                    auto start = std::chrono::high_resolution_clock::now();
+                    buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, false);
+                    seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                    int sectionQuads = mesh.totalQuads();
+                    result.quads += sectionQuads;
+                    checksum = meshChecksum(mesh, checksum);
+                    
+                    buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, false);
+                    repeatChecksum = meshChecksum(mesh, repeatChecksum);
+                    
+                    start = std::chrono::high_resolution_clock::now();
+                    buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, true);
+                    double greedySeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                    greedySecondsTotal += greedySeconds;
+                    result.maxGreedySectionMs = std::max(result.maxGreedySectionMs, greedySeconds * 1000.0);
+                    result.greedyQuads += mesh.totalQuads();
+                    result.maxQuadReduction = std::max(result.maxQuadReduction, sectionQuads - mesh.totalQuads());
+                    greedyFaces += mesh.faceCount;
+                    result.sections++;
+                }
+            }
+        }
+        
+        result.meshMs = seconds * 1000.0;
+        result.checksum = checksum;
+        result.greedyMs = greedySecondsTotal * 1000.0;
+        result.matched = result.quads == result.exposedFaces && checksum == repeatChecksum &&
+                         greedyFaces == result.exposedFaces;
+        
+        std::cout << "Mesh benchmark: " << result.sections << " sections, " << result.quads << " quads ("
+                  << result.exposedFaces << " exposed faces), " << result.meshMs << " ms, checksum "
+                  << std::hex << result.checksum << std::dec << "; greedy " << result.greedyQuads << " quads, "
+                  << result.greedyMs << " ms (max " << result.maxGreedySectionMs << " ms/section, up to "
+                  << result.maxQuadReduction << " fewer quads/section), "
+                  << (result.matched ? "results match" : "RESULTS DIFFER") << std::endl;
+        return result;
+    }
+    
+    // 细节级别基准测试的结果
+    struct LodBenchmarkResult {
+        int sections = 0;
+        int quads[MESH_LOD_LEVELS] = {};     // 各级网格的四边形总数
+        double meshMs[MESH_LOD_LEVELS] = {}; // 各级网格的生成总耗时
+        bool matched = true;                 // 各级网格都不比上一级多，且重复生成的校验和相同
+    };
+    
+    // 对相机周围radiusChunks内的已加载分段生成每一级网格，统计各级的四边形数（不需要图形设备）
+    LodBenchmarkResult benchmarkLod(const Vec3& center, int radiusChunks) const {
+        LodBenchmarkResult result;
+        int centerX = static_cast<int>(std::floor(center.x)) >> CHUNK_SHIFT;
+        int centerZ = static_cast<int>(std::floor(center.z)) >> CHUNK_SHIFT;
+        
+        ChunkMesh mesh;
+        uint64_t checksum[MESH_LOD_LEVELS];
+        uint64_t repeatChecksum[MESH_LOD_LEVELS];
+        double seconds[MESH_LOD_LEVELS] = {};
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            checksum[lod] = repeatChecksum[lod] = 1469598103934665603ULL;
+        }
+        for (int chunkZ = centerZ - radiusChunks; chunkZ <= centerZ + radiusChunks; chunkZ++) {
+            for (int chunkX = centerX - radiusChunks; chunkX <= centerX + radiusChunks; chunkX++) {
+                if (!findColumn(chunkX, chunkZ)) continue;
+                for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                    for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+                        auto start = std::chrono::high_resolution_clock::now();
+                        buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, false, lod);
+                        seconds[lod] += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                        result.quads[lod] += mesh.totalQuads();
+                        checksum[lod] = meshChecksum(mesh, checksum[lod]);
+                        
+                        buildSectionMeshAt(chunkX, sectionY, chunkZ, mesh, false, lod);
+                        repeatChecksum[lod] = meshChecksum(mesh, repeatChecksum[lod]);
+                    }
+                    result.sections++;
+                }
+            }
+        }
+        
+        std::cout << "LOD benchmark: " << result.sections << " sections";
+        for (int lod = 0; lod < MESH_LOD_LEVELS; lod++) {
+            result.meshMs[lod] = seconds[lod] * 1000.0;
+            if (checksum[lod] != repeatChecksum[lod]) result.matched = false;
+            if (lod > 0 && result.quads[lod] > result.quads[lod - 1]) result.matched = false;
+            std::cout << "; " << (1 << lod) << "x " << result.quads[lod] << " quads, " << result.meshMs[lod] << " ms";
+        }
+        std::cout << ", " << (result.matched ? "results match" : "RESULTS DIFFER") << std::endl;
+        return result;
+    }
+    
+    // 分段的方块类型索引，分段内容变化后才重新扫描；没有内容的分段返回空指针
+    const SectionBlockIndex* getSectionBlockIndex(int chunkX, int sectionY, int chunkZ) const {
+        uint64_t revision = getSectionRevision(chunkX, sectionY, chunkZ);
+        if (revision == 0) {
+            return nullptr;
+        }
+        // 没有生成的超平坦分段按层号共用索引，搜索或X-ray经过再多区块列也不会增加索引
+        if (!findColumn(chunkX, chunkZ)) {
+            if (static_cast<int>(flatBlockIndices.size()) != chunksY) {
+                flatBlockIndices.assign(chunksY, SectionBlockIndex());
+            }
+            SectionBlockIndex& index = flatBlockIndices[sectionY];
+            if (index.revision != revision) {
+                buildSectionBlockIndex(*snapshotSection(chunkX, sectionY, chunkZ), revision, index);
+            }
+            return &index;
+        }
+        SectionBlockIndex& index = blockIndices[ChunkMeshCache::key(chunkX, sectionY, chunkZ)];
+        if (index.revision != revision) {
+            buildSectionBlockIndex(*snapshotSection(chunkX, sectionY, chunkZ), revision, index);
+        }
+        return &index;
+    }
+    
+    // 查找最近方块的结果
+    struct LocateResult {
+        bool found = false;
+        int x = 0;
+        int y = 0;
+        int z = 0;
+        float distance = 0.0f;    // 到起点的距离（格）
+        int sectionsChecked = 0;  // 查看过类型索引的分段数
+        int sectionsScanned = 0;  // 索引中有这种方块、逐个查找的分段数
+        double searchMs = 0.0;
+    };
+    
+    // 从from出发按区块列一圈圈向外查找最近的type方块（最多radiusChunks圈，只查已加载的区块列）
+    // 类型索引里没有这种方块的分段直接跳过；矿物直接用索引中的矿物列表
+    LocateResult locateBlock(BlockType type, const Vec3& from, int radiusChunks) const {
+        LocateResult result;
+        auto start = std::chrono::high_resolution_clock::now();
+        int centerX = static_cast<int>(std::floor(from.x)) >> CHUNK_SHIFT;
+        int centerZ = static_cast<int>(std::floor(from.z)) >> CHUNK_SHIFT;
+        float bestDistSq = FLT_MAX;
+        
+        auto consider = [&](int x, int y, int z) {
+            float dx = x + 0.5f - from.x;
+            float dy = y + 0.5f - from.y;
+            float dz = z + 0.5f - from.z;
+            float distSq = dx * dx + dy * dy + dz * dz;
+            if (distSq < bestDistSq) {
+                bestDistSq = distSq;
+                result.found = true;
+                result.x = x;
+                result.y = y;
+                result.z = z;
+            }
+        };
+        auto searchColumn = [&](int chunkX, int chunkZ) {
+            for (int sectionY = 0; sectionY < chunksY; sectionY++) {
+                const SectionBlockIndex* index = getSectionBlockIndex(chunkX, sectionY, chunkZ);
+                if (!index) return;
+                result.sectionsChecked++;
+                if (!index->contains(type)) continue;
+                result.sectionsScanned++;
+                int originX = chunkX * CHUNK_SIZE;
+                int originY = sectionY * CHUNK_SIZE;
+                int originZ = chunkZ * CHUNK_SIZE;
+                int lx, ly, lz;
+                if (isIndexedOre(type)) {
+                    for (const OreCell& ore : index->ores) {
+                        if (ore.type != type) continue;
+                        sectionCellCoords(ore.cell, lx, ly, lz);
+                        consider(originX + lx, originY + ly, originZ + lz);
+                    }
+                    continue;
+                }
+                ConstChunkSectionPtr section = snapshotSection(chunkX, sectionY, chunkZ);
+                for (int cell = 0; cell < CHUNK_VOLUME; cell++) {
+                    if (section->blocks[cell].type != type) continue;
+                    sectionCellCoords(cell, lx, ly, lz);
+                    consider(originX + lx, originY + ly, originZ + lz);
+                }
+            }
+        };
+        
+        for (int ring = 0; ring <= radiusChunks; ring++) {
+            // 第ring圈的区块列离起点的水平距离不小于(ring - 1)个区块，已经找到更近的就不用再往外找
+            float ringDistance = static_cast<float>((ring - 1) * CHUNK_SIZE);
+            if (ring > 1 && ringDistance * ringDistance > bestDistSq) break;
+            for (int dx = -ring; dx <= ring; dx++) {
+                searchColumn(centerX + dx, centerZ - ring);
+                if (ring > 0) searchColumn(centerX + dx, centerZ + ring);
+            }
+            for (int dz = -ring + 1; dz <= ring - 1; dz++) {
+                searchColumn(centerX - ring, centerZ + dz);
+                searchColumn(centerX + ring, centerZ + dz);
+            }
+        }
+        
+        result.distance = result.found ? std::sqrt(bestDistSq) : 0.0f;
+        result.searchMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        return result;
+    }
+    
+    // 统计矿物数量
+    void countOres() {
+        std::cout << "========== Ore Statistics ==========" << std::endl;
+        
+        // 用于存储每种矿物的计数
+        std::map<BlockType, int> oreCount;
+        std::map<BlockType, std::string> oreNames = {
+            {BLOCK_COAL_ORE, "Coal Ore"},
+            {BLOCK_IRON_ORE, "Iron Ore"},
+            {BLOCK_GOLD_ORE, "Gold Ore"},
+            {BLOCK_DIAMOND_ORE, "Diamond Ore"},
+            {BLOCK_REDSTONE_ORE, "Redstone Ore"},
+            {BLOCK_EMERALD_ORE, "Emerald Ore"},
+            {BLOCK_LAVA, "Lava Source"}
+        };
+        
+        // 遍历所有方块
+        for (int z = 0; z < depth; z++) {
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    BlockType type = blockAtConst(x, y, z).type;
+                    
+                    // 检查是否是矿物
+                    if (oreNames.find(type) != oreNames.end()) {
+                        oreCount[type]++;
+                    }
+                }
+            }
+        }
+        
         // 输出统计结果
         std::cout << "World Size: " << width << "x" << height << "x" << depth << std::endl;
         std::cout << "World Seed: " << worldSeed << std::endl;
@@ -1607,7 +2427,7 @@ private:
     }
     
 public:
-    World() : width(0), height(0), depth(0), isSuperFlat(false), superFlatBlockType(BLOCK_GRASS), 
+    World() : width(0), height(0), depth(0), chunksY(0), isSuperFlat(false), superFlatBlockType(BLOCK_GRASS), 
               spawnX(0), spawnY(0), spawnZ(0) {
         // 初始化随机数生成器
         std::random_device rd;
@@ -1688,7 +2508,7 @@ public:
         if (!isInBounds(x, y, z)) {
             return airBlock;
         }
-        return blocks[getIndex(x, y, z)];
+        return blockAt(x, y, z);
     }
     
     // 获取指定位置的方块（const版本）
@@ -1697,7 +2517,7 @@ public:
         if (!isInBounds(x, y, z)) {
             return airBlock;
         }
-        return blocks[getIndex(x, y, z)];
+        return blockAtConst(x, y, z);
     }
     
     // 设置指定位置的方块
@@ -1706,7 +2526,7 @@ public:
             return;
         }
         
-        blocks[getIndex(x, y, z)] = Block(type);
+        blockAt(x, y, z) = Block(type);
         
         // 更新该方块及其相邻方块的可见性
         updateBlockVisibilityAt(x, y, z);
@@ -1727,6 +2547,316 @@ public:
         spawnZ = z;
     }
     
+    // 创建世界快照（供后台自动保存使用）
+    // 只复制分段指针，主线程开销为O(区块数)；之后的写入会触发写时复制
+    WorldSnapshot createSnapshot() const {
+        WorldSnapshot snapshot;
+        snapshot.width = width;
+        snapshot.height = height;
+        snapshot.depth = depth;
+        snapshot.chunksY = chunksY;
+        snapshot.seed = worldSeed;
+        snapshot.superFlat = isSuperFlat;
+        snapshot.infinite = infiniteWorld;
+        snapshot.superFlatBlockType = superFlatBlockType;
+        snapshot.spawnPoint = Vec3(static_cast<float>(spawnX), static_cast<float>(spawnY), static_cast<float>(spawnZ));
+        
+        snapshot.columns.reserve(columns.size() + unloadedColumns.size());
+        for (const auto& entry : columns) {
+            const ChunkColumn& column = entry.second;
+            ColumnSnapshot columnSnapshot;
+            columnSnapshot.chunkX = column.chunkX;
+            columnSnapshot.chunkZ = column.chunkZ;
+            columnSnapshot.sections.assign(column.sections.begin(), column.sections.end());
+            columnSnapshot.coldSections = column.coldSections;
+            snapshot.columns.push_back(std::move(columnSnapshot));
+        }
+        
+        // 已卸载的编辑过的区块列也要写入存档
+        for (const auto& entry : unloadedColumns) {
+            ColumnSnapshot columnSnapshot;
+            columnSnapshot.chunkX = static_cast<int>(static_cast<uint32_t>(entry.first >> 32));
+            columnSnapshot.chunkZ = static_cast<int>(static_cast<uint32_t>(entry.first));
+            columnSnapshot.sections.resize(entry.second.size());
+            columnSnapshot.coldSections = entry.second;
+            snapshot.columns.push_back(std::move(columnSnapshot));
+        }
+        return snapshot;
+    }
+    
+    // 设置常驻分段的内存预算（字节）
+    void setResidencyBudget(size_t bytes) {
+        residencyBudgetBytes = bytes;
+    }
+    
+    // 获取驻留统计
+    ChunkResidencyStats getResidencyStats() const {
+        ChunkResidencyStats stats = residencyStats;
+        stats.budgetBytes = residencyBudgetBytes;
+        return stats;
+    }
+    
+    // 更新分段驻留状态（每帧调用）
+    // 超出内存预算时，把距离相机超过keepDistance（水平方向，方块单位）的分段按由远到近压缩进冷池
+    void updateResidency(const Vec3& cameraPos, float keepDistance) {
+        residencyUpdateCount++;
+        if (residencyUpdateCount % RESIDENCY_REPORT_INTERVAL == 0) {
+            sectionInterner.purgeExpired();
+            refreshMemoryReport();
+        }
+        if (residencyStats.uniqueBytes <= residencyBudgetBytes) {
+            return;
+        }
+        
+        struct EvictionCandidate {
+            float distSq;
+            ChunkColumn* column;
+            int sectionY;
+        };
+        
+        float keepDistanceSq = keepDistance * keepDistance;
+        std::vector<EvictionCandidate> candidates;
+        for (auto& entry : columns) {
+            ChunkColumn& column = entry.second;
+            float dx = column.chunkX * CHUNK_SIZE + CHUNK_SIZE * 0.5f - cameraPos.x;
+            float dz = column.chunkZ * CHUNK_SIZE + CHUNK_SIZE * 0.5f - cameraPos.z;
+            float distSq = dx * dx + dz * dz;
+            if (distSq <= keepDistanceSq) continue;
+            
+            for (int sectionY = 0; sectionY < static_cast<int>(column.sections.size()); sectionY++) {
+                if (!column.sections[sectionY]) continue;
+                // 共享的分段压缩后也释放不了内存，跳过
+                if (column.sections[sectionY].use_count() > 1) continue;
+                // 刚被唤醒的分段暂不压缩
+                if (residencyUpdateCount - column.wakeUpdate[sectionY] < RESIDENCY_COOLDOWN_UPDATES) continue;
+                candidates.push_back({distSq, &column, sectionY});
+            }
+        }
+        
+        // 最远的分段优先压缩
+        int evictCount = std::min(static_cast<int>(candidates.size()), RESIDENCY_MAX_EVICTIONS_PER_UPDATE);
+        std::partial_sort(candidates.begin(), candidates.begin() + evictCount, candidates.end(),
+            [](const EvictionCandidate& a, const EvictionCandidate& b) { return a.distSq > b.distSq; });
+        
+        for (int i = 0; i < evictCount && residencyStats.uniqueBytes > residencyBudgetBytes; i++) {
+            ChunkColumn& column = *candidates[i].column;
+            int sectionY = candidates[i].sectionY;
+            CompressedSectionPtr compressed = compressSection(*column.sections[sectionY]);
+            
+            residencyStats.compressions++;
+            residencyStats.residentSections--;
+            residencyStats.residentBytes -= sizeof(ChunkSection);
+            residencyStats.uniqueSections--;
+            residencyStats.uniqueBytes -= sizeof(ChunkSection);
+            residencyStats.coldSections++;
+            residencyStats.coldBytes += compressed->size();
+            
+            column.coldSections[sectionY] = compressed;
+            column.sections[sectionY].reset();
+        }
+    }
+    
+    // 初始化无限世界（水平方向不设边界）
+    // 出生点附近的区块列同步生成，其余区块列在updateStreaming中由后台线程按需生成
+    void initInfinite(int height, unsigned int seed, bool superFlat, BlockType flatBlockType) {
+        this->width = 0;
+        this->height = height;
+        this->depth = 0;
+        this->worldSeed = seed;
+        this->isSuperFlat = superFlat;
+        this->superFlatBlockType = flatBlockType;
+        this->infiniteWorld = true;
+        rng = std::mt19937(seed);
+        
+        chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        clearColumns();
+        streamer.reset();
+        
+        if (superFlat) {
+            // 超平坦无限世界不需要后台生成，未编辑的区块列直接按层列表解析
+            flatLayers.buildSingleLayer(flatBlockType, height);
+            flatRevision = ++sectionRevisionCounter;
+            findSpawnPoint();
+            std::cout << "Infinite world initialized: Height=" << height << ", Seed=" << seed
+                      << ", SuperFlat=true, Stream workers=0" << std::endl;
+            return;
+        }
+        flatLayers.clear();
+        
+        ColumnGenerator generator(seed, height, superFlat, flatBlockType);
+        for (int chunkZ = -STREAM_SPAWN_RADIUS_CHUNKS; chunkZ <= STREAM_SPAWN_RADIUS_CHUNKS; chunkZ++) {
+            for (int chunkX = -STREAM_SPAWN_RADIUS_CHUNKS; chunkX <= STREAM_SPAWN_RADIUS_CHUNKS; chunkX++) {
+                ChunkColumn column;
+                generator.generate(chunkX, chunkZ, column);
+                insertColumn(std::move(column));
+            }
+        }
+        
+        // 出生点区块列之间的接缝需要重新计算面掩码，之后再去重
+        updateBlockVisibility();
+        internAllSections();
+        
+        // 保留一个核心给主线程
+        int workerCount = std::max(1, std::min(3, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+        streamer.reset(new ChunkStreamer(generator, workerCount));
+        
+        findSpawnPoint();
+        
+        std::cout << "Infinite world initialized: Height=" << height << ", Seed=" << seed
+                  << ", SuperFlat=" << (superFlat ? "true" : "false")
+                  << ", Stream workers=" << workerCount << std::endl;
+    }
+    
+    // 是否为无限世界
+    bool isInfinite() const {
+        return infiniteWorld;
+    }
+    
+    // 更新无限世界的区块流式加载（每帧调用）
+    // 请求相机周围loadDistance（方块）内缺失的区块列，并入已生成的区块列，卸载超出范围的区块列
+    // 超平坦无限世界没有后台生成，只负责卸载/恢复编辑过的区块列
+    void updateStreaming(const Vec3& cameraPos, int loadDistance) {
+        if (!infiniteWorld) {
+            return;
+        }
+        
+        int centerX = static_cast<int>(std::floor(cameraPos.x)) >> CHUNK_SHIFT;
+        int centerZ = static_cast<int>(std::floor(cameraPos.z)) >> CHUNK_SHIFT;
+        int loadRadius = loadDistance / CHUNK_SIZE + 1;
+        int unloadRadius = loadRadius + STREAM_UNLOAD_MARGIN_CHUNKS;
+        
+        // 并入后台线程生成完成的区块列
+        std::vector<ChunkColumn> generated;
+        if (streamer) {
+            streamer->collect(generated, STREAM_MAX_INTEGRATIONS_PER_FRAME);
+        }
+        int changedColumns = 0;
+        for (auto& column : generated) {
+            int dx = column.chunkX - centerX;
+            int dz = column.chunkZ - centerZ;
+            bool inRange = dx * dx + dz * dz <= unloadRadius * unloadRadius;
+            if (inRange && columns.find(chunkColumnKey(column.chunkX, column.chunkZ)) == columns.end()) {
+                int chunkX = column.chunkX;
+                int chunkZ = column.chunkZ;
+                insertColumn(std::move(column));
+                updateColumnSeamVisibility(chunkX, chunkZ);
+                changedColumns++;
+            }
+        }
+        
+        // 卸载超出范围的区块列
+        for (auto it = columns.begin(); it != columns.end();) {
+            int dx = it->second.chunkX - centerX;
+            int dz = it->second.chunkZ - centerZ;
+            auto next = std::next(it);
+            if (dx * dx + dz * dz > unloadRadius * unloadRadius) {
+                unloadColumn(it);
+                changedColumns++;
+            }
+            it = next;
+        }
+        
+        // 收集缺失的区块列：编辑过的直接恢复，其余按距离排序后交给后台线程
+        std::vector<std::pair<int, std::pair<int, int>>> missing;
+        for (int dz = -loadRadius; dz <= loadRadius; dz++) {
+            for (int dx = -loadRadius; dx <= loadRadius; dx++) {
+                int distSq = dx * dx + dz * dz;
+                if (distSq > loadRadius * loadRadius) continue;
+                
+                int chunkX = centerX + dx;
+                int chunkZ = centerZ + dz;
+                uint64_t key = chunkColumnKey(chunkX, chunkZ);
+                if (columns.find(key) != columns.end()) continue;
+                
+                auto saved = unloadedColumns.find(key);
+                if (saved != unloadedColumns.end()) {
+                    restoreUnloadedColumn(saved, chunkX, chunkZ);
+                    changedColumns++;
+                    continue;
+                }
+                
+                if (streamer) {
+                    missing.push_back(std::make_pair(distSq, std::make_pair(chunkX, chunkZ)));
+                }
+            }
+        }
+        
+        // 区块列有进出时重新统计去重后的缓冲区数：网格任务或自动保存快照持有的分段引用
+        // 会让卸载和并入时的增减判断出错（卸载的缓冲区可能还活着，新分段可能去重到只剩外部引用的缓冲区）
+        if (changedColumns > 0) {
+            refreshMemoryReport();
+        }
+        if (!streamer) {
+            return;
+        }
+        
+        std::sort(missing.begin(), missing.end());
+        std::vector<std::pair<int, int>> requests;
+        requests.reserve(missing.size());
+        for (const auto& entry : missing) {
+            requests.push_back(entry.second);
+        }
+        streamer->setRequests(requests);
+    }
+    
+    // 获取已加载的区块列数
+    int getLoadedColumnCount() const {
+        return static_cast<int>(columns.size());
+    }
+    
+    // 获取等待后台生成的区块列数
+    int getPendingColumnCount() const {
+        return streamer ? streamer->getPendingCount() : 0;
+    }
+    
+    // 获取已卸载但保留了编辑内容的区块列数
+    int getUnloadedColumnCount() const {
+        return static_cast<int>(unloadedColumns.size());
+    }
+    
+    // 地平线远景的地表采样：已加载的区块列（和超平坦世界）从上往下找第一个非空气方块，
+    // 无限世界中未加载的区块列按地形生成器推算；有限世界的边界外没有地形，返回false
+    bool sampleSurface(int x, int z, int& top, BlockType& type) const {
+        if (!infiniteWorld && (x < 0 || z < 0 || x >= width || z >= depth)) {
+            return false;
+        }
+        if (findColumn(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT) || !flatLayers.isEmpty()) {
+            for (int y = height - 1; y >= 0; y--) {
+                const Block& block = blockAtConst(x, y, z);
+                if (block.type != BLOCK_AIR) {
+                    top = y + 1;
+                    type = block.type;
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (!infiniteWorld) {
+            return false;
+        }
+        ColumnGenerator(worldSeed, height, isSuperFlat, superFlatBlockType).surfaceAt(x, z, top, type);
+        return true;
+    }
+    
+    // 区域内区块列内容的摘要（各列分段修订号的最大值），地表变化、区块列加载或卸载后都会改变
+    uint64_t surfaceSignature(int minX, int minZ, int size) const {
+        uint64_t hash = 1469598103934665603ULL ^ worldSeed;
+        for (int chunkZ = minZ >> CHUNK_SHIFT; chunkZ <= (minZ + size) >> CHUNK_SHIFT; chunkZ++) {
+            for (int chunkX = minX >> CHUNK_SHIFT; chunkX <= (minX + size) >> CHUNK_SHIFT; chunkX++) {
+                uint64_t revision = 0;
+                if (ChunkColumn* column = findColumn(chunkX, chunkZ)) {
+                    for (uint64_t sectionRevision : column->revisions) {
+                        revision = std::max(revision, sectionRevision);
+                    }
+                } else if (!flatLayers.isEmpty()) {
+                    revision = flatRevision;
+                }
+                hash = (hash ^ revision) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+    
     // 切换X-ray模式
     void toggleXrayMode() {
         xrayMode = !xrayMode;
@@ -1740,14 +2870,14 @@ public:
     
     // 查找合适的出生点
     void findSpawnPoint() {
-        // 默认出生在世界中心
-        spawnX = width / 2;
-        spawnZ = depth / 2;
+        // 默认出生在世界中心（无限世界出生在原点所在区块的中心）
+        spawnX = infiniteWorld ? CHUNK_SIZE / 2 : width / 2;
+        spawnZ = infiniteWorld ? CHUNK_SIZE / 2 : depth / 2;
         spawnY = 0;
         
         // 从顶部向下搜索第一个非空气方块
         for (int y = height - 1; y >= 0; y--) {
-            if (getBlock(spawnX, y, spawnZ).type != BLOCK_AIR) {
+            if (getBlockConst(spawnX, y, spawnZ).type != BLOCK_AIR) {
                 spawnY = y + 1; // 设置为方块上方一格
                 break;
             }
@@ -1770,308 +2900,375 @@ void Renderer::renderWorld(const World& world, const Camera& camera) {
     Mat4 projection = camera.getProjectionMatrix();
     
     // 将矩阵传递给GPU渲染器
-    gpuRenderer.SetTransform(view, projection);
+    backend->SetTransform(view, projection);
+    
+    // 每帧提取一次视锥体平面，区块和方块的剔除都用它
+    updateFrustum(camera);
+    frustumStats = FrustumCullStats();
     
     // 计算渲染距离的平方(用于方块级别的距离检查)
     float maxDistanceSq = static_cast<float>(renderDistance * renderDistance);
     
     // 获取玩家位置的整数坐标
-    int playerX = static_cast<int>(camera.position.x);
-    int playerY = static_cast<int>(camera.position.y);
-    int playerZ = static_cast<int>(camera.position.z);
-    
-    // 区块大小定义（每个区块包含16x16x16个方块）
-    const int CHUNK_SIZE = 16;
+    int playerX = static_cast<int>(std::floor(camera.position.x));
+    int playerY = static_cast<int>(std::floor(camera.position.y));
+    int playerZ = static_cast<int>(std::floor(camera.position.z));
     
-    // 计算需要渲染的区域范围(区块级别的预筛选)
-    int minX = std::max(0, playerX - renderDistance);
-    int maxX = std::min(world.width - 1, playerX + renderDistance);
+    // 计算需要渲染的区域范围(区块级别的预筛选)，无限世界在水平方向不做裁剪
+    int minX = playerX - renderDistance;
+    int maxX = playerX + renderDistance;
     int minY = std::max(0, playerY - renderDistance);
     int maxY = std::min(world.height - 1, playerY + renderDistance);
-    int minZ = std::max(0, playerZ - renderDistance);
-    int maxZ = std::min(world.depth - 1, playerZ + renderDistance);
+    int minZ = playerZ - renderDistance;
+    int maxZ = playerZ + renderDistance;
+    if (!world.infiniteWorld) {
+        minX = std::max(0, minX);
+        maxX = std::min(world.width - 1, maxX);
+        minZ = std::max(0, minZ);
+        maxZ = std::min(world.depth - 1, maxZ);
+    }
     
-    // 转换为区块坐标
-    int minChunkX = minX / CHUNK_SIZE;
-    int maxChunkX = maxX / CHUNK_SIZE;
-    int minChunkY = minY / CHUNK_SIZE;
-    int maxChunkY = maxY / CHUNK_SIZE;
-    int minChunkZ = minZ / CHUNK_SIZE;
-    int maxChunkZ = maxZ / CHUNK_SIZE;
+    // 转换为区块坐标（算术右移，负坐标也向下取整）
+    int minChunkX = minX >> CHUNK_SHIFT;
+    int maxChunkX = maxX >> CHUNK_SHIFT;
+    int minChunkY = minY >> CHUNK_SHIFT;
+    int maxChunkY = maxY >> CHUNK_SHIFT;
+    int minChunkZ = minZ >> CHUNK_SHIFT;
+    int maxChunkZ = maxZ >> CHUNK_SHIFT;
     
     // 清理过期的区块缓存
     cleanupChunkCache();
     
+    // 取回后台线程上一帧之后生成好的网格
+    world.collectMeshResults(MESH_UPLOAD_BUDGET_MS);
+    
+    // 渲染距离之外的地平线远景（在区块之前绘制，之后近处的地形按深度覆盖它）
+    renderHorizon(world, camera);
+    
+    // 沿分段面连通性找出相机能看到的分段（X-ray模式需要透过石头，不做这一步）
+    traverseVisibilityGraph(world, camera, minChunkX, maxChunkX, minChunkY, maxChunkY, minChunkZ, maxChunkZ);
+    
+    // 近处的实心遮挡盒光栅化到层次Z深度图，之后每个区块提交前先测试包围盒
+    prepareOcclusion(world, camera, minChunkX, maxChunkX, minChunkY, maxChunkY, minChunkZ, maxChunkZ);
+    
     // 调试信息
     int renderedBlocks = 0;
     int renderedFaces = 0;
+    int renderedMeshes = 0;
     
-    // 首先绘制不透明方块，然后绘制半透明方块（如水、树叶）
-    for (int pass = 0; pass < 2; pass++) {
-        // 先处理区块级别的渲染
-        for (int chunkZ = minChunkZ; chunkZ <= maxChunkZ; chunkZ++) {
-            for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
-                for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
-                    // 计算区块中心
-                    float chunkCenterX = (chunkX * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
-                    float chunkCenterY = (chunkY * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
-                    float chunkCenterZ = (chunkZ * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
-                    
-                    // 计算区块中心到相机的距离
-                    Vec3 chunkCenter(chunkCenterX, chunkCenterY, chunkCenterZ);
-                    float chunkDistSq = (chunkCenter - camera.position).lengthSquared();
-                    
-                    // 计算区块对角线长度的一半，用于包围球检测
-                    float chunkRadius = CHUNK_SIZE * 0.866f; // 约等于CHUNK_SIZE * sqrt(3)/2
-                    float chunkBoundingSphereRadiusSq = chunkRadius * chunkRadius;
-                    
-                    // 检查区块是否在渲染距离内或区块是否在缓存中
-                    // 增加区块边界容错，扩大判定范围
-                    float distanceMargin = 1.2f; // 增加20%的边界容错
-                    bool inRenderDistance = chunkDistSq <= (maxDistanceSq + chunkBoundingSphereRadiusSq) * distanceMargin;
-                    bool inCache = isChunkLoaded(chunkX, chunkY, chunkZ);
-                    bool shouldRender = inRenderDistance || inCache;
-                    
-                    // 检查区块是否在视锥体内 - 使用更宽松的检测
-                    bool inViewFrustum = isBlockInFrustum(chunkCenter, camera);
-                    
-                    // 更新区块缓存
-                    if (inRenderDistance) {
-                        updateChunkCache(chunkX, chunkY, chunkZ, inViewFrustum);
-                    }
-                    
-                    // 如果区块不需要渲染，跳过
-                    if (!shouldRender) continue;
-                    
-                    // 渲染区块内的方块
-                    int startX = chunkX * CHUNK_SIZE;
-                    int startY = chunkY * CHUNK_SIZE;
-                    int startZ = chunkZ * CHUNK_SIZE;
-                    
-                    int endX = std::min(startX + CHUNK_SIZE, world.width);
-                    int endY = std::min(startY + CHUNK_SIZE, world.height);
-                    int endZ = std::min(startZ + CHUNK_SIZE, world.depth);
-                    
-                    // 仅遍历当前区块内的方块
-                    for (int z = startZ; z < endZ; z++) {
-                        for (int y = startY; y < endY; y++) {
-                            for (int x = startX; x < endX; x++) {
-                    // 获取方块信息
-                    const Block& block = world.getBlockConst(x, y, z);
+    // X-ray模式的逐帧常量：矿物的高亮颜色（脉冲效果对所有矿物相同）和距离带
+    // 距离带：3格内全部显示，3~5格石头抽稀，5格外只显示矿物
+    const float XRAY_STONE_DIST_SQ = 9.0f;
+    const float XRAY_NEAR_DIST_SQ = 25.0f;
+    const int XRAY_NEAR_RADIUS = 5; // 非矿物方块只在这个范围内显示（XRAY_NEAR_DIST_SQ的平方根）
+    const float XRAY_UNDERGROUND_DIST_SQ = 1024.0f; // 地下渲染距离约为正常渲染距离的1/3（32格）
+    enum { XRAY_BAND_PER_BLOCK = -1, XRAY_BAND_ALL = 0, XRAY_BAND_SPARSE_STONE = 1, XRAY_BAND_ORES_ONLY = 2 };
+    auto xrayDistanceBand = [&](float distSq) {
+        return distSq > XRAY_NEAR_DIST_SQ ? XRAY_BAND_ORES_ONLY : (distSq > XRAY_STONE_DIST_SQ ? XRAY_BAND_SPARSE_STONE : XRAY_BAND_ALL);
+    };
+    Color xrayOreColors[BLOCK_COUNT];
+    bool undergroundCulling = optimizeUndergroundRendering && camera.position.y < world.height - 5;
+    float xrayViewAngle = std::acos(0.7f); // 地下时方块需要在视线方向这个夹角以内
+    if (world.isXrayMode()) {
+        struct OreColor { BlockType type; Color color; };
+        const OreColor oreColors[] = {
+            { BLOCK_COAL_ORE, Color(50, 50, 50) },
+            { BLOCK_IRON_ORE, Color(150, 120, 100) },
+            { BLOCK_GOLD_ORE, Color(200, 170, 60) },
+            { BLOCK_DIAMOND_ORE, Color(80, 220, 220) },
+            { BLOCK_REDSTONE_ORE, Color(180, 50, 50) },
+            { BLOCK_EMERALD_ORE, Color(30, 180, 70) },
+            { BLOCK_LAVA, Color(200, 80, 20) }
+        };
+        // 增强颜色亮度并应用脉冲效果
+        int pulseValue = (int)(50 * sin(GetTickCount() * 0.003f) + 50);
+        for (const OreColor& ore : oreColors) {
+            Color color = ore.color;
+            color.r = std::min(255, std::min(255, color.r + 80) + pulseValue);
+            color.g = std::min(255, std::min(255, color.g + 80) + pulseValue);
+            color.b = std::min(255, std::min(255, color.b + 80) + pulseValue);
+            xrayOreColors[ore.type] = color;
+        }
+    }
+    
+    // 收集本帧要绘制的区块（距离、缓存、视锥体判断每帧只做一次），按到相机的距离排序
+    visibleChunks.clear();
+    for (int chunkZ = minChunkZ; chunkZ <= maxChunkZ; chunkZ++) {
+        for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+            for (int chunkX = minChunkX; chunkX <= maxChunkX; chunkX++) {
+                // 计算区块中心
+                float chunkCenterX = (chunkX * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
+                float chunkCenterY = (chunkY * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
+                float chunkCenterZ = (chunkZ * CHUNK_SIZE) + CHUNK_SIZE * 0.5f;
                 
-                    // 跳过空气方块
-                    if (block.type == BLOCK_AIR) continue;
-                                
-                                // 特殊处理可变方块(BLOCK_CHANGE_BLOCK)
-                                bool isCustomTransparent = false;
-                                if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
-                                    // 检查任何一个面是否半透明(alpha < 255)
-                                    for (int i = 0; i < FACE_COUNT; i++) {
-                                        if (block.customColors[i].a < 255) {
-                                            isCustomTransparent = true;
-                                            break;
-                                        }
-                                    }
-                                }
-                                
-                                // 判断是否为透明方块
-                                bool isTransparent = world.isTransparent(block.type) || isCustomTransparent;
-                    
-                    // 第一遍绘制不透明方块，第二遍绘制透明方块
-                    if ((pass == 0 && isTransparent) || (pass == 1 && !isTransparent)) {
-                        continue;
-                    }
-                    
-                                // 精确的视距检查
-                    Vec3 blockCenter(x + 0.5f, y + 0.5f, z + 0.5f);
-                    float distSq = (blockCenter - camera.position).lengthSquared();
-                    if (distSq > maxDistanceSq) continue;
+                // 计算区块中心到相机的距离
+                Vec3 chunkCenter(chunkCenterX, chunkCenterY, chunkCenterZ);
+                float chunkDistSq = (chunkCenter - camera.position).lengthSquared();
                 
-                                // 如果启用了地下优化且相机在地下，检查是否需要渲染
-                                if (optimizeUndergroundRendering && camera.position.y < world.height - 5) {
-                                    // 使用更严格的距离限制，地下渲染距离约为正常渲染距离的1/3
-                                    float undergroundMaxDistSq = 1024.0f; // 32*32 = 1024
-                                    
-                                    // 检查是否超出地下渲染距离
-                                    if (distSq > undergroundMaxDistSq) {
-                                        // 检查方块是否在玩家视线方向上
-                                        Vec3 blockDir = (blockCenter - camera.position).normalize();
-                                        float viewAlignment = blockDir.dot(camera.front);
-                                        
-                                        // 如果方块不在玩家视线方向前方，则跳过
-                                        if (viewAlignment < 0.7f || distSq > maxDistanceSq * 0.3f) {
-                                            continue;
-                                        }
-                                    }
-                                }
-                                
-                                // 视锥体剔除 - 对于远距离方块执行严格的视锥体检测
-                                if (distSq > 100.0f && !isBlockInFrustum(blockCenter, camera)) {
-                                    continue;
-                                }
-                                
-                                // X-ray模式的特殊处理
-                    if (world.isXrayMode()) {
-                                    // 检查是否是矿物
-                                    bool isOre = (block.type == BLOCK_COAL_ORE || 
-                                                block.type == BLOCK_IRON_ORE || 
-                                                block.type == BLOCK_GOLD_ORE || 
-                                                block.type == BLOCK_DIAMOND_ORE || 
-                                                block.type == BLOCK_REDSTONE_ORE || 
-                                                block.type == BLOCK_EMERALD_ORE || 
-                                                block.type == BLOCK_LAVA);
-                                    
-                                    // 计算与玩家的距离
-                                    float distToPlayer = std::sqrt(distSq);
-                                    
-                                    // 如果不是矿物且不在玩家附近，则不渲染
-                                    if (!isOre && distToPlayer > 5.0f) continue;
-                                    
-                                    // 如果是石头且不在玩家附近，则只渲染少量以提高性能
-                                    if (block.type == BLOCK_STONE && distToPlayer > 3.0f) {
-                                        // 跳过大部分石头方块，只渲染少量以提高性能
-                                        if ((x + y + z) % 10 != 0) continue;
-                                    }
-                                    
-                                    // 对于矿物，应用特殊高亮效果
-                                    if (isOre) {
-                                        // 获取基础颜色
-                                        Color baseColor;
-                        switch (block.type) {
-                            case BLOCK_COAL_ORE:
-                                                baseColor = Color(50, 50, 50);
-                                                break;
-                            case BLOCK_IRON_ORE:
-                                                baseColor = Color(150, 120, 100);
-                                                break;
-                            case BLOCK_GOLD_ORE:
-                                                baseColor = Color(200, 170, 60);
-                                                break;
-                            case BLOCK_DIAMOND_ORE:
-                                                baseColor = Color(80, 220, 220);
-                                                break;
-                            case BLOCK_REDSTONE_ORE:
-                                                baseColor = Color(180, 50, 50);
-                                                break;
-                                            case BLOCK_EMERALD_ORE:
-                                                baseColor = Color(30, 180, 70);
-                                                break;
-                                            case BLOCK_LAVA:
-                                                baseColor = Color(200, 80, 20);
-                                break;
-                            default:
-                                                baseColor = Color(200, 200, 200);
-                                break;
-                                        }
-                                        
-                                        // 增强颜色亮度
-                                        baseColor.r = std::min(255, baseColor.r + 80);
-                                        baseColor.g = std::min(255, baseColor.g + 80);
-                                        baseColor.b = std::min(255, baseColor.b + 80);
-                                        
-                                        // 应用脉冲效果
-                                        int pulseValue = (int)(50 * sin(GetTickCount() * 0.003f) + 50);
-                                        baseColor.r = std::min(255, baseColor.r + pulseValue);
-                                        baseColor.g = std::min(255, baseColor.g + pulseValue);
-                                        baseColor.b = std::min(255, baseColor.b + pulseValue);
-                    
-                    // 创建世界矩阵，设置方块位置
-                    Mat4 worldMatrix = Mat4::translate(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)));
-                    gpuRenderer.SetWorldMatrix(worldMatrix);
-                    
-                                        // 渲染所有面，使用高亮颜色
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_FRONT, baseColor);
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_BACK, baseColor);
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_LEFT, baseColor);
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_RIGHT, baseColor);
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_TOP, baseColor);
-                                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_BOTTOM, baseColor);
-                                        
-                                        renderedFaces += 6;
-                                        renderedBlocks++;
-                                        continue;
-                                    }
-                                }
-                                
-                                // 创建世界矩阵，设置方块位置
-                                Mat4 worldMatrix = Mat4::translate(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)));
-                                gpuRenderer.SetWorldMatrix(worldMatrix);
-                                
-                                // 判断每个面是否应该被渲染 - 优化的面剔除
-                    bool anyFaceRendered = false;
-                    
-                                // 检查前面 (z+1)
-                                if (z + 1 >= world.depth || world.isTransparent(world.getBlockConst(x, y, z + 1).type)) {
-                        Color faceColor = block.getFaceColor(FACE_FRONT);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_FRONT, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
-                    }
-                    
-                                // 检查后面 (z-1)
-                                if (z - 1 < 0 || world.isTransparent(world.getBlockConst(x, y, z - 1).type)) {
-                        Color faceColor = block.getFaceColor(FACE_BACK);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_BACK, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
-                    }
-                    
-                                // 检查左面 (x-1)
-                                if (x - 1 < 0 || world.isTransparent(world.getBlockConst(x - 1, y, z).type)) {
-                        Color faceColor = block.getFaceColor(FACE_LEFT);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_LEFT, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
-                    }
+                // 计算区块对角线长度的一半，用于包围球检测
+                float chunkRadius = CHUNK_SIZE * 0.866f; // 约等于CHUNK_SIZE * sqrt(3)/2
+                float chunkBoundingSphereRadiusSq = chunkRadius * chunkRadius;
                 
-                                // 检查右面 (x+1)
-                                if (x + 1 >= world.width || world.isTransparent(world.getBlockConst(x + 1, y, z).type)) {
-                        Color faceColor = block.getFaceColor(FACE_RIGHT);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_RIGHT, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
-                    }
+                // 检查区块是否在渲染距离内或区块是否在缓存中
+                // 增加区块边界容错，扩大判定范围
+                float distanceMargin = 1.2f; // 增加20%的边界容错
+                bool inRenderDistance = chunkDistSq <= (maxDistanceSq + chunkBoundingSphereRadiusSq) * distanceMargin;
+                bool inCache = isChunkLoaded(chunkX, chunkY, chunkZ);
+                bool shouldRender = inRenderDistance || inCache;
                 
-                                // 检查上面 (y+1)
-                                if (y + 1 >= world.height || world.isTransparent(world.getBlockConst(x, y + 1, z).type)) {
-                        Color faceColor = block.getFaceColor(FACE_TOP);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_TOP, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
-                    }
+                // 区块包围盒与视锥体六个平面比较（高度裁到世界顶部）
+                Vec3 chunkMin(static_cast<float>(chunkX * CHUNK_SIZE), static_cast<float>(chunkY * CHUNK_SIZE),
+                              static_cast<float>(chunkZ * CHUNK_SIZE));
+                Vec3 chunkMax(chunkMin.x + CHUNK_SIZE,
+                              static_cast<float>(std::min((chunkY + 1) * CHUNK_SIZE, world.height)),
+                              chunkMin.z + CHUNK_SIZE);
+                FrustumClass chunkVisibility = viewFrustum.classifyAABB(chunkMin, chunkMax);
+                bool inViewFrustum = chunkVisibility != FRUSTUM_OUTSIDE;
+                
+                // 更新区块缓存
+                if (inRenderDistance) {
+                    updateChunkCache(chunkX, chunkY, chunkZ, inViewFrustum);
+                }
                 
-                                // 检查下面 (y-1)
-                                if (y - 1 < 0 || world.isTransparent(world.getBlockConst(x, y - 1, z).type)) {
-                        Color faceColor = block.getFaceColor(FACE_BOTTOM);
-                        gpuRenderer.DrawBlockFace(Vec3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)), FACE_BOTTOM, faceColor);
-                        anyFaceRendered = true;
-                                    renderedFaces++;
+                // 如果区块不需要渲染，跳过
+                if (!shouldRender) continue;
+                
+                if (chunkVisibility == FRUSTUM_OUTSIDE) frustumStats.outside++;
+                else if (chunkVisibility == FRUSTUM_INTERSECT) frustumStats.intersect++;
+                else frustumStats.inside++;
+                if (!inViewFrustum) continue;
+                
+                ChunkDrawItem item;
+                item.chunkX = chunkX;
+                item.chunkY = chunkY;
+                item.chunkZ = chunkZ;
+                item.distSq = chunkDistSq;
+                item.key = quantizeDrawDistance(chunkDistSq);
+                visibleChunks.push_back(item);
+            }
+        }
+    }
+    radixSortByKey(visibleChunks, visibleChunksScratch);
+    
+    // 相机所在的区块：跨过区块边界后半透明网格才按新的视点重新排序
+    uint64_t eyeChunkKey = ChunkMeshCache::key(playerX >> CHUNK_SHIFT, playerY >> CHUNK_SHIFT, playerZ >> CHUNK_SHIFT);
+    
+    // 首先绘制不透明方块，然后绘制半透明方块（如水、树叶）
+    // 不透明的一遍由近到远（深度测试尽早拒绝被挡住的像素），半透明的一遍由远到近（混合顺序正确）
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t order = 0; order < visibleChunks.size(); order++) {
+            const ChunkDrawItem& item = visibleChunks[pass == 0 ? order : visibleChunks.size() - 1 - order];
+            int chunkX = item.chunkX;
+            int chunkY = item.chunkY;
+            int chunkZ = item.chunkZ;
+            float chunkDistSq = item.distSq;
+            Vec3 chunkCenter((chunkX * CHUNK_SIZE) + CHUNK_SIZE * 0.5f, (chunkY * CHUNK_SIZE) + CHUNK_SIZE * 0.5f,
+                             (chunkZ * CHUNK_SIZE) + CHUNK_SIZE * 0.5f);
+            float chunkRadius = CHUNK_SIZE * 0.866f;
+            Vec3 chunkMin(static_cast<float>(chunkX * CHUNK_SIZE), static_cast<float>(chunkY * CHUNK_SIZE),
+                          static_cast<float>(chunkZ * CHUNK_SIZE));
+            Vec3 chunkMax(chunkMin.x + CHUNK_SIZE,
+                          static_cast<float>(std::min((chunkY + 1) * CHUNK_SIZE, world.height)),
+                          chunkMin.z + CHUNK_SIZE);
+            
+            // 非X-ray模式直接提交分段网格：每个分段每遍一次绘制，网格只在分段内容变化后重新生成
+            if (!world.isXrayMode()) {
+                if (!isSectionReachable(chunkX, chunkY, chunkZ)) {
+                    if (pass == 0) visibilityStats.culled++;
+                    continue;
+                }
+                if (occlusionBuffer.isReady()) {
+                    if (pass == 0) occlusionStats.tested++;
+                    if (occlusionBuffer.isOccluded(chunkMin, chunkMax)) {
+                        if (pass == 0) occlusionStats.culled++;
+                        continue;
                     }
-                    
-                    // 如果渲染了任何面，计数增加
-                    if (anyFaceRendered) {
-                        renderedBlocks++;
+                }
+                // 后台生成的优先级：距离越近越先生成，视线正前方的分段优先于侧后方
+                float facing = chunkDistSq > 0.0f ?
+                    (chunkCenter - camera.position).dot(camera.front) / std::sqrt(chunkDistSq) : 1.0f;
+                // 远处的分段用降采样的网格（级别按距离选择，带回差）
+                int lod = lodEnabled ? world.selectSectionLod(chunkX, chunkY, chunkZ, std::sqrt(chunkDistSq)) : 0;
+                const ChunkMesh* mesh = world.getSectionMesh(chunkX, chunkY, chunkZ, chunkDistSq * (2.0f - facing), lod);
+                if (!mesh) continue;
+                int quads = mesh->quadCount(pass);
+                if (quads == 0) continue;
+                if (pass == MESH_PASS_TRANSPARENT) {
+                    // 半透明的面从背后也能透过正面看到，并且按距离排过序，整遍绘制
+                    world.meshCache.sortTransparentQuads(chunkX, chunkY, chunkZ, mesh->lod, camera.position.x,
+                                                         camera.position.y, camera.position.z, eyeChunkKey);
+                    backend->DrawQuadMesh(mesh->vertices[pass].data(), quads, meshQuadIndices(),
+                                          MESH_MAX_QUADS_PER_BATCH, true);
+                } else {
+                    // 不透明的面按朝向分组，只提交可能朝向相机的几组
+                    uint8_t facing = backfaceCullingEnabled ? meshFacingMask(camera.position, chunkMin, chunkMax) : FACE_MASK_ALL;
+                    world.meshCache.recordFacing(*mesh, facing);
+                    quads = 0;
+                    forEachFacingRun(*mesh, facing, [&](int firstQuad, int runQuads) {
+                        backend->DrawQuadMesh(mesh->vertices[pass].data() + static_cast<size_t>(firstQuad) * MESH_VERTICES_PER_QUAD,
+                                              runQuads, meshQuadIndices(), MESH_MAX_QUADS_PER_BATCH, false);
+                        quads += runQuads;
+                    });
+                    if (quads == 0) continue;
+                }
+                world.meshCache.recordDraw(quads, mesh->lod);
+                renderedMeshes++;
+                renderedFaces += quads;
+                continue;
+            }
+            
+            // X-ray模式逐个方块绘制：距离、地下和视锥体判断都在区块级别完成，块内只剩发出面
+            // 区块包围盒到相机的最近、最远距离决定块内的距离判断能否整块确定
+            float nearestDistSq = aabbNearestDistanceSq(camera.position, chunkMin, chunkMax);
+            float farthestDistSq = aabbFarthestDistanceSq(camera.position, chunkMin, chunkMax);
+            if (nearestDistSq > maxDistanceSq) continue;
+            
+            // 地下优化：整个区块在32格外时，超出地下可见范围或整体偏离视线方向就跳过
+            if (undergroundCulling && nearestDistSq > XRAY_UNDERGROUND_DIST_SQ) {
+                if (nearestDistSq > maxDistanceSq * 0.3f) continue;
+                float chunkDist = std::sqrt(chunkDistSq);
+                if (chunkDist > chunkRadius) {
+                    float alignment = (chunkCenter - camera.position).dot(camera.front) / chunkDist;
+                    float centerAngle = std::acos(std::max(-1.0f, std::min(1.0f, alignment)));
+                    if (centerAngle - std::asin(chunkRadius / chunkDist) > xrayViewAngle) continue;
+                }
+            }
+            
+            // 区块整体落在哪个距离带；跨过某个阈值时才逐块计算距离
+            int chunkBand = xrayDistanceBand(nearestDistSq);
+            if (farthestDistSq > maxDistanceSq || xrayDistanceBand(farthestDistSq) != chunkBand) {
+                chunkBand = XRAY_BAND_PER_BLOCK;
+            }
+            
+            // 不透明方块背向相机的面被方块自己挡住，整个区块都背向相机的方向不提交
+            uint8_t opaqueFacing = backfaceCullingEnabled ? meshFacingMask(camera.position, chunkMin, chunkMax) : FACE_MASK_ALL;
+            
+            // 矿物按分段的类型索引绘制，不再遍历分段里的每个方块；整段在5格外又没有矿物时直接跳过
+            const SectionBlockIndex* index = world.getSectionBlockIndex(chunkX, chunkY, chunkZ);
+            if (!index || (chunkBand == XRAY_BAND_ORES_ONLY && !index->hasOres())) continue;
+            
+            int originX = chunkX * CHUNK_SIZE;
+            int originY = chunkY * CHUNK_SIZE;
+            int originZ = chunkZ * CHUNK_SIZE;
+            
+            for (const OreCell& ore : index->ores) {
+                BlockType oreType = static_cast<BlockType>(ore.type);
+                // 第一遍绘制不透明方块，第二遍绘制透明方块（岩浆）
+                bool isTransparent = world.isTransparent(oreType);
+                if (isTransparent != (pass == 1)) continue;
+                int lx, ly, lz;
+                sectionCellCoords(ore.cell, lx, ly, lz);
+                int x = originX + lx;
+                int y = originY + ly;
+                int z = originZ + lz;
+                if (chunkBand == XRAY_BAND_PER_BLOCK) {
+                    float dx = x + 0.5f - camera.position.x;
+                    float dy = y + 0.5f - camera.position.y;
+                    float dz = z + 0.5f - camera.position.z;
+                    if (dx * dx + dy * dy + dz * dz > maxDistanceSq) continue;
+                }
+                
+                // 矿物用本帧的高亮颜色绘制所有面
+                Vec3 blockPos(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+                const Color& oreColor = xrayOreColors[oreType];
+                uint8_t facing = isTransparent ? FACE_MASK_ALL : opaqueFacing;
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    if (!(facing & (1 << face))) continue;
+                    backend->DrawBlockFace(blockPos, static_cast<Face>(face), oreColor);
+                    renderedFaces++;
+                }
+                renderedBlocks++;
+            }
+            
+            // 其余方块只在玩家5格内显示：只遍历这个范围与分段相交的部分
+            if (chunkBand == XRAY_BAND_ORES_ONLY) continue;
+            int startX = std::max(originX, playerX - XRAY_NEAR_RADIUS);
+            int startY = std::max(originY, playerY - XRAY_NEAR_RADIUS);
+            int startZ = std::max(originZ, playerZ - XRAY_NEAR_RADIUS);
+            
+            int endX = std::min(originX + CHUNK_SIZE, playerX + XRAY_NEAR_RADIUS + 1);
+            int endY = std::min(std::min(originY + CHUNK_SIZE, world.height), playerY + XRAY_NEAR_RADIUS + 1);
+            int endZ = std::min(originZ + CHUNK_SIZE, playerZ + XRAY_NEAR_RADIUS + 1);
+            if (!world.infiniteWorld) {
+                endX = std::min(endX, world.width);
+                endZ = std::min(endZ, world.depth);
+            }
+            
+            for (int z = startZ; z < endZ; z++) {
+                for (int y = startY; y < endY; y++) {
+                    for (int x = startX; x < endX; x++) {
+                        const Block& block = world.getBlockConst(x, y, z);
+                        if (block.type == BLOCK_AIR || isIndexedOre(block.type)) continue;
+                        
+                        // 特殊处理可变方块(BLOCK_CHANGE_BLOCK)：任何一个面半透明就算透明方块
+                        bool isCustomTransparent = false;
+                        if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
+                            for (int i = 0; i < FACE_COUNT; i++) {
+                                if (block.customColors[i].a < 255) {
+                                    isCustomTransparent = true;
+                                    break;
                                 }
                             }
                         }
+                        
+                        // 第一遍绘制不透明方块，第二遍绘制透明方块
+                        bool isTransparent = world.isTransparent(block.type) || isCustomTransparent;
+                        if (isTransparent != (pass == 1)) continue;
+                        uint8_t facing = isTransparent ? FACE_MASK_ALL : opaqueFacing;
+                        
+                        float dx = x + 0.5f - camera.position.x;
+                        float dy = y + 0.5f - camera.position.y;
+                        float dz = z + 0.5f - camera.position.z;
+                        int band = xrayDistanceBand(dx * dx + dy * dy + dz * dz);
+                        if (band == XRAY_BAND_ORES_ONLY) continue;
+                        
+                        // 稍远处的石头只渲染少量以提高性能
+                        if (block.type == BLOCK_STONE && band == XRAY_BAND_SPARSE_STONE && (x + y + z) % 10 != 0) continue;
+                        
+                        // 直接使用存储的面掩码，不再逐面查询相邻方块
+                        Vec3 blockPos(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+                        bool anyFaceRendered = false;
+                        uint8_t faces = block.faceMask & facing;
+                        for (int face = 0; face < FACE_COUNT; face++) {
+                            if (!(faces & (1 << face))) continue;
+                            backend->DrawBlockFace(blockPos, static_cast<Face>(face), block.getFaceColor(static_cast<Face>(face)));
+                            anyFaceRendered = true;
+                            renderedFaces++;
+                        }
+                        
+                        // 如果渲染了任何面，计数增加
+                        if (anyFaceRendered) {
+                            renderedBlocks++;
+                        }
                     }
                 }
             }
         }
     }
     
-    // 调试输出
-    static int frameCount = 0;
-    static int lastBlockCount = 0;
-    static int lastFaceCount = 0;
-    frameCount++;
-    if (frameCount % 60 == 0) {  // 每60帧输出一次
-        if (renderedBlocks != lastBlockCount || renderedFaces != lastFaceCount) {
-            std::cout << "Rendered blocks: " << renderedBlocks << ", faces: " << renderedFaces << std::endl;
-            lastBlockCount = renderedBlocks;
-            lastFaceCount = renderedFaces;
-                }
-        frameCount = 0;
+    // 把本帧过期的分段按优先级交给后台线程，淘汰长时间未使用的网格，发布本帧网格统计
+    world.submitMeshJobs();
+    world.meshCache.endFrame();
+    
+    // 调试输出（跟踪关闭时整段不编译）
+    if (TRACE_ENABLED(TRACE_WORLD, TRACE_LEVEL_INFO)) {
+        static int frameCount = 0;
+        static int lastBlockCount = 0;
+        static int lastFaceCount = 0;
+        frameCount++;
+        if (frameCount % 60 == 0) {  // 每60帧输出一次
+            if (renderedBlocks != lastBlockCount || renderedFaces != lastFaceCount) {
+                TRACE(TRACE_WORLD, TRACE_LEVEL_INFO,
+                      "Rendered blocks: %d, meshes: %d, faces: %d, chunks culled: %d (partial %d, inside %d), "
+                      "sections reached: %d (hidden %d), occluded: %d/%d (%d occluders)",
+                      renderedBlocks, renderedMeshes, renderedFaces, frustumStats.outside, frustumStats.intersect,
+                      frustumStats.inside, visibilityStats.reached, visibilityStats.culled, occlusionStats.culled,
+                      occlusionStats.tested, occlusionStats.occluders);
+                lastBlockCount = renderedBlocks;
+                lastFaceCount = renderedFaces;
+            }
+            frameCount = 0;
+        }
     }
     
     // 在方块渲染完成后，渲染太阳和云
@@ -2089,4 +3286,228 @@ void Renderer::renderWorld(const World& world, const Camera& camera) {
     }
 }
 
+// 实现Renderer::traverseVisibilityGraph方法（需要在World类定义后）
+// 广度优先搜索：从相机所在分段出发，经过的分段要能从进入面连到离开面；
+// 不往已经走过的方向的反方向走（视线不会拐回相机这一侧），视锥体外的分段不进入。
+// 还没有网格（连通性未知）的分段按完全连通处理。
+void Renderer::traverseVisibilityGraph(const World& world, const Camera& camera,
+                                       int minChunkX, int maxChunkX, int minChunkY, int maxChunkY, int minChunkZ, int maxChunkZ) {
+    visibilityStats = VisibilityGraphStats();
+    reachAll = true;
+    if (!caveCullingEnabled || world.isXrayMode()) return;
+    
+    int cameraX = static_cast<int>(std::floor(camera.position.x)) >> CHUNK_SHIFT;
+    int cameraY = static_cast<int>(std::floor(camera.position.y)) >> CHUNK_SHIFT;
+    int cameraZ = static_cast<int>(std::floor(camera.position.z)) >> CHUNK_SHIFT;
+    // 相机在世界上方时把搜索范围向上扩展到相机（世界外的分段没有内容，按空气处理）
+    maxChunkY = std::max(maxChunkY, cameraY);
+    if (cameraX < minChunkX || cameraX > maxChunkX || cameraZ < minChunkZ || cameraZ > maxChunkZ ||
+        cameraY < minChunkY || minChunkY > maxChunkY) {
+        return;
+    }
+    
+    reachAll = false;
+    reachMinX = minChunkX;
+    reachMinY = minChunkY;
+    reachMinZ = minChunkZ;
+    reachSizeX = maxChunkX - minChunkX + 1;
+    reachSizeY = maxChunkY - minChunkY + 1;
+    reachSizeZ = maxChunkZ - minChunkZ + 1;
+    sectionReachable.assign(static_cast<size_t>(reachSizeX) * reachSizeY * reachSizeZ, 0);
+    
+    struct Node {
+        int x, y, z;
+        int entryFace;      // 从哪个面进入（起点为-1）
+        uint8_t directions; // 一路走过的方向
+    };
+    int sectionCount = (world.getHeight() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<Node> queue;
+    queue.push_back({ cameraX, cameraY, cameraZ, -1, 0 });
+    sectionReachable[(static_cast<size_t>(cameraZ - reachMinZ) * reachSizeY + (cameraY - reachMinY)) * reachSizeX + (cameraX - reachMinX)] = 1;
+    
+    for (size_t head = 0; head < queue.size(); head++) {
+        Node node = queue[head];
+        visibilityStats.reached++;
+        
+        SectionVisibility visibility = SectionVisibility::open();
+        if (node.y >= 0 && node.y < sectionCount) {
+            Vec3 center((node.x + 0.5f) * CHUNK_SIZE, (node.y + 0.5f) * CHUNK_SIZE, (node.z + 0.5f) * CHUNK_SIZE);
+            float distSq = (center - camera.position).lengthSquared();
+            float facing = distSq > 0.0f ? (center - camera.position).dot(camera.front) / std::sqrt(distSq) : 1.0f;
+            int lod = lodEnabled ? world.selectSectionLod(node.x, node.y, node.z, std::sqrt(distSq)) : 0;
+            const ChunkMesh* mesh = world.getSectionMesh(node.x, node.y, node.z, distSq * (2.0f - facing), lod);
+            if (mesh) visibility = mesh->visibility;
+        }
+        
+        for (int face = 0; face < FACE_COUNT; face++) {
+            if (node.directions & (1 << oppositeFace(face))) continue;
+            if (node.entryFace >= 0 && !visibility.connects(node.entryFace, face)) continue;
+            
+            int nx = node.x + FACE_DIRECTIONS[face][0];
+            int ny = node.y + FACE_DIRECTIONS[face][1];
+            int nz = node.z + FACE_DIRECTIONS[face][2];
+            if (nx < minChunkX || nx > maxChunkX || ny < minChunkY || ny > maxChunkY || nz < minChunkZ || nz > maxChunkZ) continue;
+            uint8_t& reached = sectionReachable[(static_cast<size_t>(nz - reachMinZ) * reachSizeY + (ny - reachMinY)) * reachSizeX + (nx - reachMinX)];
+            if (reached) continue;
+            
+            Vec3 boxMin(static_cast<float>(nx * CHUNK_SIZE), static_cast<float>(ny * CHUNK_SIZE), static_cast<float>(nz * CHUNK_SIZE));
+            Vec3 boxMax(boxMin.x + CHUNK_SIZE, boxMin.y + CHUNK_SIZE, boxMin.z + CHUNK_SIZE);
+            if (!viewFrustum.intersectsAABB(boxMin, boxMax)) continue;
+            
+            reached = 1;
+            queue.push_back({ nx, ny, nz, oppositeFace(face), static_cast<uint8_t>(node.directions | (1 << face)) });
+        }
+    }
+}
+
+// 实现Renderer::prepareOcclusion方法（需要在World类定义后）
+// 遮挡盒来自已生成且没有过期的网格（过期的网格可能包含已经挖掉的方块），
+// 按到相机的距离由近到远取前OCCLUSION_MAX_OCCLUDERS个，近处的大遮挡盒挡住的范围最多。
+void Renderer::prepareOcclusion(const World& world, const Camera& camera,
+                                int minChunkX, int maxChunkX, int minChunkY, int maxChunkY, int minChunkZ, int maxChunkZ) {
+    occlusionStats = OcclusionStats();
+    if (!occlusionCullingEnabled || world.isXrayMode()) {
+        occlusionBuffer.disable();
+        return;
+    }
+    
+    struct Candidate {
+        float distSq;
+        Vec3 boxMin;
+        Vec3 boxMax;
+    };
+    std::vector<Candidate> candidates;
+    const float maxDistSq = OCCLUSION_OCCLUDER_DISTANCE * OCCLUSION_OCCLUDER_DISTANCE;
+    int reach = static_cast<int>(OCCLUSION_OCCLUDER_DISTANCE) >> CHUNK_SHIFT;
+    int cameraX = static_cast<int>(std::floor(camera.position.x)) >> CHUNK_SHIFT;
+    int cameraZ = static_cast<int>(std::floor(camera.position.z)) >> CHUNK_SHIFT;
+    for (int chunkZ = std::max(minChunkZ, cameraZ - reach); chunkZ <= std::min(maxChunkZ, cameraZ + reach); chunkZ++) {
+        for (int chunkY = minChunkY; chunkY <= maxChunkY; chunkY++) {
+            for (int chunkX = std::max(minChunkX, cameraX - reach); chunkX <= std::min(maxChunkX, cameraX + reach); chunkX++) {
+                const ChunkMesh* mesh = world.findCurrentSectionMesh(chunkX, chunkY, chunkZ);
+                if (!mesh || mesh->occluder.isEmpty()) continue;
+                const SectionOccluder& occluder = mesh->occluder;
+                Vec3 boxMin(static_cast<float>(chunkX * CHUNK_SIZE + occluder.min[0]),
+                            static_cast<float>(chunkY * CHUNK_SIZE + occluder.min[1]),
+                            static_cast<float>(chunkZ * CHUNK_SIZE + occluder.min[2]));
+                Vec3 boxMax(static_cast<float>(chunkX * CHUNK_SIZE + occluder.max[0]),
+                            static_cast<float>(chunkY * CHUNK_SIZE + occluder.max[1]),
+                            static_cast<float>(chunkZ * CHUNK_SIZE + occluder.max[2]));
+                float distSq = aabbNearestDistanceSq(camera.position, boxMin, boxMax);
+                if (distSq > maxDistSq || !viewFrustum.intersectsAABB(boxMin, boxMax)) continue;
+                candidates.push_back({ distSq, boxMin, boxMax });
+            }
+        }
+    }
+    
+    size_t count = std::min(candidates.size(), static_cast<size_t>(OCCLUSION_MAX_OCCLUDERS));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const Candidate& a, const Candidate& b) { return a.distSq < b.distSq; });
+    
+    occlusionBuffer.begin(camera.getViewProjectionMatrix(), camera.nearPlane);
+    for (size_t i = 0; i < count; i++) {
+        if (occlusionBuffer.addOccluder(candidates[i].boxMin, candidates[i].boxMax)) {
+            occlusionStats.occluders++;
+        }
+    }
+    if (occlusionStats.occluders == 0) {
+        occlusionBuffer.disable();
+        return;
+    }
+    occlusionBuffer.buildPyramid();
+}
+
+// 实现Renderer::renderHorizon方法（需要在World类定义后）
+// 环带从渲染距离向外延伸HORIZON_RING_WIDTH格（不超过远平面），X-ray模式下不绘制
+void Renderer::renderHorizon(const World& world, const Camera& camera) {
+    if (!horizonEnabled || world.isXrayMode()) {
+        return;
+    }
+    float innerRadius = static_cast<float>(renderDistance);
+    float outerRadius = std::min(innerRadius + HORIZON_RING_WIDTH, camera.farPlane - HORIZON_CELL_SIZE);
+    if (outerRadius <= innerRadius) {
+        return;
+    }
+    
+    auto sample = [&world](int x, int z, HorizonSample& out) {
+        int top = 0;
+        BlockType type = BLOCK_AIR;
+        out.valid = world.sampleSurface(x, z, top, type);
+        if (out.valid) {
+            out.top = static_cast<float>(top);
+            out.color = meshFaceColor(type, FACE_TOP);
+        }
+    };
+    auto signature = [&world](int minX, int minZ, int size) {
+        return world.surfaceSignature(minX, minZ, size);
+    };
+    horizon.update(camera.position.x, camera.position.z, innerRadius, outerRadius, sample, signature);
+    horizon.draw(camera.position, innerRadius, viewFrustum, [&](const VertexPositionColor* vertices, int quads) {
+        backend->DrawQuadMesh(vertices, quads, meshQuadIndices(), MESH_MAX_QUADS_PER_BATCH, false);
+    });
+}
+
+// 实现Renderer::renderClouds方法（使用分段网格共用的四边形索引）
+void Renderer::renderClouds(const Camera& camera) {
+    if (!cloudsEnabled) return;
+    cloudLayer.draw(camera.position, viewFrustum, [&](const VertexPositionColor* vertices, int quads) {
+        backend->DrawCloudMesh(vertices, quads, meshQuadIndices(), MESH_MAX_QUADS_PER_BATCH);
+    });
+}
+
+// 实现Renderer::benchmarkFrustum方法（需要在World类定义后）
+Renderer::FrustumBenchmarkResult Renderer::benchmarkFrustum(const World& world, const Camera& camera, int radiusChunks) const {
+    const int REPEATS = 100;
+    FrustumBenchmarkResult result;
+    int centerX = static_cast<int>(std::floor(camera.position.x)) >> CHUNK_SHIFT;
+    int centerZ = static_cast<int>(std::floor(camera.position.z)) >> CHUNK_SHIFT;
+    int sectionCount = (world.getHeight() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    float chunkRadius = CHUNK_SIZE * 0.866f;
+    
+    std::vector<Vec3> boxMins;
+    for (int cz = centerZ - radiusChunks; cz <= centerZ + radiusChunks; cz++) {
+        for (int cy = 0; cy < sectionCount; cy++) {
+            for (int cx = centerX - radiusChunks; cx <= centerX + radiusChunks; cx++) {
+                boxMins.push_back(Vec3(static_cast<float>(cx * CHUNK_SIZE), static_cast<float>(cy * CHUNK_SIZE),
+                                       static_cast<float>(cz * CHUNK_SIZE)));
+            }
+        }
+    }
+    result.chunks = static_cast<int>(boxMins.size());
+    Vec3 extent(static_cast<float>(CHUNK_SIZE), static_cast<float>(CHUNK_SIZE), static_cast<float>(CHUNK_SIZE));
+    Vec3 halfExtent = extent * 0.5f;
+    
+    std::vector<char> coneVisible(boxMins.size(), 0);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        for (size_t i = 0; i < boxMins.size(); i++) {
+            coneVisible[i] = isSphereInViewCone(boxMins[i] + halfExtent, chunkRadius, camera) ? 1 : 0;
+        }
+    }
+    auto middle = std::chrono::high_resolution_clock::now();
+    
+    std::vector<char> planeClass(boxMins.size(), 0);
+    for (int repeat = 0; repeat < REPEATS; repeat++) {
+        Frustum frustum;
+        frustum.extract(camera.getViewProjectionMatrix());
+        for (size_t i = 0; i < boxMins.size(); i++) {
+            planeClass[i] = static_cast<char>(frustum.classifyAABB(boxMins[i], boxMins[i] + extent));
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    result.coneMs = std::chrono::duration<double, std::milli>(middle - start).count();
+    result.planeMs = std::chrono::duration<double, std::milli>(end - middle).count();
+    
+    for (size_t i = 0; i < boxMins.size(); i++) {
+        if (coneVisible[i]) result.coneVisible++;
+        switch (planeClass[i]) {
+            case FRUSTUM_OUTSIDE: result.planeOutside++; break;
+            case FRUSTUM_INTERSECT: result.planeIntersect++; break;
+            default: result.planeInside++; break;
+        }
+        if (planeClass[i] != FRUSTUM_OUTSIDE && !coneVisible[i]) result.planeOnly++;
+    }
+    return result;
+}
+
 #endif // WORLD_H
\ No newline at end of file
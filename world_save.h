@@ -0,0 +1,219 @@
+#ifndef WORLD_SAVE_H
+#define WORLD_SAVE_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include "chunk.h"
+#include "chunk_residency.h"
+
+// 存档文件格式：
+//   头部   "MCWS" + 版本号 + 世界尺寸/种子/超平坦设置/无限世界标记/出生点 + 每列分段数 + 区块列数
+//   区块列 区块X/Z坐标，随后从下到上写出每个分段：4096字节方块类型，
+//          再是自定义颜色方块的数量及（局部索引, 6个面的RGBA）列表
+const uint32_t WORLD_SAVE_MAGIC = 0x5357434D; // "MCWS"
+const uint32_t WORLD_SAVE_VERSION = 2;
+
+// 将世界快照写入文件（在后台线程中调用）
+inline bool writeWorldSnapshot(const WorldSnapshot& snapshot, const std::string& path) {
+    // 先写入临时文件，完成后再替换，避免保存中途退出导致存档损坏
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    auto writeU32 = [&out](uint32_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto writeF32 = [&out](float value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    writeU32(WORLD_SAVE_MAGIC);
+    writeU32(WORLD_SAVE_VERSION);
+    writeU32(static_cast<uint32_t>(snapshot.width));
+    writeU32(static_cast<uint32_t>(snapshot.height));
+    writeU32(static_cast<uint32_t>(snapshot.depth));
+    writeU32(snapshot.seed);
+    writeU32(snapshot.superFlat ? 1u : 0u);
+    writeU32(static_cast<uint32_t>(snapshot.superFlatBlockType));
+    writeU32(snapshot.infinite ? 1u : 0u);
+    writeF32(snapshot.spawnPoint.x);
+    writeF32(snapshot.spawnPoint.y);
+    writeF32(snapshot.spawnPoint.z);
+    writeU32(static_cast<uint32_t>(snapshot.chunksY));
+    writeU32(static_cast<uint32_t>(snapshot.columns.size()));
+
+    uint8_t types[CHUNK_VOLUME];
+    std::vector<uint16_t> customIndices;
+
+    for (const ColumnSnapshot& column : snapshot.columns) {
+        writeU32(static_cast<uint32_t>(column.chunkX));
+        writeU32(static_cast<uint32_t>(column.chunkZ));
+
+        for (size_t sectionIndex = 0; sectionIndex < column.sections.size(); sectionIndex++) {
+            // 冷分段在后台线程中解压，不占用主线程时间
+            ConstChunkSectionPtr section = column.sections[sectionIndex];
+            if (!section) {
+                section = decompressSection(*column.coldSections[sectionIndex]);
+                if (!section) {
+                    out.close();
+                    std::remove(tempPath.c_str());
+                    return false;
+                }
+            }
+
+            customIndices.clear();
+            for (int i = 0; i < CHUNK_VOLUME; i++) {
+                const Block& block = section->blocks[i];
+                types[i] = static_cast<uint8_t>(block.type);
+                if (block.type == BLOCK_CHANGE_BLOCK && block.hasCustomColors) {
+                    customIndices.push_back(static_cast<uint16_t>(i));
+                }
+            }
+            out.write(reinterpret_cast<const char*>(types), sizeof(types));
+
+            // 自定义方块的颜色
+            writeU32(static_cast<uint32_t>(customIndices.size()));
+            for (uint16_t index : customIndices) {
+                out.write(reinterpret_cast<const char*>(&index), sizeof(index));
+                const Block& block = section->blocks[index];
+                for (int face = 0; face < FACE_COUNT; face++) {
+                    const Color& c = block.customColors[face];
+                    uint8_t rgba[4] = { c.r, c.g, c.b, c.a };
+                    out.write(reinterpret_cast<const char*>(rgba), sizeof(rgba));
+                }
+            }
+        }
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // Windows下rename不会覆盖已有文件，先删除旧存档
+    std::remove(path.c_str());
+    return std::rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// 后台自动保存器
+// 主线程只负责提交快照，序列化和磁盘写入都在后台线程中完成
+class WorldAutosaver {
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    WorldSnapshot pendingSnapshot;   // 等待保存的快照
+    WorldSnapshot finishedSnapshot;  // 已写完、等主线程释放的快照
+    bool hasPending = false;         // 是否有待保存的快照
+    bool stopRequested = false;      // 是否请求停止
+    std::atomic<bool> saving{false}; // 后台线程是否正在保存
+
+    std::string savePath;
+
+    // 统计信息
+    std::atomic<int> savesCompleted{0};
+    std::atomic<int> lastSaveMillis{0};
+
+    // 后台线程主循环
+    void run() {
+        while (true) {
+            WorldSnapshot snapshot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return hasPending || stopRequested; });
+                if (!hasPending && stopRequested) {
+                    return;
+                }
+                snapshot = std::move(pendingSnapshot);
+                pendingSnapshot = WorldSnapshot();
+                hasPending = false;
+                saving = true;
+            }
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            bool ok = writeWorldSnapshot(snapshot, savePath);
+            auto endTime = std::chrono::high_resolution_clock::now();
+
+            // 分段引用不能在后台线程释放：主线程按use_count()决定写入前是否复制分段，
+            // 这里释放引用与之前读取分段之间没有同步。交还给主线程，由releaseFinished()释放
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finishedSnapshot = std::move(snapshot);
+            }
+
+            int millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count());
+            lastSaveMillis = millis;
+            if (ok) {
+                savesCompleted++;
+                std::cout << "Autosave complete: " << savePath << " (" << millis << " ms)" << std::endl;
+            } else {
+                std::cout << "Autosave failed: " << savePath << std::endl;
+            }
+
+            saving = false;
+        }
+    }
+
+public:
+    explicit WorldAutosaver(const std::string& path = "autosave.mcw") : savePath(path) {
+        worker = std::thread(&WorldAutosaver::run, this);
+    }
+
+    ~WorldAutosaver() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        condition.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    WorldAutosaver(const WorldAutosaver&) = delete;
+    WorldAutosaver& operator=(const WorldAutosaver&) = delete;
+
+    // 释放后台线程写完的快照持有的分段引用（主线程每帧调用），之后写入这些分段时无需再复制
+    void releaseFinished() {
+        WorldSnapshot finished;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = std::move(finishedSnapshot);
+            finishedSnapshot = WorldSnapshot();
+        }
+    }
+
+    // 提交快照进行保存；如果上一次保存尚未完成，新的快照会替换等待中的快照
+    void requestSave(WorldSnapshot snapshot) {
+        releaseFinished();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingSnapshot = std::move(snapshot);
+            hasPending = true;
+        }
+        condition.notify_one();
+    }
+
+    // 是否有保存任务在进行或等待
+    bool isBusy() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hasPending || saving;
+    }
+
+    int getSavesCompleted() const { return savesCompleted; }
+    int getLastSaveMillis() const { return lastSaveMillis; }
+};
+
+#endif // WORLD_SAVE_H
@@ -0,0 +1,391 @@
+#ifndef WORLD_STREAM_H
+#define WORLD_STREAM_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <cstdint>
+#include "chunk.h"
+#include "face_mask.h"
+
+// 无限世界的区块流式加载
+//
+// ColumnGenerator 只依赖种子和世界高度，按区块列独立、确定地生成地形，因此可以在后台线程中运行
+// ChunkStreamer   管理后台生成线程：主线程提交按距离排序的请求，之后每帧取回已完成的区块列
+
+// 流式加载参数
+const int STREAM_UNLOAD_MARGIN_CHUNKS = 2;        // 超出加载半径多少个区块后卸载
+const int STREAM_MAX_INTEGRATIONS_PER_FRAME = 4;  // 每帧最多并入世界的区块列数
+const int STREAM_SPAWN_RADIUS_CHUNKS = 2;         // 创建世界时同步生成的出生点周围区块半径
+
+// 区块列地形生成器
+class ColumnGenerator {
+private:
+    unsigned int seed;
+    int height;
+    bool superFlat;
+    BlockType superFlatBlockType;
+
+    // 整数哈希（替代每次构造mt19937，速度快且结果只依赖输入）
+    static uint32_t hash3(uint32_t a, uint32_t b, uint32_t c) {
+        uint32_t h = a * 0x27d4eb2dU ^ (b + 0x9e3779b9U + (a << 6) + (a >> 2));
+        h ^= c * 0x165667b1U;
+        h ^= h >> 15;
+        h *= 0x2c1b3c6dU;
+        h ^= h >> 12;
+        h *= 0x297a2d39U;
+        h ^= h >> 15;
+        return h;
+    }
+
+    // 格点上的随机值，范围[-1, 1]
+    float latticeValue(int x, int z) const {
+        return (hash3(static_cast<uint32_t>(x), static_cast<uint32_t>(z), seed) & 0xFFFFFF) / 8388607.5f - 1.0f;
+    }
+
+    // 平滑值噪声（与World::perlinNoise相同的插值方式，但按种子取值且支持负坐标）
+    float valueNoise(float x, float z) const {
+        x = x * 0.01f;
+        z = z * 0.01f;
+
+        int xi = static_cast<int>(std::floor(x));
+        int zi = static_cast<int>(std::floor(z));
+        float xf = x - xi;
+        float zf = z - zi;
+
+        auto fade = [](float t) -> float {
+            return t * t * t * (t * (t * 6 - 15) + 10);
+        };
+        float u = fade(xf);
+        float v = fade(zf);
+
+        float v00 = latticeValue(xi, zi);
+        float v10 = latticeValue(xi + 1, zi);
+        float v01 = latticeValue(xi, zi + 1);
+        float v11 = latticeValue(xi + 1, zi + 1);
+
+        float x1 = v00 + u * (v10 - v00);
+        float x2 = v01 + u * (v11 - v01);
+        return x1 + v * (x2 - x1);
+    }
+
+public:
+    ColumnGenerator(unsigned int seed, int height, bool superFlat, BlockType superFlatBlockType)
+        : seed(seed), height(height), superFlat(superFlat), superFlatBlockType(superFlatBlockType) {}
+
+    int getHeight() const { return height; }
+    int getSectionCount() const { return (height + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+    int getWaterLevel() const { return height / 3; }
+    int getSnowLevel() const { return height - height / 4; }
+
+    // 地表高度（与有限世界的高度图参数保持一致）
+    int terrainHeightAt(int x, int z) const {
+        float baseHeight = height * 0.5f;
+        float amplitude1 = height * 0.25f;
+        float amplitude2 = height * 0.15f;
+        float amplitude3 = height * 0.05f;
+
+        float noise1 = valueNoise(x * 1.0f, z * 1.0f);
+        float noise2 = valueNoise(x * 2.0f, z * 2.0f) * 0.5f;
+        float noise3 = valueNoise(x * 4.0f, z * 4.0f) * 0.25f;
+        float combinedNoise = noise1 + (noise2 * amplitude2 / amplitude1) + (noise3 * amplitude3 / amplitude1);
+
+        int h = static_cast<int>(baseHeight + combinedNoise * amplitude1);
+        return std::max(height / 4, std::min(h, height - 4));
+    }
+
+    // 未生成的区块列的地表：top为最上面方块顶面的高度，type为该方块（与generate的规则相同，不含树木）
+    void surfaceAt(int x, int z, int& top, BlockType& type) const {
+        if (superFlat) {
+            top = 1;
+            type = superFlatBlockType;
+            return;
+        }
+        int terrainHeight = terrainHeightAt(x, z);
+        int waterLevel = getWaterLevel();
+        if (terrainHeight <= waterLevel) {
+            top = waterLevel + 1;
+            type = BLOCK_WATER;
+        } else if (terrainHeight >= getSnowLevel()) {
+            top = terrainHeight;
+            type = BLOCK_SNOW;
+        } else {
+            top = terrainHeight;
+            type = terrainHeight <= waterLevel + 1 ? BLOCK_SAND : BLOCK_GRASS;
+        }
+    }
+
+    // 生成一个区块列（线程安全）
+    void generate(int chunkX, int chunkZ, ChunkColumn& column) const {
+        column.allocate(chunkX, chunkZ, getSectionCount());
+        int baseX = chunkX * CHUNK_SIZE;
+        int baseZ = chunkZ * CHUNK_SIZE;
+
+        if (superFlat) {
+            for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+                for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                    column.localBlock(lx, 0, lz) = Block(superFlatBlockType);
+                }
+            }
+            updateVisibility(column);
+            return;
+        }
+
+        int waterLevel = getWaterLevel();
+        int snowLevel = getSnowLevel();
+        int heights[CHUNK_SIZE][CHUNK_SIZE];
+
+        // 地形：基岩、石头、土壤、地表、水体
+        for (int lz = 0; lz < CHUNK_SIZE; lz++) {
+            for (int lx = 0; lx < CHUNK_SIZE; lx++) {
+                int terrainHeight = terrainHeightAt(baseX + lx, baseZ + lz);
+                heights[lz][lx] = terrainHeight;
+
+                column.localBlock(lx, 0, lz) = Block(BLOCK_BEDROCK);
+                for (int y = 1; y < terrainHeight - 3; y++) {
+                    column.localBlock(lx, y, lz) = Block(BLOCK_STONE);
+                }
+
+                BlockType soilType = BLOCK_DIRT;
+                BlockType surfaceType = BLOCK_GRASS;
+                if (terrainHeight >= snowLevel) {
+                    soilType = BLOCK_SNOW;
+                    surfaceType = BLOCK_SNOW;
+                } else if (terrainHeight <= waterLevel + 1) {
+                    soilType = BLOCK_SAND;
+                    surfaceType = BLOCK_SAND;
+                }
+                for (int y = std::max(1, terrainHeight - 3); y < terrainHeight - 1; y++) {
+                    column.localBlock(lx, y, lz) = Block(soilType);
+                }
+                column.localBlock(lx, terrainHeight - 1, lz) = Block(surfaceType);
+
+                for (int y = terrainHeight; y <= waterLevel; y++) {
+                    column.localBlock(lx, y, lz) = Block(BLOCK_WATER);
+                }
+            }
+        }
+
+        // 每个区块列使用独立的随机数序列，保证同一位置每次生成结果相同
+        std::mt19937 columnRng(hash3(static_cast<uint32_t>(chunkX), static_cast<uint32_t>(chunkZ), seed + 54321));
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+
+        generateOres(column, columnRng);
+
+        // 树木（只在列内部生成，避免写入相邻区块列）
+        for (int lz = 1; lz < CHUNK_SIZE - 1; lz++) {
+            for (int lx = 1; lx < CHUNK_SIZE - 1; lx++) {
+                int terrainHeight = heights[lz][lx];
+                if (column.localBlock(lx, terrainHeight - 1, lz).type != BLOCK_GRASS) continue;
+                if (dist(columnRng) < 0.01f && terrainHeight < height - 10) {
+                    generateTree(column, lx, terrainHeight, lz);
+                }
+            }
+        }
+
+        updateVisibility(column);
+    }
+
+private:
+    // 在区块列内生成矿脉
+    void generateOres(ChunkColumn& column, std::mt19937& columnRng) const {
+        struct OreDefinition {
+            BlockType oreType;
+            int minHeight;
+            int maxHeight;
+            float veinsPerColumn; // 每个区块列的平均矿脉数
+            int minSize;
+            int maxSize;
+        };
+
+        // 参数与有限世界的矿物分布一致（按16x16列面积折算矿脉数量）
+        const OreDefinition ores[] = {
+            {BLOCK_COAL_ORE,     5, height - 15, 0.84f, 5, 16},
+            {BLOCK_IRON_ORE,     2, height / 2,  0.59f, 3, 10},
+            {BLOCK_GOLD_ORE,     2, height / 3,  0.27f, 2, 8},
+            {BLOCK_REDSTONE_ORE, 2, height / 4,  0.44f, 3, 9},
+            {BLOCK_DIAMOND_ORE,  2, height / 6,  0.14f, 2, 6},
+            {BLOCK_EMERALD_ORE,  2, height / 3,  0.11f, 1, 3},
+            {BLOCK_LAVA,         2, height / 8,  0.09f, 3, 7}
+        };
+
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        for (const auto& ore : ores) {
+            if (ore.maxHeight <= ore.minHeight) continue;
+
+            int veinCount = static_cast<int>(ore.veinsPerColumn);
+            if (dist(columnRng) < ore.veinsPerColumn - veinCount) {
+                veinCount++;
+            }
+
+            for (int vein = 0; vein < veinCount; vein++) {
+                int x = std::uniform_int_distribution<int>(0, CHUNK_SIZE - 1)(columnRng);
+                int y = std::uniform_int_distribution<int>(ore.minHeight, ore.maxHeight - 1)(columnRng);
+                int z = std::uniform_int_distribution<int>(0, CHUNK_SIZE - 1)(columnRng);
+                int size = std::uniform_int_distribution<int>(ore.minSize, ore.maxSize)(columnRng);
+
+                // 随机游走生成矿脉，越出列边界的步骤直接跳过
+                for (int i = 0; i < size; i++) {
+                    if (x >= 0 && x < CHUNK_SIZE && z >= 0 && z < CHUNK_SIZE && y > 0 && y < height &&
+                        column.localBlock(x, y, z).type == BLOCK_STONE) {
+                        column.localBlock(x, y, z) = Block(ore.oreType);
+                    }
+                    switch (std::uniform_int_distribution<int>(0, 5)(columnRng)) {
+                        case 0: x++; break;
+                        case 1: x--; break;
+                        case 2: y++; break;
+                        case 3: y--; break;
+                        case 4: z++; break;
+                        default: z--; break;
+                    }
+                }
+            }
+        }
+    }
+
+    // 生成树（与World::generateTree形状一致）
+    void generateTree(ChunkColumn& column, int lx, int y, int lz) const {
+        for (int treeY = y; treeY < y + 4; treeY++) {
+            column.localBlock(lx, treeY, lz) = Block(BLOCK_WOOD);
+        }
+        for (int leafY = y + 2; leafY < y + 5; leafY++) {
+            for (int leafX = lx - 1; leafX <= lx + 1; leafX++) {
+                for (int leafZ = lz - 1; leafZ <= lz + 1; leafZ++) {
+                    Block& block = column.localBlock(leafX, leafY, leafZ);
+                    if (block.type == BLOCK_AIR) {
+                        block = Block(BLOCK_LEAVES);
+                    }
+                }
+            }
+        }
+    }
+
+    // 用位集计算列内方块的面掩码：列边界外的相邻方块按透明处理（保守地标记为暴露），
+    // 并入世界后再由World修正接缝
+    void updateVisibility(ChunkColumn& column) const {
+        int sectionCount = static_cast<int>(column.sections.size());
+        std::vector<SectionBits> transparentBits(sectionCount);
+        std::vector<SectionBits> solidBits(sectionCount);
+        for (int sectionY = 0; sectionY < sectionCount; sectionY++) {
+            buildSectionBits(*column.sections[sectionY], transparentBits[sectionY], solidBits[sectionY]);
+        }
+
+        SectionBits openBits;
+        openBits.fill(true);
+        uint8_t masks[CHUNK_VOLUME];
+        for (int sectionY = 0; sectionY < sectionCount; sectionY++) {
+            const SectionBits* neighbours[FACE_COUNT] = {
+                &openBits, &openBits, &openBits, &openBits,
+                sectionY + 1 < sectionCount ? &transparentBits[sectionY + 1] : &openBits,
+                sectionY > 0 ? &transparentBits[sectionY - 1] : &openBits
+            };
+            computeSectionFaceMasks(transparentBits[sectionY], solidBits[sectionY], neighbours, masks);
+            applySectionFaceMasks(*column.sections[sectionY], masks);
+        }
+    }
+};
+
+// 后台区块生成器
+class ChunkStreamer {
+private:
+    ColumnGenerator generator;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::deque<std::pair<int, int>> requests;   // 等待生成的区块列（近的在前）
+    std::vector<ChunkColumn> results;           // 已生成、等待主线程取回的区块列
+    std::unordered_set<uint64_t> inFlight;      // 排队、生成中或等待取回的区块列
+    bool stopRequested = false;
+
+    void run() {
+        while (true) {
+            std::pair<int, int> request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !requests.empty() || stopRequested; });
+                if (stopRequested) {
+                    return;
+                }
+                request = requests.front();
+                requests.pop_front();
+            }
+
+            ChunkColumn column;
+            generator.generate(request.first, request.second, column);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                results.push_back(std::move(column));
+            }
+        }
+    }
+
+public:
+    ChunkStreamer(const ColumnGenerator& generator, int workerCount) : generator(generator) {
+        for (int i = 0; i < workerCount; i++) {
+            workers.push_back(std::thread(&ChunkStreamer::run, this));
+        }
+    }
+
+    ~ChunkStreamer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    const ColumnGenerator& getGenerator() const { return generator; }
+
+    // 用新的请求列表替换尚未开始的请求（列表应按距离由近到远排序）
+    // 已在生成中或等待取回的区块列不会重复提交
+    void setRequests(const std::vector<std::pair<int, int>>& ordered) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& request : requests) {
+                inFlight.erase(chunkColumnKey(request.first, request.second));
+            }
+            requests.clear();
+            for (const auto& request : ordered) {
+                if (inFlight.insert(chunkColumnKey(request.first, request.second)).second) {
+                    requests.push_back(request);
+                }
+            }
+        }
+        condition.notify_all();
+    }
+
+    // 取回最多maxCount个已生成的区块列
+    void collect(std::vector<ChunkColumn>& out, size_t maxCount) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = std::min(maxCount, results.size());
+        for (size_t i = 0; i < count; i++) {
+            inFlight.erase(chunkColumnKey(results[i].chunkX, results[i].chunkZ));
+            out.push_back(std::move(results[i]));
+        }
+        results.erase(results.begin(), results.begin() + count);
+    }
+
+    // 尚未并入世界的区块列数（排队 + 生成中 + 等待取回）
+    int getPendingCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return static_cast<int>(inFlight.size());
+    }
+};
+
+#endif // WORLD_STREAM_H